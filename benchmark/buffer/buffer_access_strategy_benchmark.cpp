@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy_benchmark.cpp
+//
+// Identification: benchmark/buffer/buffer_access_strategy_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "workload/zipfian_generator.h"
+
+namespace bustub {
+
+/**
+ * Measures the hit rate of an OLTP point-lookup workload while an analytic scan runs over a table ten times the size
+ * of the buffer pool, once with the scan going through the shared pool and once with the scan going through a
+ * BufferAccessStrategy ring. The two workloads are interleaved deterministically on one thread so that every disk
+ * read can be attributed to the workload that caused it.
+ *
+ * Usage: buffer_access_strategy_benchmark [num_lookups] [scan_pages_per_lookup]
+ */
+class BufferAccessStrategyBenchmark {
+ public:
+  static constexpr size_t POOL_SIZE = 256;
+  static constexpr size_t NUM_HOT_PAGES = 192;
+  static constexpr size_t NUM_SCAN_PAGES = 10 * POOL_SIZE;
+
+  BufferAccessStrategyBenchmark(size_t num_lookups, size_t scan_pages_per_lookup)
+      : num_lookups_(num_lookups), scan_pages_per_lookup_(scan_pages_per_lookup) {}
+
+  void Run() {
+    std::printf("pool=%zu hot_pages=%zu scan_pages=%zu lookups=%zu scan_pages_per_lookup=%zu\n", POOL_SIZE,
+                NUM_HOT_PAGES, NUM_SCAN_PAGES, num_lookups_, scan_pages_per_lookup_);
+    std::printf("%10s %10s %18s %18s\n", "replacer", "scan", "oltp hit rate", "scan hit rate");
+    for (auto [replacer_name, replacer_type] : {std::pair{"clock", ReplacerType::CLOCK},
+                                                std::pair{"lru-k", ReplacerType::LRU_K}}) {
+      RunOne(replacer_name, replacer_type, false);
+      RunOne(replacer_name, replacer_type, true);
+    }
+  }
+
+ private:
+  void RunOne(const char *replacer_name, ReplacerType replacer_type, bool use_strategy) {
+    const std::string db_name = "buffer_access_strategy_benchmark.db";
+    DiskManager disk_manager(db_name);
+    BufferPoolManagerInstance bpm(POOL_SIZE, &disk_manager, nullptr, replacer_type);
+
+    // Lay out the OLTP pages first, then the table that is scanned.
+    for (size_t i = 0; i < NUM_HOT_PAGES + NUM_SCAN_PAGES; i++) {
+      page_id_t page_id;
+      bpm.NewPage(&page_id);
+      bpm.UnpinPage(page_id, true);
+    }
+    // Write the pages out, so that the runs start from a clean pool and the pool has nothing left to flush when it is
+    // destroyed after the files are gone.
+    bpm.FlushAllPages();
+
+    std::unique_ptr<BufferAccessStrategy> strategy;
+    if (use_strategy) {
+      strategy = std::make_unique<BufferAccessStrategy>();
+    }
+    ZipfianGenerator zipf(NUM_HOT_PAGES, 0.99, 42);
+    size_t oltp_misses = 0;
+    size_t scans = 0;
+    size_t scan_misses = 0;
+    size_t scan_cursor = 0;
+
+    for (size_t i = 0; i < num_lookups_; i++) {
+      auto page_id = static_cast<page_id_t>(zipf.Next());
+      int reads_before = disk_manager.GetNumReads();
+      if (bpm.FetchPage(page_id) != nullptr) {
+        bpm.UnpinPage(page_id, false);
+      }
+      oltp_misses += disk_manager.GetNumReads() != reads_before ? 1 : 0;
+
+      for (size_t j = 0; j < scan_pages_per_lookup_; j++) {
+        page_id = static_cast<page_id_t>(NUM_HOT_PAGES + scan_cursor);
+        scan_cursor = (scan_cursor + 1) % NUM_SCAN_PAGES;
+        reads_before = disk_manager.GetNumReads();
+        if (bpm.FetchPage(page_id, strategy.get()) != nullptr) {
+          bpm.UnpinPage(page_id, false);
+        }
+        scans++;
+        scan_misses += disk_manager.GetNumReads() != reads_before ? 1 : 0;
+      }
+    }
+
+    std::printf("%10s %10s %18.4f %18.4f\n", replacer_name, use_strategy ? "ring" : "shared",
+                1.0 - static_cast<double>(oltp_misses) / static_cast<double>(num_lookups_),
+                scans == 0 ? 0.0 : 1.0 - static_cast<double>(scan_misses) / static_cast<double>(scans));
+
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove("buffer_access_strategy_benchmark.log");
+  }
+
+  size_t num_lookups_;
+  size_t scan_pages_per_lookup_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_lookups = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  size_t scan_pages_per_lookup = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1;
+  bustub::BufferAccessStrategyBenchmark(num_lookups, scan_pages_per_lookup).Run();
+  return 0;
+}
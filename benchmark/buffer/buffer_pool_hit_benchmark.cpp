@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_hit_benchmark.cpp
+//
+// Identification: benchmark/buffer/buffer_pool_hit_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+namespace bustub {
+
+/**
+ * Measures the throughput of buffer pool hits as the number of threads grows. Every page is resident, so each
+ * operation is a FetchPage that hits followed by an UnpinPage, and no operation needs the buffer pool latch. Both
+ * replacers record the accesses of hits without a latch, so throughput should scale with the number of cores.
+ *
+ * Usage: buffer_pool_hit_benchmark [max_threads] [duration_ms]
+ */
+class BufferPoolHitBenchmark {
+ public:
+  static constexpr size_t POOL_SIZE = 4096;
+
+  BufferPoolHitBenchmark(size_t max_threads, size_t duration_ms) : max_threads_(max_threads), duration_(duration_ms) {}
+
+  void Run() {
+    std::printf("pool=%zu duration=%ldms hardware_threads=%u\n", POOL_SIZE, static_cast<long>(duration_.count()),  // NOLINT
+                std::thread::hardware_concurrency());
+    std::printf("%10s %8s %16s %10s\n", "replacer", "threads", "hits/s", "scaling");
+    for (auto [replacer_name, replacer_type] : {std::pair{"clock", ReplacerType::CLOCK},
+                                                std::pair{"lru-k", ReplacerType::LRU_K}}) {
+      RunOne(replacer_name, replacer_type);
+    }
+  }
+
+ private:
+  void RunOne(const char *replacer_name, ReplacerType replacer_type) {
+    const std::string db_name = "buffer_pool_hit_benchmark.db";
+    DiskManager disk_manager(db_name);
+    BufferPoolManagerInstance bpm(POOL_SIZE, &disk_manager, nullptr, replacer_type);
+    for (size_t i = 0; i < POOL_SIZE; i++) {
+      page_id_t page_id;
+      bpm.NewPage(&page_id);
+      bpm.UnpinPage(page_id, false);
+    }
+
+    double single_thread = 0;
+    for (size_t num_threads = 1; num_threads <= max_threads_; num_threads *= 2) {
+      std::atomic<bool> stop{false};
+      std::vector<uint64_t> ops(num_threads);
+      std::vector<std::thread> threads;
+      for (size_t tid = 0; tid < num_threads; tid++) {
+        threads.emplace_back([&, tid] {
+          std::mt19937 rng(tid);
+          std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(POOL_SIZE - 1));
+          uint64_t count = 0;
+          while (!stop.load(std::memory_order_relaxed)) {
+            page_id_t page_id = dist(rng);
+            if (bpm.FetchPage(page_id) != nullptr) {
+              bpm.UnpinPage(page_id, false);
+              count++;
+            }
+          }
+          ops[tid] = count;
+        });
+      }
+      std::this_thread::sleep_for(duration_);
+      stop = true;
+      uint64_t total = 0;
+      for (size_t tid = 0; tid < num_threads; tid++) {
+        threads[tid].join();
+        total += ops[tid];
+      }
+
+      double hits_per_sec = static_cast<double>(total) * 1000.0 / static_cast<double>(duration_.count());
+      if (num_threads == 1) {
+        single_thread = hits_per_sec;
+      }
+      std::printf("%10s %8zu %16.0f %9.2fx\n", replacer_name, num_threads, hits_per_sec, hits_per_sec / single_thread);
+    }
+
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove("buffer_pool_hit_benchmark.log");
+  }
+
+  size_t max_threads_;
+  std::chrono::milliseconds duration_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+  size_t duration_ms = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+  bustub::BufferPoolHitBenchmark(max_threads == 0 ? 1 : max_threads, duration_ms).Run();
+  return 0;
+}
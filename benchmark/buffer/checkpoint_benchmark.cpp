@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// checkpoint_benchmark.cpp
+//
+// Identification: benchmark/buffer/checkpoint_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+
+namespace bustub {
+
+/**
+ * Measures a checkpoint of a buffer pool full of dirty pages: every resident page is written and made durable. The
+ * baseline writes the pages one WritePage at a time, in the order of the page table, and syncs at the end, as
+ * FlushAllPages used to. FlushAllPages hands them to a WriteScheduler, which writes runs of consecutive pages with one
+ * pwritev each and syncs once. Every round dirties all pages again first, so each checkpoint writes the whole pool.
+ * Both are run against a single instance and against a parallel pool of the same size, whose shards own interleaved
+ * page ids and are checkpointed together.
+ *
+ * Usage: checkpoint_benchmark [num_pages] [rounds] [num_instances]
+ */
+class CheckpointBenchmark {
+ public:
+  CheckpointBenchmark(size_t num_pages, size_t rounds, size_t num_instances)
+      : num_pages_(num_pages), rounds_(rounds), num_instances_(num_instances) {}
+
+  void Run() {
+    std::remove(DB_NAME);
+    std::printf("dirty_pages=%zu rounds=%zu\n", num_pages_, rounds_);
+    std::printf("%12s %16s %12s %12s %12s\n", "pool", "mode", "ms", "MB/s", "writes");
+    {
+      DiskManager disk_manager(DB_NAME);
+      BufferPoolManagerInstance bpm(num_pages_, &disk_manager);
+      RunPool("instance", &bpm, &disk_manager);
+    }
+    {
+      DiskManager disk_manager(DB_NAME);
+      ParallelBufferPoolManager bpm(num_instances_, (num_pages_ + num_instances_ - 1) / num_instances_,
+                                    &disk_manager);
+      RunPool(("parallel x" + std::to_string(num_instances_)).c_str(), &bpm, &disk_manager);
+    }
+    std::remove("checkpoint_benchmark.log");
+  }
+
+ private:
+  static constexpr const char *DB_NAME = "checkpoint_benchmark.db";
+
+  void RunPool(const char *pool, BufferPoolManager *bpm, DiskManager *disk_manager) {
+    std::vector<page_id_t> page_ids(num_pages_);
+    for (size_t i = 0; i < num_pages_; i++) {
+      bpm->NewPage(&page_ids[i]);
+      bpm->UnpinPage(page_ids[i], true);
+    }
+    // Lay the file out once, so that both variants overwrite existing pages.
+    bpm->FlushAllPages();
+
+    // The page table hands pages out in no particular order; a shuffle stands in for it.
+    std::shuffle(page_ids.begin(), page_ids.end(), std::mt19937(3));
+    for (bool coalesced : {false, true}) {
+      double seconds = 0;
+      const int writes_before = disk_manager->GetNumWrites();
+      for (size_t round = 0; round < rounds_; round++) {
+        for (page_id_t page_id : page_ids) {
+          Page *page = bpm->FetchPage(page_id);
+          page->GetData()[round % 64]++;
+          bpm->UnpinPage(page_id, true);
+        }
+        auto start = std::chrono::steady_clock::now();
+        if (coalesced) {
+          bpm->FlushAllPages();
+        } else {
+          for (page_id_t page_id : page_ids) {
+            Page *page = bpm->FetchPage(page_id);
+            disk_manager->WritePage(page_id, page->GetData());
+            bpm->UnpinPage(page_id, false);
+          }
+          disk_manager->Sync();
+        }
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
+      const double mean = seconds / static_cast<double>(rounds_);
+      std::printf("%12s %16s %12.1f %12.1f %12d\n", pool, coalesced ? "FlushAllPages" : "page at a time", mean * 1e3,
+                  static_cast<double>(num_pages_ * PAGE_SIZE) / (1024 * 1024) / mean,
+                  (disk_manager->GetNumWrites() - writes_before) / static_cast<int>(rounds_));
+    }
+
+    disk_manager->ShutDown();
+    std::remove(DB_NAME);
+  }
+
+  size_t num_pages_;
+  size_t rounds_;
+  size_t num_instances_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_pages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 3;
+  size_t num_instances = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+  bustub::CheckpointBenchmark(num_pages, rounds, num_instances).Run();
+  return 0;
+}
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_replacer_benchmark.cpp
+//
+// Identification: benchmark/buffer/clock_replacer_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+
+namespace bustub {
+
+/**
+ * Microbenchmark for the replacers on a large pool. Reports the average cost in nanoseconds of Unpin, Pin and Victim
+ * when the replacer tracks every frame of a 100k frame pool.
+ *
+ * Usage: clock_replacer_benchmark [num_frames] [num_ops]
+ */
+class ClockReplacerBenchmark {
+ public:
+  ClockReplacerBenchmark(size_t num_frames, size_t num_ops) : num_frames_(num_frames), num_ops_(num_ops) {}
+
+  void Run() {
+    std::printf("frames=%zu ops=%zu\n", num_frames_, num_ops_);
+    std::printf("%10s %14s %14s %14s\n", "replacer", "unpin (ns)", "pin (ns)", "victim (ns)");
+    RunOne("clock", std::make_unique<ClockReplacer>(num_frames_));
+    RunOne("lru-k", std::make_unique<LRUKReplacer>(num_frames_));
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  void RunOne(const char *name, std::unique_ptr<Replacer> replacer) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<frame_id_t> dist(0, static_cast<frame_id_t>(num_frames_ - 1));
+    std::vector<frame_id_t> frames(num_ops_);
+    for (auto &frame_id : frames) {
+      frame_id = dist(rng);
+    }
+
+    // Make every frame evictable, so that Pin and Unpin operate on a full replacer.
+    for (size_t i = 0; i < num_frames_; i++) {
+      replacer->RecordAccess(static_cast<frame_id_t>(i));
+      replacer->Unpin(static_cast<frame_id_t>(i));
+    }
+
+    auto start = Clock::now();
+    for (auto frame_id : frames) {
+      replacer->Pin(frame_id);
+    }
+    double pin_ns = NanosPerOp(start, num_ops_);
+
+    start = Clock::now();
+    for (auto frame_id : frames) {
+      replacer->RecordAccess(frame_id);
+      replacer->Unpin(frame_id);
+    }
+    double unpin_ns = NanosPerOp(start, num_ops_);
+
+    // Steady-state eviction: every victim is immediately reused and unpinned again, as a buffer pool would do.
+    start = Clock::now();
+    for (size_t i = 0; i < num_ops_; i++) {
+      frame_id_t frame_id;
+      if (replacer->Victim(&frame_id)) {
+        replacer->RecordAccess(frame_id);
+        replacer->Unpin(frame_id);
+      }
+    }
+    double victim_ns = NanosPerOp(start, num_ops_);
+
+    std::printf("%10s %14.1f %14.1f %14.1f\n", name, unpin_ns, pin_ns, victim_ns);
+  }
+
+  static double NanosPerOp(Clock::time_point start, size_t num_ops) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()) /
+           static_cast<double>(num_ops);
+  }
+
+  size_t num_frames_;
+  size_t num_ops_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  size_t num_ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+  bustub::ClockReplacerBenchmark(num_frames, num_ops).Run();
+  return 0;
+}
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_benchmark.cpp
+//
+// Identification: benchmark/buffer/compressed_page_cache_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/compressed_page_cache.h"
+#include "storage/disk/throttled_disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Measures what a compressed second-tier cache buys a buffer pool that is too small for its working set. The pages
+ * hold table-like rows (a few integer columns and a short string drawn from a small domain), the disk adds a fixed
+ * latency to every read, and a single thread fetches pages uniformly at random, once without the cache and once with
+ * a cache of each given size. The capacity multiplier is the number of pages held in memory, in frames and in the
+ * cache, divided by the number of frames.
+ *
+ * Usage: compressed_page_cache_benchmark [num_fetches] [read_latency_us]
+ */
+class CompressedPageCacheBenchmark {
+ public:
+  static constexpr size_t POOL_SIZE = 128;
+  static constexpr size_t NUM_PAGES = 1024;
+  static constexpr size_t ROW_SIZE = 32;
+
+  CompressedPageCacheBenchmark(size_t num_fetches, size_t read_latency_us)
+      : num_fetches_(num_fetches), read_latency_(read_latency_us) {}
+
+  void Run() {
+    std::printf("pool=%zu pages=%zu fetches=%zu read_latency=%lldus\n", POOL_SIZE, NUM_PAGES, num_fetches_,
+                static_cast<long long>(read_latency_.count()));  // NOLINT
+    std::printf("%10s %12s %10s %10s %8s %10s %10s %10s\n", "cache KiB", "fetches/s", "disk reads", "cache hits",
+                "ratio", "capacity", "miss p50", "miss p99");
+    for (size_t cache_pages : {0, 64, 128, 256}) {
+      RunOne(cache_pages * PAGE_SIZE);
+    }
+  }
+
+ private:
+  static void FillPage(page_id_t page_id, char *data) {
+    static const char *const cities[] = {"Pittsburgh", "Boston", "Seattle", "Austin", "Chicago", "Denver"};
+    std::mt19937 rng(page_id);
+    memset(data, 0, PAGE_SIZE);
+    for (size_t offset = 0; offset + ROW_SIZE <= PAGE_SIZE; offset += ROW_SIZE) {
+      auto *columns = reinterpret_cast<int32_t *>(data + offset);
+      columns[0] = static_cast<int32_t>(page_id * (PAGE_SIZE / ROW_SIZE) + offset / ROW_SIZE);
+      columns[1] = static_cast<int32_t>(rng() % 100);
+      columns[2] = static_cast<int32_t>(rng() % 10000);
+      strncpy(data + offset + 12, cities[rng() % 6], ROW_SIZE - 12);
+    }
+  }
+
+  void RunOne(size_t cache_size) {
+    const std::string db_name = "compressed_page_cache_benchmark.db";
+    buffer_pool_compressed_cache_size = cache_size;
+    ThrottledDiskManager disk_manager(std::make_unique<DiskManager>(db_name));
+    BufferPoolManagerInstance bpm(POOL_SIZE, &disk_manager);
+
+    for (size_t i = 0; i < NUM_PAGES; i++) {
+      page_id_t page_id;
+      Page *page = bpm.NewPage(&page_id);
+      FillPage(page_id, page->GetData());
+      bpm.UnpinPage(page_id, true);
+    }
+    // Write the pages out, so that the pool has nothing left to flush when it is destroyed after the files are gone.
+    bpm.FlushAllPages();
+    // Warm up so that the cache is full before measuring.
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < NUM_PAGES * 2; i++) {
+      auto page_id = static_cast<page_id_t>(rng() % NUM_PAGES);
+      bpm.FetchPage(page_id);
+      bpm.UnpinPage(page_id, false);
+    }
+
+    disk_manager.SetProfile({read_latency_});
+    int reads_before = disk_manager.GetNumReads();
+    BufferPoolMetricsSnapshot before = bpm.GetMetrics();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_fetches_; i++) {
+      auto page_id = static_cast<page_id_t>(rng() % NUM_PAGES);
+      bpm.FetchPage(page_id);
+      bpm.UnpinPage(page_id, false);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    BufferPoolMetricsSnapshot diff = bpm.GetMetrics().Diff(before);
+
+    CompressedPageCache *cache = bpm.GetCompressedCache();
+    size_t cached_pages = cache == nullptr ? 0 : cache->GetNumPages();
+    double ratio = cache == nullptr ? 0.0 : cache->GetCompressionRatio();
+    std::printf("%10zu %12.0f %10d %10lu %8.2f %10.2f %8luus %8luus\n", cache_size / 1024,
+                static_cast<double>(num_fetches_) / elapsed.count(), disk_manager.GetNumReads() - reads_before,
+                diff.Get(BufferPoolMetric::COMPRESSED_CACHE_HITS), ratio,
+                static_cast<double>(POOL_SIZE + cached_pages) / static_cast<double>(POOL_SIZE),
+                diff.MissLatencyPercentile(0.5), diff.MissLatencyPercentile(0.99));
+
+    buffer_pool_compressed_cache_size = 0;
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove("compressed_page_cache_benchmark.log");
+  }
+
+  size_t num_fetches_;
+  std::chrono::microseconds read_latency_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_fetches = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+  size_t read_latency_us = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+  bustub::CompressedPageCacheBenchmark(num_fetches, read_latency_us).Run();
+  return 0;
+}
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// emulated_device_benchmark.cpp
+//
+// Identification: benchmark/buffer/emulated_device_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "workload/zipfian_generator.h"
+
+namespace bustub {
+
+/**
+ * Runs a zipfian page workload through a buffer pool whose pages live in memory, behind no throttling, an emulated
+ * SSD and an emulated HDD, several times each. With the file system out of the way, the time of a run is the time
+ * of the buffer pool plus the modelled device time of its misses, so the runs of a profile should agree closely; the
+ * benchmark reports the mean and the spread between the fastest and the slowest run.
+ *
+ * Usage: emulated_device_benchmark [fetches_per_run] [runs]
+ */
+class EmulatedDeviceBenchmark {
+ public:
+  static constexpr size_t POOL_SIZE = 256;
+  static constexpr size_t NUM_PAGES = 4096;
+
+  EmulatedDeviceBenchmark(size_t fetches_per_run, size_t runs) : fetches_per_run_(fetches_per_run), runs_(runs) {}
+
+  void Run() {
+    std::printf("pool=%zu pages=%zu fetches_per_run=%zu runs=%zu\n", POOL_SIZE, NUM_PAGES, fetches_per_run_, runs_);
+    std::printf("%8s %12s %12s %12s\n", "device", "misses", "mean ms", "spread %");
+    RunProfile("none", nullptr);
+    ThrottleProfile ssd = ThrottleProfile::Ssd();
+    RunProfile("ssd", &ssd);
+    ThrottleProfile hdd = ThrottleProfile::Hdd();
+    RunProfile("hdd", &hdd);
+  }
+
+ private:
+  void RunProfile(const char *name, const ThrottleProfile *profile) {
+    std::vector<double> seconds;
+    int misses = 0;
+    for (size_t run = 0; run < runs_; run++) {
+      BustubInstance instance("emulated_device_benchmark.db", POOL_SIZE, StorageType::MEMORY, profile);
+      // Load the pages straight into memory, without the device, and with an empty pool.
+      DiskManager *memory = instance.disk_manager_;
+      if (profile != nullptr) {
+        memory = static_cast<ThrottledDiskManager *>(instance.disk_manager_)->GetDiskManager();
+      }
+      std::vector<char> data(PAGE_SIZE);
+      for (size_t i = 0; i < NUM_PAGES; i++) {
+        page_id_t page_id = memory->AllocatePage();
+        snprintf(data.data(), PAGE_SIZE, "page %d", page_id);
+        memory->WritePage(page_id, data.data());
+      }
+
+      BufferPoolManagerInstance *bpm = instance.buffer_pool_manager_;
+      ZipfianGenerator zipf(NUM_PAGES, 0.8, 7);
+      const int reads_before = instance.disk_manager_->GetNumReads();
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < fetches_per_run_; i++) {
+        auto page_id = static_cast<page_id_t>(zipf.Next());
+        Page *page = bpm->FetchPage(page_id);
+        if (page != nullptr) {
+          bpm->UnpinPage(page_id, false);
+        }
+      }
+      seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+      misses = instance.disk_manager_->GetNumReads() - reads_before;
+    }
+    double mean = 0;
+    for (double s : seconds) {
+      mean += s / static_cast<double>(seconds.size());
+    }
+    auto [fastest, slowest] = std::minmax_element(seconds.begin(), seconds.end());
+    std::printf("%8s %12d %12.2f %12.1f\n", name, misses, mean * 1e3, (*slowest - *fastest) / mean * 100);
+  }
+
+  size_t fetches_per_run_;
+  size_t runs_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t fetches_per_run = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+  size_t runs = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+  bustub::EmulatedDeviceBenchmark(fetches_per_run, runs).Run();
+  return 0;
+}
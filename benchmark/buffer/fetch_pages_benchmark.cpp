@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// fetch_pages_benchmark.cpp
+//
+// Identification: benchmark/buffer/fetch_pages_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/throttled_disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Compares fetching a list of known page ids one FetchPage at a time with fetching them in one FetchPages call. Each
+ * batch picks its pages from a small window of the file, so that many of them are neighbours, as the RIDs of an index
+ * scan over a clustered table would be. The pool is cleared between batches so that every page is a miss. The disk
+ * charges its latency per read request: once per page for FetchPage, once per run of consecutive pages for FetchPages.
+ *
+ * Usage: fetch_pages_benchmark [num_batches] [read_latency_us]
+ */
+class FetchPagesBenchmark {
+ public:
+  static constexpr size_t POOL_SIZE = 256;
+  static constexpr size_t NUM_PAGES = 4096;
+
+  FetchPagesBenchmark(size_t num_batches, size_t read_latency_us)
+      : num_batches_(num_batches), read_latency_(read_latency_us) {}
+
+  void Run() {
+    std::printf("pool=%zu pages=%zu batches=%zu read_latency=%lldus\n", POOL_SIZE, NUM_PAGES, num_batches_,
+                static_cast<long long>(read_latency_.count()));  // NOLINT
+    std::printf("%10s %10s %12s %14s %14s %10s\n", "batch", "window", "mode", "pages/s", "us/batch", "speedup");
+    for (auto [batch_size, window] : {std::pair{8, 16}, std::pair{32, 64}, std::pair{32, 1024}, std::pair{128, 256}}) {
+      double single = RunOne(batch_size, window, false);
+      double batched = RunOne(batch_size, window, true);
+      std::printf("%10d %10d %12s %14.0f %14.1f %10s\n", batch_size, window, "FetchPage", batch_size / single,
+                  single * 1e6, "");
+      std::printf("%10d %10d %12s %14.0f %14.1f %9.2fx\n", batch_size, window, "FetchPages", batch_size / batched,
+                  batched * 1e6, single / batched);
+    }
+  }
+
+ private:
+  /** @return the mean time to fetch one batch, in seconds */
+  double RunOne(size_t batch_size, size_t window, bool batched) {
+    const std::string db_name = "fetch_pages_benchmark.db";
+    ThrottledDiskManager disk_manager(std::make_unique<DiskManager>(db_name));
+    BufferPoolManagerInstance bpm(POOL_SIZE, &disk_manager);
+    for (size_t i = 0; i < NUM_PAGES; i++) {
+      page_id_t page_id;
+      bpm.NewPage(&page_id);
+      bpm.UnpinPage(page_id, true);
+    }
+    bpm.FlushAllPages();
+
+    disk_manager.SetProfile({read_latency_});
+    std::mt19937 rng(42);
+    std::vector<page_id_t> page_ids(window);
+    std::vector<Page *> pages(batch_size);
+    std::chrono::duration<double> elapsed{0};
+    for (size_t batch = 0; batch < num_batches_; batch++) {
+      // Push the previous batch out with pages from the far end of the file, which is not timed.
+      disk_manager.SetProfile({});
+      for (size_t i = 0; i < POOL_SIZE; i++) {
+        auto page_id = static_cast<page_id_t>(NUM_PAGES - 1 - i);
+        bpm.FetchPage(page_id);
+        bpm.UnpinPage(page_id, false);
+      }
+      disk_manager.SetProfile({read_latency_});
+
+      // A random subset of a random window, in random order.
+      auto first = static_cast<page_id_t>(rng() % (NUM_PAGES - POOL_SIZE - window));
+      for (size_t i = 0; i < window; i++) {
+        page_ids[i] = first + static_cast<page_id_t>(i);
+      }
+      std::shuffle(page_ids.begin(), page_ids.end(), rng);
+
+      auto start = std::chrono::steady_clock::now();
+      if (batched) {
+        bpm.FetchPages(page_ids.data(), batch_size, pages.data());
+      } else {
+        for (size_t i = 0; i < batch_size; i++) {
+          pages[i] = bpm.FetchPage(page_ids[i]);
+        }
+      }
+      elapsed += std::chrono::steady_clock::now() - start;
+      for (size_t i = 0; i < batch_size; i++) {
+        if (pages[i] != nullptr) {
+          bpm.UnpinPage(page_ids[i], false);
+        }
+      }
+    }
+
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove("fetch_pages_benchmark.log");
+    return elapsed.count() / static_cast<double>(num_batches_);
+  }
+
+  size_t num_batches_;
+  std::chrono::microseconds read_latency_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_batches = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100;
+  size_t read_latency_us = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+  bustub::FetchPagesBenchmark(num_batches, read_latency_us).Run();
+  return 0;
+}
@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_benchmark.cpp
+//
+// Identification: benchmark/buffer/frame_arena_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+namespace bustub {
+
+/**
+ * Compares random page fetches on a large, fully resident buffer pool whose frames are backed by 4 KB pages against
+ * one backed by 2 MB huge pages. Every fetch reads a word of the page, as a lookup in the page would. Reports fetch
+ * throughput and, where perf events are available, data TLB misses per fetch.
+ *
+ * Usage: frame_arena_benchmark [pool_size_mb] [num_fetches]
+ */
+class FrameArenaBenchmark {
+ public:
+  FrameArenaBenchmark(size_t pool_size_mb, size_t num_fetches)
+      : pool_size_(pool_size_mb * 1024 * 1024 / PAGE_SIZE), num_fetches_(num_fetches) {}
+
+  void Run() {
+    std::printf("pool=%zu frames (%zu MB) fetches=%zu\n", pool_size_, pool_size_ * PAGE_SIZE / (1024 * 1024),
+                num_fetches_);
+    std::printf("%12s %14s %16s %18s\n", "backing", "fetches/s", "ns/fetch", "dTLB misses/fetch");
+    RunOne(false);
+    RunOne(true);
+  }
+
+ private:
+  /** Counts data TLB read misses of this thread, in user space. */
+  class TlbMissCounter {
+   public:
+    TlbMissCounter() {
+      perf_event_attr attr{};
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.size = sizeof(attr);
+      attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~TlbMissCounter() {
+      if (fd_ >= 0) {
+        close(fd_);
+      }
+    }
+    bool Available() const { return fd_ >= 0; }
+    void Start() {
+      if (fd_ >= 0) {
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+    uint64_t Stop() {
+      uint64_t count = 0;
+      if (fd_ >= 0) {
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+          count = 0;
+        }
+      }
+      return count;
+    }
+
+   private:
+    int fd_;
+  };
+
+  void RunOne(bool use_huge_pages) {
+    const std::string db_name = "frame_arena_benchmark.db";
+    buffer_pool_use_huge_pages = use_huge_pages;
+    DiskManager disk_manager(db_name);
+    auto *bpm = new BufferPoolManagerInstance(pool_size_, &disk_manager);
+    // Fill the pool. New pages are never written back, since they are unpinned clean.
+    for (size_t i = 0; i < pool_size_; i++) {
+      page_id_t page_id;
+      Page *page = bpm->NewPage(&page_id);
+      page->GetData()[i % PAGE_SIZE] = static_cast<char>(i);
+      bpm->UnpinPage(page_id, false);
+    }
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<page_id_t> page_dist(0, static_cast<page_id_t>(pool_size_ - 1));
+    std::uniform_int_distribution<size_t> offset_dist(0, PAGE_SIZE / sizeof(uint64_t) - 1);
+    TlbMissCounter tlb_misses;
+    uint64_t checksum = 0;
+
+    tlb_misses.Start();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_fetches_; i++) {
+      page_id_t page_id = page_dist(rng);
+      Page *page = bpm->FetchPage(page_id);
+      checksum += reinterpret_cast<uint64_t *>(page->GetData())[offset_dist(rng)];
+      bpm->UnpinPage(page_id, false);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    uint64_t misses = tlb_misses.Stop();
+
+    const char *backing = "4k";
+    switch (bpm->GetHugePageBacking()) {
+      case HugePageBacking::NONE:
+        backing = "4k";
+        break;
+      case HugePageBacking::TRANSPARENT:
+        backing = "thp";
+        break;
+      case HugePageBacking::HUGETLB:
+        backing = "hugetlb";
+        break;
+    }
+    std::string misses_per_fetch = "n/a";
+    if (tlb_misses.Available()) {
+      misses_per_fetch = std::to_string(static_cast<double>(misses) / static_cast<double>(num_fetches_));
+    }
+    std::printf("%12s %14.0f %16.1f %18s   (checksum %lu)\n", backing,
+                static_cast<double>(num_fetches_) * 1e9 / ns, ns / static_cast<double>(num_fetches_),
+                misses_per_fetch.c_str(), static_cast<unsigned long>(checksum));  // NOLINT
+
+    delete bpm;
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove("frame_arena_benchmark.log");
+  }
+
+  size_t pool_size_;
+  size_t num_fetches_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t pool_size_mb = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+  size_t num_fetches = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000000;
+  bustub::FrameArenaBenchmark(pool_size_mb, num_fetches).Run();
+  return 0;
+}
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_priority_benchmark.cpp
+//
+// Identification: benchmark/buffer/page_priority_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+namespace bustub {
+
+/**
+ * Measures the index lookup hit ratio under a scan-heavy mixed workload. Every index lookup (one root page plus one
+ * of a few index pages) is followed by a run of sequential heap page fetches, as an index nested loop join over a
+ * table scan would do. The workload runs once with every page at the default priority and once with the index pages
+ * tagged, and reports the hit ratio of index and heap fetches separately.
+ *
+ * Usage: page_priority_benchmark [pool_size] [scan_pages_per_lookup]
+ */
+class PagePriorityBenchmark {
+ public:
+  static constexpr size_t NUM_INDEX_PAGES = 8;
+  static constexpr size_t NUM_HEAP_PAGES = 4096;
+  static constexpr size_t NUM_LOOKUPS = 20000;
+
+  PagePriorityBenchmark(size_t pool_size, size_t scan_pages_per_lookup)
+      : pool_size_(pool_size), scan_pages_per_lookup_(scan_pages_per_lookup) {}
+
+  void Run() {
+    const std::string db_name = "page_priority_benchmark.db";
+    DiskManager disk_manager(db_name);
+    {
+      BufferPoolManagerInstance bpm(pool_size_, &disk_manager);
+      for (size_t i = 0; i < NUM_INDEX_PAGES + NUM_HEAP_PAGES; i++) {
+        page_id_t page_id;
+        bpm.NewPage(&page_id);
+        bpm.UnpinPage(page_id, true);
+      }
+      bpm.FlushAllPages();
+    }
+
+    std::printf("pool=%zu index_pages=%zu heap_pages=%zu scan_pages_per_lookup=%zu lookups=%zu\n", pool_size_,
+                NUM_INDEX_PAGES, NUM_HEAP_PAGES, scan_pages_per_lookup_, NUM_LOOKUPS);
+    std::printf("%10s %14s %14s\n", "hints", "index hit", "heap hit");
+    RunOne(&disk_manager, "untagged", false);
+    RunOne(&disk_manager, "tagged", true);
+
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove("page_priority_benchmark.log");
+  }
+
+ private:
+  void RunOne(DiskManager *disk_manager, const char *name, bool tagged) {
+    BufferPoolManagerInstance bpm(pool_size_, disk_manager);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<page_id_t> index_dist(1, NUM_INDEX_PAGES - 1);
+    size_t index_fetches = 0;
+    size_t index_hits = 0;
+    size_t heap_fetches = 0;
+    size_t heap_hits = 0;
+    page_id_t next_heap = 0;
+
+    auto fetch = [&](page_id_t page_id, PagePriority priority, size_t *fetches, size_t *hits) {
+      int reads = disk_manager->GetNumReads();
+      bpm.FetchPage(page_id, tagged ? priority : PagePriority::HEAP);
+      bpm.UnpinPage(page_id, false);
+      ++*fetches;
+      *hits += disk_manager->GetNumReads() == reads ? 1 : 0;
+    };
+
+    for (size_t i = 0; i < NUM_LOOKUPS; i++) {
+      fetch(0, PagePriority::INDEX_ROOT, &index_fetches, &index_hits);
+      fetch(index_dist(rng), PagePriority::INDEX, &index_fetches, &index_hits);
+      for (size_t j = 0; j < scan_pages_per_lookup_; j++) {
+        fetch(static_cast<page_id_t>(NUM_INDEX_PAGES) + next_heap, PagePriority::HEAP, &heap_fetches, &heap_hits);
+        next_heap = (next_heap + 1) % static_cast<page_id_t>(NUM_HEAP_PAGES);
+      }
+    }
+    std::printf("%10s %14.4f %14.4f\n", name, static_cast<double>(index_hits) / index_fetches,
+                static_cast<double>(heap_hits) / heap_fetches);
+  }
+
+  size_t pool_size_;
+  size_t scan_pages_per_lookup_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t pool_size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+  size_t scan_pages_per_lookup = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16;
+  bustub::PagePriorityBenchmark(pool_size, scan_pages_per_lookup).Run();
+  return 0;
+}
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_benchmark.cpp
+//
+// Identification: benchmark/buffer/parallel_buffer_pool_manager_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+
+namespace bustub {
+
+/**
+ * Measures FetchPage/UnpinPage throughput of a single BufferPoolManagerInstance versus a ParallelBufferPoolManager
+ * while scaling the number of worker threads from 1 to 32. The working set fits in the pool, so after warm-up every
+ * fetch is a hit and the benchmark isolates latch contention.
+ *
+ * Usage: parallel_buffer_pool_manager_benchmark [duration_ms] [num_instances]
+ */
+class ParallelBufferPoolManagerBenchmark {
+ public:
+  static constexpr size_t TOTAL_FRAMES = 1024;
+
+  ParallelBufferPoolManagerBenchmark(std::chrono::milliseconds duration, size_t num_instances)
+      : duration_(duration), num_instances_(num_instances) {}
+
+  void Run() {
+    std::printf("%8s %20s %20s\n", "threads", "single (ops/s)", "parallel (ops/s)");
+    for (size_t num_threads = 1; num_threads <= 32; num_threads *= 2) {
+      double single = RunOne(1, num_threads);
+      double parallel = RunOne(num_instances_, num_threads);
+      std::printf("%8zu %20.0f %20.0f\n", num_threads, single, parallel);
+    }
+  }
+
+ private:
+  double RunOne(size_t num_instances, size_t num_threads) {
+    const std::string db_name = "parallel_bpm_benchmark.db";
+    DiskManager disk_manager(db_name);
+    std::unique_ptr<BufferPoolManager> bpm;
+    if (num_instances == 1) {
+      bpm = std::make_unique<BufferPoolManagerInstance>(TOTAL_FRAMES, &disk_manager);
+    } else {
+      bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, TOTAL_FRAMES / num_instances, &disk_manager);
+    }
+
+    // Fill the pool so that every page of the working set is resident.
+    std::vector<page_id_t> page_ids;
+    for (size_t i = 0; i < TOTAL_FRAMES; i++) {
+      page_id_t page_id;
+      if (bpm->NewPage(&page_id) == nullptr) {
+        break;
+      }
+      bpm->UnpinPage(page_id, false);
+      page_ids.push_back(page_id);
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total_ops{0};
+    std::vector<std::thread> threads;
+    for (size_t tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([&, tid] {
+        std::mt19937 rng(tid);
+        std::uniform_int_distribution<size_t> dist(0, page_ids.size() - 1);
+        uint64_t ops = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+          page_id_t page_id = page_ids[dist(rng)];
+          if (bpm->FetchPage(page_id) != nullptr) {
+            bpm->UnpinPage(page_id, false);
+            ops++;
+          }
+        }
+        total_ops += ops;
+      });
+    }
+    std::this_thread::sleep_for(duration_);
+    stop = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove("parallel_bpm_benchmark.log");
+    return static_cast<double>(total_ops) / std::chrono::duration<double>(duration_).count();
+  }
+
+  std::chrono::milliseconds duration_;
+  size_t num_instances_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  auto duration = std::chrono::milliseconds(argc > 1 ? std::atoi(argv[1]) : 1000);
+  size_t num_instances = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16;
+  bustub::ParallelBufferPoolManagerBenchmark(duration, num_instances).Run();
+  return 0;
+}
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_benchmark.cpp
+//
+// Identification: benchmark/buffer/replacer_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "workload/zipfian_generator.h"
+
+namespace bustub {
+
+/**
+ * Compares the hit rate of the replacement policies on a mixed workload: Zipfian point lookups over a hot set of
+ * pages, interleaved with a sequential scan over a much larger region that cycles through the pool.
+ *
+ * Usage: replacer_benchmark [num_ops] [scan_percent]
+ */
+class ReplacerBenchmark {
+ public:
+  static constexpr size_t POOL_SIZE = 256;
+  static constexpr size_t NUM_HOT_PAGES = 1024;
+  static constexpr size_t NUM_SCAN_PAGES = 10 * POOL_SIZE;
+
+  ReplacerBenchmark(size_t num_ops, size_t scan_percent) : num_ops_(num_ops), scan_percent_(scan_percent) {}
+
+  void Run() {
+    std::printf("pool=%zu hot_pages=%zu scan_pages=%zu ops=%zu scan=%zu%%\n", POOL_SIZE, NUM_HOT_PAGES, NUM_SCAN_PAGES,
+                num_ops_, scan_percent_);
+    std::printf("%10s %16s %16s %12s\n", "replacer", "lookup hit rate", "scan hit rate", "time (ms)");
+    RunOne("clock", ReplacerType::CLOCK);
+    RunOne("lru-k", ReplacerType::LRU_K);
+  }
+
+ private:
+  void RunOne(const char *name, ReplacerType replacer_type) {
+    const std::string db_name = "replacer_benchmark.db";
+    DiskManager disk_manager(db_name);
+    BufferPoolManagerInstance bpm(POOL_SIZE, &disk_manager, nullptr, replacer_type);
+
+    // Lay out the hot pages first, then the scanned region.
+    for (size_t i = 0; i < NUM_HOT_PAGES + NUM_SCAN_PAGES; i++) {
+      page_id_t page_id;
+      bpm.NewPage(&page_id);
+      bpm.UnpinPage(page_id, true);
+    }
+    // Write the pages out, so that the run starts from a clean pool and the pool has nothing left to flush when it is
+    // destroyed after the files are gone.
+    bpm.FlushAllPages();
+
+    ZipfianGenerator zipf(NUM_HOT_PAGES, 0.99, 42);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> percent(0, 99);
+    size_t lookups = 0;
+    size_t lookup_misses = 0;
+    size_t scans = 0;
+    size_t scan_misses = 0;
+    size_t scan_cursor = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_ops_; i++) {
+      const bool is_scan = percent(rng) < scan_percent_;
+      page_id_t page_id;
+      if (is_scan) {
+        page_id = static_cast<page_id_t>(NUM_HOT_PAGES + scan_cursor);
+        scan_cursor = (scan_cursor + 1) % NUM_SCAN_PAGES;
+      } else {
+        page_id = static_cast<page_id_t>(zipf.Next());
+      }
+      const int reads_before = disk_manager.GetNumReads();
+      if (bpm.FetchPage(page_id) == nullptr) {
+        continue;
+      }
+      bpm.UnpinPage(page_id, false);
+      const bool miss = disk_manager.GetNumReads() != reads_before;
+      if (is_scan) {
+        scans++;
+        scan_misses += miss ? 1 : 0;
+      } else {
+        lookups++;
+        lookup_misses += miss ? 1 : 0;
+      }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    std::printf("%10s %16.4f %16.4f %12lld\n", name, HitRate(lookups, lookup_misses), HitRate(scans, scan_misses),
+                static_cast<long long>(elapsed.count()));  // NOLINT
+
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove("replacer_benchmark.log");
+  }
+
+  static double HitRate(size_t accesses, size_t misses) {
+    return accesses == 0 ? 0.0 : 1.0 - static_cast<double>(misses) / static_cast<double>(accesses);
+  }
+
+  size_t num_ops_;
+  size_t scan_percent_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_ops = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  size_t scan_percent = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50;
+  bustub::ReplacerBenchmark(num_ops, scan_percent).Run();
+  return 0;
+}
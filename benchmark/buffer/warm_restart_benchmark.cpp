@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// warm_restart_benchmark.cpp
+//
+// Identification: benchmark/buffer/warm_restart_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/throttled_disk_manager.h"
+#include "workload/zipfian_generator.h"
+
+namespace bustub {
+
+/**
+ * Measures how fast a restarted buffer pool gets back to speed. A first run warms the pool up with a skewed workload
+ * and saves its resident pages. The pool is then restarted twice, once cold and once reloading the saved pages, and
+ * the first fetches of the same workload are timed in windows. The disk adds a fixed latency to every read request.
+ *
+ * Usage: warm_restart_benchmark [fetches_per_window] [read_latency_us]
+ */
+class WarmRestartBenchmark {
+ public:
+  static constexpr size_t POOL_SIZE = 2048;
+  static constexpr size_t NUM_PAGES = 8192;
+  static constexpr size_t NUM_WINDOWS = 6;
+  static constexpr double THETA = 0.8;
+
+  WarmRestartBenchmark(size_t fetches_per_window, size_t read_latency_us)
+      : fetches_per_window_(fetches_per_window), read_latency_(read_latency_us) {}
+
+  void Run() {
+    const std::string db_name = "warm_restart_benchmark.db";
+    const std::string dump_name = "warm_restart_benchmark.bpdump";
+    ThrottledDiskManager disk_manager(std::make_unique<DiskManager>(db_name));
+    {
+      BufferPoolManagerInstance bpm(POOL_SIZE, &disk_manager);
+      for (size_t i = 0; i < NUM_PAGES; i++) {
+        page_id_t page_id;
+        bpm.NewPage(&page_id);
+        bpm.UnpinPage(page_id, true);
+      }
+      ZipfianGenerator zipf(NUM_PAGES, THETA, 7);
+      for (size_t i = 0; i < fetches_per_window_ * NUM_WINDOWS * 4; i++) {
+        auto page_id = static_cast<page_id_t>(zipf.Next());
+        bpm.FetchPage(page_id);
+        bpm.UnpinPage(page_id, false);
+      }
+      bpm.FlushAllPages();
+      bpm.DumpResidentPages(dump_name);
+    }
+
+    std::printf("pool=%zu pages=%zu fetches_per_window=%zu read_latency=%lldus\n", POOL_SIZE, NUM_PAGES,
+                fetches_per_window_, static_cast<long long>(read_latency_.count()));  // NOLINT
+    std::printf("%8s %12s %8s %12s %12s\n", "restart", "reload ms", "window", "hit ratio", "fetches/s");
+    disk_manager.SetProfile({read_latency_});
+    RunOne(&disk_manager, "cold", "");
+    RunOne(&disk_manager, "warm", dump_name);
+
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove(dump_name.c_str());
+    std::remove("warm_restart_benchmark.log");
+  }
+
+ private:
+  void RunOne(DiskManager *disk_manager, const char *name, const std::string &dump_name) {
+    BufferPoolManagerInstance bpm(POOL_SIZE, disk_manager);
+    auto start = std::chrono::steady_clock::now();
+    if (!dump_name.empty()) {
+      bpm.LoadResidentPages(dump_name);
+    }
+    std::chrono::duration<double, std::milli> reload = std::chrono::steady_clock::now() - start;
+
+    // A different seed than the warm-up run: the same hot set, but not a replay of the same sequence.
+    ZipfianGenerator zipf(NUM_PAGES, THETA, 42);
+    for (size_t window = 0; window < NUM_WINDOWS; window++) {
+      BufferPoolMetricsSnapshot before = bpm.GetMetrics();
+      start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < fetches_per_window_; i++) {
+        auto page_id = static_cast<page_id_t>(zipf.Next());
+        bpm.FetchPage(page_id);
+        bpm.UnpinPage(page_id, false);
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::printf("%8s %12.1f %8zu %12.4f %12.0f\n", name, window == 0 ? reload.count() : 0.0, window,
+                  bpm.GetMetrics().Diff(before).HitRatio(), static_cast<double>(fetches_per_window_) / elapsed.count());
+    }
+  }
+
+  size_t fetches_per_window_;
+  std::chrono::microseconds read_latency_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t fetches_per_window = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+  size_t read_latency_us = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+  bustub::WarmRestartBenchmark(fetches_per_window, read_latency_us).Run();
+  return 0;
+}
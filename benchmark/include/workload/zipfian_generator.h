@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zipfian_generator.h
+//
+// Identification: benchmark/include/workload/zipfian_generator.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace bustub {
+
+/**
+ * ZipfianGenerator draws integers in [0, num_items) where item i is drawn with probability proportional to
+ * 1 / (i + 1)^theta, using the rejection-free method of Gray et al., "Quickly Generating Billion-Record Synthetic
+ * Databases" (the same generator YCSB uses). Item 0 is the most popular.
+ */
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(uint64_t num_items, double theta = 0.99, uint64_t seed = 0)
+      : num_items_(num_items), theta_(theta), rng_(seed) {
+    zeta_n_ = Zeta(num_items_, theta_);
+    const double zeta_2 = Zeta(2, theta_);
+    alpha_ = 1.0 / (1.0 - theta_);
+    eta_ = (1.0 - std::pow(2.0 / static_cast<double>(num_items_), 1.0 - theta_)) / (1.0 - zeta_2 / zeta_n_);
+  }
+
+  uint64_t Next() {
+    const double u = uniform_(rng_);
+    const double uz = u * zeta_n_;
+    if (uz < 1.0) {
+      return 0;
+    }
+    if (uz < 1.0 + std::pow(0.5, theta_)) {
+      return 1;
+    }
+    auto item = static_cast<uint64_t>(static_cast<double>(num_items_) * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+    return item < num_items_ ? item : num_items_ - 1;
+  }
+
+ private:
+  static double Zeta(uint64_t n, double theta) {
+    double sum = 0;
+    for (uint64_t i = 1; i <= n; i++) {
+      sum += 1.0 / std::pow(static_cast<double>(i), theta);
+    }
+    return sum;
+  }
+
+  uint64_t num_items_;
+  double theta_;
+  double zeta_n_;
+  double alpha_;
+  double eta_;
+  std::mt19937_64 rng_;
+  std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// direct_io_benchmark.cpp
+//
+// Identification: benchmark/storage/direct_io_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "workload/zipfian_generator.h"
+
+namespace bustub {
+
+/**
+ * Compares buffered and direct I/O under the same memory budget. A zipfian read workload runs first over a buffered
+ * disk manager, after which the benchmark counts the pages of the db file that the kernel kept in its page cache. Most
+ * of them are copies of pages that the buffer pool holds as well. The same workload then runs over a direct disk
+ * manager whose buffer pool gets the frames of the first pool plus one frame per page cache page, so both runs use
+ * the same memory. The page cache is dropped before each run, and device reads are taken from /proc/self/io.
+ *
+ * Usage: direct_io_benchmark [num_pages] [pool_size] [fetches]
+ */
+class DirectIOBenchmark {
+ public:
+  DirectIOBenchmark(size_t num_pages, size_t pool_size, size_t fetches)
+      : num_pages_(num_pages), pool_size_(pool_size), fetches_(fetches) {}
+
+  void Run() {
+    {
+      DiskManager disk_manager(db_name_);
+      std::vector<char> data(PAGE_SIZE);
+      for (size_t i = 0; i < num_pages_; i++) {
+        snprintf(data.data(), PAGE_SIZE, "page %zu", i);
+        disk_manager.WritePage(static_cast<page_id_t>(i), data.data());
+      }
+      disk_manager.Sync();
+      disk_manager.ShutDown();
+    }
+
+    std::printf("pages=%zu fetches=%zu\n", num_pages_, fetches_);
+    std::printf("%10s %10s %12s %12s %10s %14s %12s\n", "mode", "pool", "page cache", "memory", "hit", "device reads",
+                "fetches/s");
+    size_t cached = RunOne(false, pool_size_);
+    RunOne(true, pool_size_ + cached);
+
+    std::remove(db_name_.c_str());
+    std::remove("direct_io_benchmark.log");
+  }
+
+ private:
+  /** @return the number of pages of the db file in the page cache after the run */
+  size_t RunOne(bool direct_io, size_t pool_size) {
+    DropPageCache();
+    DiskManager disk_manager(db_name_, direct_io);
+    BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+    ZipfianGenerator zipf(num_pages_, 0.99, 42);
+
+    uint64_t device_reads = ReadBytes();
+    auto start = std::chrono::steady_clock::now();
+    auto before = bpm.GetMetrics();
+    for (size_t i = 0; i < fetches_; i++) {
+      // Scatter the popular pages over the file, so that readahead does not bring in their neighbours for free.
+      auto page_id = static_cast<page_id_t>((zipf.Next() * 7919) % num_pages_);
+      bpm.FetchPage(page_id);
+      bpm.UnpinPage(page_id, false);
+    }
+    auto metrics = bpm.GetMetrics().Diff(before);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    device_reads = (ReadBytes() - device_reads) / PAGE_SIZE;
+
+    size_t cached = CachedPages();
+    std::printf("%10s %10zu %12zu %12zu %10.4f %14lu %12.0f\n", disk_manager.IsDirectIO() ? "direct" : "buffered",
+                pool_size, cached, pool_size + cached, metrics.HitRatio(), device_reads,
+                static_cast<double>(fetches_) / seconds);
+    disk_manager.ShutDown();
+    return cached;
+  }
+
+  void DropPageCache() {
+    int fd = open(db_name_.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+    }
+  }
+
+  /** @return the number of pages of the db file that are in the page cache */
+  size_t CachedPages() {
+    int fd = open(db_name_.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return 0;
+    }
+    size_t length = num_pages_ * PAGE_SIZE;
+    void *map = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+      return 0;
+    }
+    size_t os_page_size = sysconf(_SC_PAGESIZE);
+    std::vector<unsigned char> resident((length + os_page_size - 1) / os_page_size);
+    size_t cached = 0;
+    if (mincore(map, length, resident.data()) == 0) {
+      for (unsigned char r : resident) {
+        cached += r & 1;
+      }
+    }
+    munmap(map, length);
+    return cached * os_page_size / PAGE_SIZE;
+  }
+
+  /** @return the bytes this process has read from block devices so far */
+  static uint64_t ReadBytes() {
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    uint64_t value;
+    while (io >> key >> value) {
+      if (key == "read_bytes:") {
+        return value;
+      }
+    }
+    return 0;
+  }
+
+  const std::string db_name_{"direct_io_benchmark.db"};
+  size_t num_pages_;
+  size_t pool_size_;
+  size_t fetches_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_pages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 65536;
+  size_t pool_size = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096;
+  size_t fetches = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 200000;
+  bustub::DirectIOBenchmark(num_pages, pool_size, fetches).Run();
+  return 0;
+}
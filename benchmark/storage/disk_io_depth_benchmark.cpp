@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_io_depth_benchmark.cpp
+//
+// Identification: benchmark/storage/disk_io_depth_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Measures random page reads through the asynchronous disk manager backends at several queue depths, like a fio job
+ * with ioengine=io_uring, or ioengine=psync with numjobs=iodepth. A single thread keeps depth reads in flight, and
+ * submits the next reads as earlier ones complete. The file is dropped from the page cache before every run, so the
+ * reads go to the device.
+ *
+ * Usage: disk_io_depth_benchmark [num_pages] [reads_per_run]
+ */
+class DiskIODepthBenchmark {
+ public:
+  DiskIODepthBenchmark(size_t num_pages, size_t reads_per_run) : num_pages_(num_pages), reads_per_run_(reads_per_run) {}
+
+  void Run() {
+    {
+      DiskManager disk_manager(db_name_);
+      std::vector<char> data(PAGE_SIZE);
+      for (size_t i = 0; i < num_pages_; i++) {
+        snprintf(data.data(), PAGE_SIZE, "page %zu", i);
+        disk_manager.WritePage(static_cast<page_id_t>(i), data.data());
+      }
+      disk_manager.Sync();
+      disk_manager.ShutDown();
+    }
+
+    std::printf("pages=%zu reads_per_run=%zu\n", num_pages_, reads_per_run_);
+    std::printf("%10s %8s %12s %12s\n", "backend", "depth", "IOPS", "MB/s");
+    for (bool use_io_uring : {true, false}) {
+      disk_manager_use_io_uring = use_io_uring;
+      for (size_t depth : {1, 2, 4, 8, 16, 32, 64}) {
+        RunOne(depth);
+      }
+    }
+    disk_manager_use_io_uring = true;
+
+    std::remove(db_name_.c_str());
+    std::remove("disk_io_depth_benchmark.log");
+  }
+
+ private:
+  void RunOne(size_t depth) {
+    DropPageCache();
+    DiskManager disk_manager(db_name_);
+    const char *backend = disk_manager.UsesIoUring() ? "io_uring" : "threads";
+    std::vector<char> buffers(depth * PAGE_SIZE);
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(num_pages_) - 1);
+
+    // Completions only record which buffer is free again; the benchmark thread submits the next reads.
+    std::mutex latch;
+    std::condition_variable cv;
+    std::vector<size_t> free_slots;
+    for (size_t slot = 0; slot < depth; slot++) {
+      free_slots.push_back(slot);
+    }
+    size_t num_submitted = 0;
+    size_t num_completed = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<DiskRequest> requests;
+    std::unique_lock lock{latch};
+    while (num_completed < reads_per_run_) {
+      cv.wait(lock, [&] { return !free_slots.empty() || num_completed == reads_per_run_; });
+      for (size_t slot : free_slots) {
+        if (num_submitted == reads_per_run_) {
+          break;
+        }
+        requests.push_back({false, dist(rng), &buffers[slot * PAGE_SIZE], [&, slot](bool) {
+                              std::scoped_lock completion_lock{latch};
+                              free_slots.push_back(slot);
+                              num_completed++;
+                              cv.notify_one();
+                            }});
+        num_submitted++;
+      }
+      free_slots.clear();
+      lock.unlock();
+      disk_manager.Submit(&requests);
+      lock.lock();
+    }
+    lock.unlock();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double iops = static_cast<double>(reads_per_run_) / seconds;
+    std::printf("%10s %8zu %12.0f %12.1f\n", backend, depth, iops, iops * PAGE_SIZE / (1024 * 1024));
+    disk_manager.ShutDown();
+  }
+
+  void DropPageCache() {
+    int fd = open(db_name_.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+    }
+  }
+
+  const std::string db_name_{"disk_io_depth_benchmark.db"};
+  size_t num_pages_;
+  size_t reads_per_run_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_pages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 65536;
+  size_t reads_per_run = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+  bustub::DiskIODepthBenchmark(num_pages, reads_per_run).Run();
+  return 0;
+}
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_read_benchmark.cpp
+//
+// Identification: benchmark/storage/disk_manager_read_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Measures the throughput of random page reads straight from the disk manager with a growing number of threads. The
+ * file mostly sits in the page cache, so this measures how well concurrent reads scale rather than the device.
+ *
+ * Usage: disk_manager_read_benchmark [num_pages] [reads_per_thread]
+ */
+class DiskManagerReadBenchmark {
+ public:
+  DiskManagerReadBenchmark(size_t num_pages, size_t reads_per_thread)
+      : num_pages_(num_pages), reads_per_thread_(reads_per_thread) {}
+
+  void Run() {
+    const std::string db_name = "disk_manager_read_benchmark.db";
+    DiskManager disk_manager(db_name);
+    char data[PAGE_SIZE];
+    for (size_t i = 0; i < num_pages_; i++) {
+      memset(data, static_cast<int>(i), PAGE_SIZE);
+      disk_manager.WritePage(static_cast<page_id_t>(i), data);
+    }
+    disk_manager.Sync();
+
+    std::printf("pages=%zu reads_per_thread=%zu\n", num_pages_, reads_per_thread_);
+    std::printf("%10s %12s %14s\n", "threads", "time (ms)", "reads/s");
+    for (size_t num_threads : {1, 2, 4, 8, 16}) {
+      auto start = std::chrono::steady_clock::now();
+      std::vector<std::thread> threads;
+      for (size_t tid = 0; tid < num_threads; tid++) {
+        threads.emplace_back([&, tid] {
+          std::mt19937 rng(tid);
+          std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(num_pages_) - 1);
+          char buffer[PAGE_SIZE];
+          for (size_t i = 0; i < reads_per_thread_; i++) {
+            disk_manager.ReadPage(dist(rng), buffer);
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      std::printf("%10zu %12.1f %14.0f\n", num_threads, ms,
+                  static_cast<double>(num_threads * reads_per_thread_) * 1000.0 / ms);
+    }
+
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove("disk_manager_read_benchmark.log");
+  }
+
+ private:
+  size_t num_pages_;
+  size_t reads_per_thread_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_pages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16384;
+  size_t reads_per_thread = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+  bustub::DiskManagerReadBenchmark(num_pages, reads_per_thread).Run();
+  return 0;
+}
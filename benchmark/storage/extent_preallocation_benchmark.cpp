@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent_preallocation_benchmark.cpp
+//
+// Identification: benchmark/storage/extent_preallocation_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fcntl.h>
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+namespace bustub {
+
+/**
+ * Measures bulk loading and scanning with and without extent preallocation. Two tables, each in its own db file, are
+ * loaded at the same time through small buffer pools, with a checkpoint every few batches, so that the file system
+ * allocates blocks for both files in turns. This runs with buffered I/O, where the delayed allocation of the file
+ * system can still group the blocks of a file, and with direct I/O, where blocks are allocated as they are written.
+ * The benchmark reports the load throughput and the number of physically contiguous pieces that the first file ends
+ * up in, and then scans it with a cold page cache, reading runs of consecutive pages like a table scan with
+ * read-ahead does.
+ *
+ * Usage: extent_preallocation_benchmark [pages_per_table] [pages_per_checkpoint]
+ */
+class ExtentPreallocationBenchmark {
+ public:
+  static constexpr size_t POOL_SIZE = 64;
+  static constexpr size_t BATCH_PAGES = 16;
+  static constexpr size_t SCAN_RUN_PAGES = 32;
+
+  ExtentPreallocationBenchmark(size_t pages_per_table, size_t pages_per_checkpoint)
+      : pages_per_table_(pages_per_table), pages_per_checkpoint_(pages_per_checkpoint) {}
+
+  void Run() {
+    std::printf("pages_per_table=%zu pages_per_checkpoint=%zu\n", pages_per_table_, pages_per_checkpoint_);
+    std::printf("%8s %14s %14s %10s %14s\n", "io", "extent pages", "load pages/s", "fragments", "scan MB/s");
+    for (bool direct_io : {false, true}) {
+      for (size_t extent_pages : {1, 16, 256}) {
+        disk_manager_extent_pages = extent_pages;
+        RunOne(direct_io);
+      }
+    }
+    disk_manager_extent_pages = 256;
+  }
+
+ private:
+  void RunOne(bool direct_io) {
+    for (const auto &db_name : db_names_) {
+      std::remove(db_name.c_str());
+    }
+    std::vector<std::unique_ptr<DiskManager>> disk_managers;
+    std::vector<std::unique_ptr<BufferPoolManagerInstance>> bpms;
+    for (const auto &db_name : db_names_) {
+      disk_managers.push_back(std::make_unique<DiskManager>(db_name, direct_io));
+      bpms.push_back(std::make_unique<BufferPoolManagerInstance>(POOL_SIZE, disk_managers.back().get()));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t loaded = 0; loaded < pages_per_table_; loaded += BATCH_PAGES) {
+      for (auto &bpm : bpms) {
+        for (size_t i = 0; i < BATCH_PAGES; i++) {
+          page_id_t page_id;
+          Page *page = bpm->NewPage(&page_id);
+          snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+          bpm->UnpinPage(page_id, true);
+        }
+        if ((loaded + BATCH_PAGES) % pages_per_checkpoint_ == 0) {
+          bpm->FlushAllPages();
+        }
+      }
+    }
+    for (auto &bpm : bpms) {
+      bpm->FlushAllPages();
+    }
+    double load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    bpms.clear();
+    for (auto &disk_manager : disk_managers) {
+      disk_manager->ShutDown();
+    }
+    disk_managers.clear();
+
+    const size_t fragments = CountFragments(db_names_[0]);
+    const double scan_seconds = Scan(db_names_[0]);
+    std::printf("%8s %14zu %14.0f %10zu %14.1f\n", direct_io ? "direct" : "buffered", disk_manager_extent_pages,
+                static_cast<double>(pages_per_table_ * db_names_.size()) / load_seconds, fragments,
+                static_cast<double>(pages_per_table_ * PAGE_SIZE) / (1024 * 1024) / scan_seconds);
+
+    for (const auto &db_name : db_names_) {
+      std::remove(db_name.c_str());
+      std::remove((db_name.substr(0, db_name.find('.')) + ".log").c_str());
+    }
+  }
+
+  /** @return the seconds a cold scan of the table in db_name takes */
+  double Scan(const std::string &db_name) {
+    int fd = open(db_name.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+    }
+    DiskManager disk_manager(db_name);
+    std::vector<char> data(SCAN_RUN_PAGES * PAGE_SIZE);
+    std::vector<char *> pages_data;
+    for (size_t i = 0; i < SCAN_RUN_PAGES; i++) {
+      pages_data.push_back(&data[i * PAGE_SIZE]);
+    }
+    std::vector<page_id_t> page_ids(SCAN_RUN_PAGES);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t first = 0; first < pages_per_table_; first += SCAN_RUN_PAGES) {
+      for (size_t i = 0; i < SCAN_RUN_PAGES; i++) {
+        page_ids[i] = static_cast<page_id_t>(first + i);
+      }
+      disk_manager.ReadPages(page_ids.data(), pages_data.data(), SCAN_RUN_PAGES);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    disk_manager.ShutDown();
+    return seconds;
+  }
+
+  /**
+   * @return the number of physically contiguous pieces the file is stored in, from its FIEMAP extents, or 0 if the
+   * file system cannot tell. Extents that continue where the previous one ended count as one piece.
+   */
+  static size_t CountFragments(const std::string &file_name) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return 0;
+    }
+    constexpr size_t max_extents = 4096;
+    std::vector<char> buffer(sizeof(struct fiemap) + max_extents * sizeof(struct fiemap_extent));
+    auto *fiemap = reinterpret_cast<struct fiemap *>(buffer.data());
+    size_t fragments = 0;
+    uint64_t logical = 0;
+    uint64_t physical_end = ~uint64_t{0};
+    bool last = false;
+    while (!last) {
+      memset(buffer.data(), 0, buffer.size());
+      fiemap->fm_start = logical;
+      fiemap->fm_length = ~uint64_t{0} - logical;
+      fiemap->fm_flags = FIEMAP_FLAG_SYNC;
+      fiemap->fm_extent_count = max_extents;
+      if (ioctl(fd, FS_IOC_FIEMAP, fiemap) != 0 || fiemap->fm_mapped_extents == 0) {
+        break;
+      }
+      for (size_t i = 0; i < fiemap->fm_mapped_extents; i++) {
+        const struct fiemap_extent &extent = fiemap->fm_extents[i];
+        fragments += extent.fe_physical == physical_end ? 0 : 1;
+        physical_end = extent.fe_physical + extent.fe_length;
+        logical = extent.fe_logical + extent.fe_length;
+        last = (extent.fe_flags & FIEMAP_EXTENT_LAST) != 0;
+      }
+    }
+    close(fd);
+    return fragments;
+  }
+
+  const std::vector<std::string> db_names_{"extent_benchmark_a.db", "extent_benchmark_b.db"};
+  size_t pages_per_table_;
+  size_t pages_per_checkpoint_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t pages_per_table = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 32768;
+  size_t pages_per_checkpoint = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+  bustub::ExtentPreallocationBenchmark(pages_per_table, pages_per_checkpoint).Run();
+  return 0;
+}
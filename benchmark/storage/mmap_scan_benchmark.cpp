@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mmap_scan_benchmark.cpp
+//
+// Identification: benchmark/storage/mmap_scan_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/mmap_disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Compares full scans of a table on a read-only replica through the pread disk manager, through the mmap disk manager
+ * with a copy into the frame, and through the mmap disk manager with zero-copy frames. Every scan fetches all pages in
+ * order through a small buffer pool with a scan ring, and sums a byte of each, as a filter would look at its tuples.
+ * Each mode scans once with the file dropped from the page cache (cold) and then again with the file cached (warm).
+ * The mmap modes advise the mapping as sequential.
+ *
+ * Usage: mmap_scan_benchmark [num_pages] [pool_size]
+ */
+class MmapScanBenchmark {
+ public:
+  MmapScanBenchmark(size_t num_pages, size_t pool_size) : num_pages_(num_pages), pool_size_(pool_size) {}
+
+  void Run() {
+    {
+      DiskManager disk_manager(db_name_);
+      std::vector<char> data(PAGE_SIZE);
+      for (size_t i = 0; i < num_pages_; i++) {
+        snprintf(data.data(), PAGE_SIZE, "page %zu", i);
+        disk_manager.AllocatePage();
+        disk_manager.WritePage(static_cast<page_id_t>(i), data.data());
+      }
+      disk_manager.Sync();
+      disk_manager.ShutDown();
+    }
+
+    std::printf("pages=%zu pool=%zu\n", num_pages_, pool_size_);
+    std::printf("%10s %10s %12s %12s\n", "mode", "cache", "seconds", "MB/s");
+    for (const char *mode : {"pread", "mmap", "zero-copy"}) {
+      DropPageCache();
+      RunOne(mode, "cold");
+      RunOne(mode, "warm");
+    }
+
+    std::remove(db_name_.c_str());
+    std::remove("mmap_scan_benchmark.log");
+  }
+
+ private:
+  void RunOne(const std::string &mode, const char *cache) {
+    std::unique_ptr<DiskManager> disk_manager;
+    if (mode == "pread") {
+      disk_manager = std::make_unique<DiskManager>(db_name_);
+    } else {
+      disk_manager = std::make_unique<MmapDiskManager>(db_name_, MmapAdvice::SEQUENTIAL);
+    }
+    buffer_pool_zero_copy = mode == "zero-copy";
+    BufferPoolManagerInstance bpm(pool_size_, disk_manager.get());
+    BufferAccessStrategy strategy;
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < num_pages_; i++) {
+      auto page_id = static_cast<page_id_t>(i);
+      Page *page = bpm.FetchPage(page_id, &strategy);
+      for (size_t offset = 0; offset < PAGE_SIZE; offset += 64) {
+        checksum += static_cast<unsigned char>(page->GetData()[offset]);
+      }
+      bpm.UnpinPage(page_id, false);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%10s %10s %12.4f %12.1f\n", mode.c_str(), cache, seconds,
+                static_cast<double>(num_pages_ * PAGE_SIZE) / (1024 * 1024) / seconds);
+    // Keep the scan from being optimized away.
+    if (checksum == 1) {
+      std::printf("checksum %lu\n", checksum);
+    }
+    buffer_pool_zero_copy = false;
+  }
+
+  void DropPageCache() {
+    int fd = open(db_name_.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+    }
+  }
+
+  const std::string db_name_{"mmap_scan_benchmark.db"};
+  size_t num_pages_;
+  size_t pool_size_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_pages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 65536;
+  size_t pool_size = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+  bustub::MmapScanBenchmark(num_pages, pool_size).Run();
+  return 0;
+}
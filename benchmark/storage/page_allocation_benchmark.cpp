@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_allocation_benchmark.cpp
+//
+// Identification: benchmark/storage/page_allocation_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Measures the size of the db file and the layout of tables under churn. A set of tables, each a chain of pages, is
+ * built one after the other. Then, at every step, a random table either grows by a few pages or has a few pages cut
+ * off its end, so that the live data stays about the same size while pages are freed and allocated all the time. New
+ * pages are allocated either with the last page of their table as a hint or without a hint.
+ *
+ * The benchmark reports the file size, the number of pages an append-only allocator would have handed out, and the
+ * fraction of neighbouring pages of a table that are also neighbours in the file, which is what a table scan can read
+ * sequentially.
+ *
+ * Usage: page_allocation_benchmark [num_tables] [steps]
+ */
+class PageAllocationBenchmark {
+ public:
+  static constexpr size_t INITIAL_TABLE_PAGES = 64;
+  static constexpr size_t MAX_BATCH_PAGES = 32;
+
+  PageAllocationBenchmark(size_t num_tables, size_t steps) : num_tables_(num_tables), steps_(steps) {}
+
+  void Run() {
+    std::printf("tables=%zu initial_pages_per_table=%zu steps=%zu\n", num_tables_, INITIAL_TABLE_PAGES, steps_);
+    std::printf("%8s %8s %12s %12s %14s %12s\n", "hints", "step", "live pages", "file pages", "append-only",
+                "sequential");
+    RunOne(false);
+    RunOne(true);
+  }
+
+ private:
+  void RunOne(bool hints) {
+    std::remove(db_name_.c_str());
+    DiskManager disk_manager(db_name_);
+    std::vector<char> data(PAGE_SIZE);
+    std::vector<std::vector<page_id_t>> tables(num_tables_);
+    size_t num_allocations = 0;
+    auto append = [&](std::vector<page_id_t> *table) {
+      page_id_t near_page_id = hints && !table->empty() ? table->back() : INVALID_PAGE_ID;
+      page_id_t page_id = disk_manager.AllocatePage(near_page_id);
+      disk_manager.WritePage(page_id, data.data());
+      table->push_back(page_id);
+      num_allocations++;
+    };
+
+    for (auto &table : tables) {
+      for (size_t i = 0; i < INITIAL_TABLE_PAGES; i++) {
+        append(&table);
+      }
+    }
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<size_t> table_dist(0, num_tables_ - 1);
+    std::uniform_int_distribution<size_t> batch_dist(1, MAX_BATCH_PAGES);
+    for (size_t step = 1; step <= steps_; step++) {
+      auto &table = tables[table_dist(rng)];
+      size_t batch = batch_dist(rng);
+      // Tables random-walk between empty and twice their initial size.
+      if ((rng() % 2 == 0 && table.size() + batch <= 2 * INITIAL_TABLE_PAGES) || table.size() <= batch) {
+        for (size_t i = 0; i < batch; i++) {
+          append(&table);
+        }
+      } else {
+        for (size_t i = 0; i < batch; i++) {
+          disk_manager.DeallocatePage(table.back());
+          table.pop_back();
+        }
+      }
+      if (step % (steps_ / 5) == 0) {
+        Report(hints, step, tables, num_allocations);
+      }
+    }
+    disk_manager.ShutDown();
+    std::remove(db_name_.c_str());
+    std::remove("page_allocation_benchmark.log");
+  }
+
+  void Report(bool hints, size_t step, const std::vector<std::vector<page_id_t>> &tables, size_t num_allocations) {
+    size_t live_pages = 0;
+    size_t pairs = 0;
+    size_t sequential = 0;
+    for (const auto &table : tables) {
+      live_pages += table.size();
+      for (size_t i = 1; i < table.size(); i++) {
+        pairs++;
+        sequential += table[i] == table[i - 1] + 1 ? 1 : 0;
+      }
+    }
+    struct stat stat_buf;
+    size_t file_pages = stat(db_name_.c_str(), &stat_buf) == 0 ? stat_buf.st_size / PAGE_SIZE : 0;
+    std::printf("%8s %8zu %12zu %12zu %14zu %12.4f\n", hints ? "near" : "none", step, live_pages, file_pages,
+                num_allocations, static_cast<double>(sequential) / pairs);
+  }
+
+  const std::string db_name_{"page_allocation_benchmark.db"};
+  size_t num_tables_;
+  size_t steps_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_tables = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 32;
+  size_t steps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+  bustub::PageAllocationBenchmark(num_tables, steps).Run();
+  return 0;
+}
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compression_benchmark.cpp
+//
+// Identification: benchmark/storage/page_compression_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/stat.h>
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/transaction.h"
+#include "storage/disk/compressed_disk_manager.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * Measures how well table pages compress in the CompressedDiskManager, and what the compression costs. The pages are
+ * those of two table heaps shaped like the test tables of TableGenerator, loaded round by round. All of them are then
+ * written to a plain and to a compressed disk manager, followed by a Sync, and read back, with the files in the page
+ * cache. The benchmark reports the bytes written per page, the size of the files and the throughput in uncompressed
+ * MB/s.
+ *
+ * Usage: page_compression_benchmark [rounds]
+ */
+class PageCompressionBenchmark {
+ public:
+  explicit PageCompressionBenchmark(size_t rounds) : rounds_(rounds) {}
+
+  void Run() {
+    Generate();
+    std::printf("pages=%zu\n", pages_.size() / PAGE_SIZE);
+    std::printf("%12s %14s %12s %10s %12s %12s\n", "format", "bytes/page", "file KiB", "ratio", "write MB/s",
+                "read MB/s");
+    RunOne(false);
+    RunOne(true);
+  }
+
+ private:
+  /**
+   * Loads the tables and keeps a copy of every page. The tables have the columns and value distributions of the
+   * test_1 and test_2 tables of TableGenerator, whose catalog this tree cannot create, and get 1000 and 100 rows per
+   * round, in turns.
+   */
+  void Generate() {
+    const std::string db_name = "page_compression_source.db";
+    std::remove(db_name.c_str());
+    DiskManager disk_manager(db_name);
+    BufferPoolManagerInstance bpm(1024, &disk_manager);
+    Transaction txn(0);
+    Schema schema_1{std::vector<Column>{Column{"colA", TypeId::INTEGER}, Column{"colB", TypeId::INTEGER},
+                                        Column{"colC", TypeId::INTEGER}, Column{"colD", TypeId::INTEGER}}};
+    Schema schema_2{std::vector<Column>{Column{"col1", TypeId::SMALLINT}, Column{"col2", TypeId::INTEGER},
+                                        Column{"col3", TypeId::BIGINT}, Column{"col4", TypeId::INTEGER}}};
+    TableHeap table_1(&bpm, nullptr, nullptr, &txn);
+    TableHeap table_2(&bpm, nullptr, nullptr, &txn);
+    table_1.SetReadAheadWindow(0);
+    table_2.SetReadAheadWindow(0);
+
+    std::mt19937 rng(7);
+    auto uniform = [&](int64_t min, int64_t max) { return std::uniform_int_distribution<int64_t>(min, max)(rng); };
+    RID rid;
+    int32_t serial_1 = 0;
+    int16_t serial_2 = 0;
+    for (size_t round = 0; round < rounds_; round++) {
+      for (int i = 0; i < 1000; i++) {
+        Tuple tuple{std::vector<Value>{ValueFactory::GetIntegerValue(serial_1++),
+                                       ValueFactory::GetIntegerValue(static_cast<int32_t>(uniform(0, 9))),
+                                       ValueFactory::GetIntegerValue(static_cast<int32_t>(uniform(0, 9999))),
+                                       ValueFactory::GetIntegerValue(static_cast<int32_t>(uniform(0, 99999)))},
+                    &schema_1};
+        table_1.InsertTuple(tuple, &rid, &txn);
+      }
+      for (int i = 0; i < 100; i++) {
+        Tuple tuple{std::vector<Value>{ValueFactory::GetSmallIntValue(serial_2++),
+                                       ValueFactory::GetIntegerValue(static_cast<int32_t>(uniform(0, 9))),
+                                       ValueFactory::GetBigIntValue(uniform(0, 1024)),
+                                       ValueFactory::GetIntegerValue(static_cast<int32_t>(uniform(0, 2048)))},
+                    &schema_2};
+        table_2.InsertTuple(tuple, &rid, &txn);
+      }
+    }
+    bpm.FlushAllPages();
+
+    std::vector<char> data(PAGE_SIZE);
+    for (page_id_t page_id = 0; disk_manager.IsPageAllocated(page_id); page_id++) {
+      disk_manager.ReadPage(page_id, data.data());
+      pages_.insert(pages_.end(), data.begin(), data.end());
+    }
+    disk_manager.ShutDown();
+    std::remove(db_name.c_str());
+    std::remove("page_compression_source.log");
+  }
+
+  void RunOne(bool compressed) {
+    const std::string db_name = "page_compression_benchmark.db";
+    const std::vector<std::string> file_names = {db_name, "page_compression_benchmark.zdb"};
+    for (const auto &file_name : file_names) {
+      std::remove(file_name.c_str());
+    }
+    std::unique_ptr<DiskManager> disk_manager;
+    if (compressed) {
+      disk_manager = std::make_unique<CompressedDiskManager>(db_name);
+    } else {
+      disk_manager = std::make_unique<DiskManager>(db_name);
+    }
+    const size_t num_pages = pages_.size() / PAGE_SIZE;
+    const double megabytes = static_cast<double>(pages_.size()) / (1024 * 1024);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_pages; i++) {
+      page_id_t page_id = disk_manager->AllocatePage();
+      disk_manager->WritePage(page_id, &pages_[i * PAGE_SIZE]);
+    }
+    disk_manager->Sync();
+    double write_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<char> data(PAGE_SIZE);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_pages; i++) {
+      disk_manager->ReadPage(static_cast<page_id_t>(i), data.data());
+    }
+    double read_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t bytes_written = pages_.size();
+    double ratio = 1.0;
+    if (compressed) {
+      auto *compressed_disk_manager = static_cast<CompressedDiskManager *>(disk_manager.get());
+      bytes_written = compressed_disk_manager->GetHeapBytesWritten();
+      ratio = compressed_disk_manager->GetCompressionRatio();
+    }
+    disk_manager->ShutDown();
+    size_t file_size = 0;
+    for (const auto &file_name : file_names) {
+      struct stat stat_buf;
+      file_size += stat(file_name.c_str(), &stat_buf) == 0 ? stat_buf.st_size : 0;
+    }
+    std::printf("%12s %14.0f %12zu %10.2f %12.1f %12.1f\n", compressed ? "compressed" : "plain",
+                static_cast<double>(bytes_written) / num_pages, file_size / 1024, ratio, megabytes / write_seconds,
+                megabytes / read_seconds);
+
+    disk_manager.reset();
+    for (const auto &file_name : file_names) {
+      std::remove(file_name.c_str());
+    }
+    std::remove("page_compression_benchmark.log");
+  }
+
+  size_t rounds_;
+  std::vector<char> pages_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100;
+  bustub::PageCompressionBenchmark(rounds).Run();
+  return 0;
+}
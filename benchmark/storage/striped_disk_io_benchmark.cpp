@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// striped_disk_io_benchmark.cpp
+//
+// Identification: benchmark/storage/striped_disk_io_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "storage/disk/striped_disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Measures a database striped over 1, 2 and 4 data files: concurrent random page reads, like the misses of several
+ * worker threads, and a write of every page followed by a Sync, like a checkpoint. The files are dropped from the
+ * page cache before the reads, so the reads go to the device. Striping pays off when the data files sit on separate
+ * devices; passing directories, e.g. mount points, as arguments puts one data file in each of them, in turns.
+ *
+ * Usage: striped_disk_io_benchmark [num_pages] [reads_per_thread] [dir...]
+ */
+class StripedDiskIOBenchmark {
+ public:
+  StripedDiskIOBenchmark(size_t num_pages, size_t reads_per_thread, std::vector<std::string> dirs)
+      : num_pages_(num_pages), reads_per_thread_(reads_per_thread), dirs_(std::move(dirs)) {}
+
+  void Run() {
+    std::printf("pages=%zu reads_per_thread=%zu\n", num_pages_, reads_per_thread_);
+    std::printf("%8s %8s %12s %12s\n", "files", "threads", "read IOPS", "write MB/s");
+    for (size_t num_files : {1, 2, 4}) {
+      for (size_t num_threads : {1, 8}) {
+        RunOne(num_files, num_threads);
+      }
+    }
+  }
+
+ private:
+  void RunOne(size_t num_files, size_t num_threads) {
+    std::vector<std::string> data_files;
+    for (size_t i = 0; i < num_files; i++) {
+      data_files.push_back(dirs_[i % dirs_.size()] + "/striped_disk_io_benchmark_" + std::to_string(i) + ".db");
+    }
+    RemoveFiles(data_files);
+
+    auto disk_manager = std::make_unique<StripedDiskManager>(db_name_, data_files);
+    std::vector<char> data(PAGE_SIZE);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_pages_; i++) {
+      page_id_t page_id = disk_manager->AllocatePage();
+      snprintf(data.data(), PAGE_SIZE, "page %d", page_id);
+      disk_manager->WritePage(page_id, data.data());
+    }
+    disk_manager->Sync();
+    double write_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    disk_manager->ShutDown();
+
+    for (const auto &file_name : data_files) {
+      DropPageCache(file_name);
+    }
+    disk_manager = std::make_unique<StripedDiskManager>(db_name_, data_files);
+    start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        std::mt19937 rng(t);
+        std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(num_pages_) - 1);
+        std::vector<char> buf(PAGE_SIZE);
+        for (size_t i = 0; i < reads_per_thread_; i++) {
+          disk_manager->ReadPage(dist(rng), buf.data());
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    double read_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    disk_manager->ShutDown();
+    disk_manager.reset();
+
+    std::printf("%8zu %8zu %12.0f %12.1f\n", num_files, num_threads,
+                static_cast<double>(num_threads * reads_per_thread_) / read_seconds,
+                static_cast<double>(num_pages_ * PAGE_SIZE) / (1024 * 1024) / write_seconds);
+    RemoveFiles(data_files);
+  }
+
+  void RemoveFiles(const std::vector<std::string> &data_files) {
+    std::remove(db_name_.c_str());
+    std::remove("striped_disk_io_benchmark.log");
+    for (const auto &file_name : data_files) {
+      std::remove(file_name.c_str());
+    }
+  }
+
+  void DropPageCache(const std::string &file_name) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+    }
+  }
+
+  const std::string db_name_{"striped_disk_io_benchmark.db"};
+  size_t num_pages_;
+  size_t reads_per_thread_;
+  std::vector<std::string> dirs_;
+};
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_pages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 32768;
+  size_t reads_per_thread = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+  std::vector<std::string> dirs;
+  for (int i = 3; i < argc; i++) {
+    dirs.emplace_back(argv[i]);
+  }
+  if (dirs.empty()) {
+    dirs.emplace_back(".");
+  }
+  bustub::StripedDiskIOBenchmark(num_pages, reads_per_thread, dirs).Run();
+  return 0;
+}
@@ -0,0 +1,1125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance.cpp
+//
+// Identification: src/buffer/buffer_pool_manager_instance.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <new>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/disk/write_scheduler.h"
+
+namespace bustub {
+
+/** Header of the side file that holds the resident page set, followed by num_pages_ page ids. */
+struct WarmRestartHeader {
+  uint32_t magic_;
+  uint32_t num_pages_;
+};
+
+static constexpr uint32_t WARM_RESTART_MAGIC = 0x52575042;  // "BPWR"
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager, replacer_type) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, LogManager *log_manager,
+                                                     ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      frame_arena_(pool_size, buffer_pool_use_huge_pages, buffer_pool_max_frames),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      page_table_(pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(instance_index < num_instances,
+                "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should "
+                "just be 0.");
+  // The frame data lives in the arena; the descriptors are allocated separately so that their hot fields do not share
+  // cache lines or TLB entries with the data. Like the arena, the descriptor array is reserved for the maximum size.
+  void *descriptors = mmap(nullptr, frame_arena_.GetMaxFrames() * sizeof(Page), PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (descriptors == MAP_FAILED) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot map the page descriptors of a buffer pool.");
+  }
+  pages_ = static_cast<Page *>(descriptors);
+  for (size_t i = 0; i < pool_size_; ++i) {
+    new (&pages_[i]) Page(frame_arena_.GetFrame(static_cast<frame_id_t>(i)));
+  }
+  num_descriptors_ = pool_size_;
+  if (buffer_pool_compressed_cache_size > 0) {
+    compressed_cache_ = std::make_unique<CompressedPageCache>(buffer_pool_compressed_cache_size);
+  }
+  switch (replacer_type) {
+    case ReplacerType::CLOCK:
+      replacer_ = new ClockReplacer(pool_size, frame_arena_.GetMaxFrames());
+      break;
+    case ReplacerType::LRU_K:
+      replacer_ = new LRUKReplacer(pool_size, LRUK_REPLACER_K, frame_arena_.GetMaxFrames());
+      break;
+  }
+
+  // Initially, every page is in the free list.
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].pin_count_ = FRAME_FREE;
+    free_list_.emplace_back(static_cast<int>(i));
+  }
+}
+
+BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopWarmRestart();
+  StopBackgroundWriter();
+  {
+    std::scoped_lock latch{latch_};
+    prefetch_stop_ = true;
+  }
+  prefetch_cv_.notify_all();
+  if (prefetch_thread_.joinable()) {
+    prefetch_thread_.join();
+  }
+  {
+    // Reads that the prefetch thread submitted publish their pages when they complete.
+    std::unique_lock latch{latch_};
+    prefetch_done_cv_.wait(latch, [&] { return prefetch_in_flight_.empty(); });
+  }
+  // Write back what is still dirty, so that closing the database loses nothing; the disk manager must outlive the
+  // pool. A clean pool skips the flush, and with it the Sync.
+  bool dirty = false;
+  {
+    std::scoped_lock latch{latch_};
+    page_table_.ForEach([&](page_id_t, frame_id_t frame_id) { dirty = dirty || pages_[frame_id].is_dirty_; });
+  }
+  if (dirty) {
+    FlushAllPagesImpl();
+  }
+  for (size_t i = 0; i < num_descriptors_; ++i) {
+    pages_[i].~Page();
+  }
+  munmap(pages_, frame_arena_.GetMaxFrames() * sizeof(Page));
+  delete replacer_;
+}
+
+Page *BufferPoolManagerInstance::FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) {
+  // 1.     Search the page table for the requested page (P).
+  // 1.1    If P exists, pin it and return it immediately.
+  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
+  //        Note that pages are always found from the free list first.
+  // 2.     If R is dirty, write it back to the disk.
+  // 3.     Delete R from the page table and insert P.
+  // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+
+  // Fast path: a hit takes one probe of the page table and an atomic increment of the pin count, and no latch.
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id)) {
+    if (TryPinFrame(frame_id, page_id)) {
+      replacer_->RecordAccess(frame_id);
+      metrics_.Add(BufferPoolMetric::FETCH_HITS);
+      return &pages_[frame_id];
+    }
+    // The frame is being replaced, or was replaced after the lookup.
+    metrics_.Add(BufferPoolMetric::PIN_WAITS);
+  }
+
+  // Slow path: the page is missing, being prefetched or being replaced, or the lookup raced with an update.
+  std::unique_lock latch{latch_};
+  WaitForPrefetch(&latch, page_id);
+  if (page_table_.Find(page_id, &frame_id)) {
+    // Resident frames cannot be locked while latch_ is held, so the pin count is not negative here.
+    pages_[frame_id].pin_count_++;
+    replacer_->RecordAccess(frame_id);
+    metrics_.Add(BufferPoolMetric::FETCH_HITS);
+    return &pages_[frame_id];
+  }
+
+  auto miss_start = std::chrono::steady_clock::now();
+  if (!FindReplacementFrame(&frame_id, strategy)) {
+    metrics_.Add(BufferPoolMetric::NO_FREE_FRAME);
+    return nullptr;
+  }
+
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->is_dirty_ = false;
+  replacer_->RecordAccess(frame_id);
+  AddFrameToRing(strategy, frame_id);
+  if (!MapPage(page, page_id)) {
+    ReadPage(page_id, page->data_);
+  }
+  // Publish the page only once its data is in place; unlatched fetches cannot pin it before the pin count is set.
+  page_table_.Insert(page_id, frame_id);
+  page->pin_count_.store(1);
+  metrics_.Add(BufferPoolMetric::FETCH_MISSES);
+  metrics_.RecordMissLatency(std::chrono::steady_clock::now() - miss_start);
+  return page;
+}
+
+bool BufferPoolManagerInstance::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  // The caller holds a pin, so the frame cannot be replaced and the page table hit is stable without the latch.
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id) || pages_[frame_id].page_id_ != page_id) {
+    std::scoped_lock latch{latch_};
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return false;
+    }
+  }
+  Page *page = &pages_[frame_id];
+  if (page->pin_count_ <= 0) {
+    return false;
+  }
+
+  // Dirty pages are written back lazily, by eviction, a flush or the background writer. The flag must be set before
+  // the pin is released, so that an eviction never sees the page unpinned but clean.
+  if (is_dirty) {
+    page->is_dirty_ = true;
+  }
+  int pin_count = page->pin_count_.load();
+  do {
+    if (pin_count <= 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+  if (pin_count == 1) {
+    replacer_->Unpin(frame_id);
+  }
+  return true;
+}
+
+bool BufferPoolManagerInstance::FlushPageImpl(page_id_t page_id) {
+  // Make sure you call DiskManager::WritePage!
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Cannot flush an invalid page.");
+  return WritePageBack(page_id, false);
+}
+
+Page *BufferPoolManagerInstance::NewPageImpl(page_id_t *page_id, BufferAccessStrategy *strategy,
+                                             page_id_t near_page_id) {
+  // 0.   Make sure you call AllocatePage!
+  // 1.   If all the pages in the buffer pool are pinned, return nullptr.
+  // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
+  // 3.   Update P's metadata, zero out memory and add P to the page table.
+  // 4.   Set the page ID output parameter. Return a pointer to P.
+  std::scoped_lock latch{latch_};
+
+  frame_id_t frame_id;
+  if (!FindReplacementFrame(&frame_id, strategy)) {
+    metrics_.Add(BufferPoolMetric::NO_FREE_FRAME);
+    return nullptr;
+  }
+
+  *page_id = AllocatePage(near_page_id);
+  Page *page = &pages_[frame_id];
+  page->ResetMemory();
+  page->page_id_ = *page_id;
+  // The id may have belonged to a deleted page whose bytes are still on disk; the zeros must replace them there.
+  page->is_dirty_ = true;
+  replacer_->RecordAccess(frame_id);
+  AddFrameToRing(strategy, frame_id);
+  page_table_.Insert(*page_id, frame_id);
+  page->pin_count_.store(1);
+  metrics_.Add(BufferPoolMetric::NEW_PAGES);
+  return page;
+}
+
+bool BufferPoolManagerInstance::DeletePageImpl(page_id_t page_id) {
+  // 0.   Make sure you call DeallocatePage!
+  // 1.   Search the page table for the requested page (P).
+  // 1.   If P does not exist, return true.
+  // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
+  // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
+  std::unique_lock latch{latch_};
+  WaitForPrefetch(&latch, page_id);
+
+  if (compressed_cache_ != nullptr) {
+    compressed_cache_->Erase(page_id);
+  }
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    DeallocatePage(page_id);
+    return true;
+  }
+
+  // Moving the pin count to FRAME_FREE fails if someone pinned the page, with or without the latch.
+  Page *page = &pages_[frame_id];
+  int unpinned = 0;
+  if (!page->pin_count_.compare_exchange_strong(unpinned, FRAME_FREE)) {
+    return false;
+  }
+
+  DeallocatePage(page_id);
+  page_table_.Erase(page_id);
+  // The frame is going back to the free list, so it must no longer be a replacement candidate.
+  replacer_->Remove(frame_id);
+  page->data_ = frame_arena_.GetFrame(frame_id);
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  free_list_.push_back(frame_id);
+  return true;
+}
+
+void BufferPoolManagerInstance::FlushAllPagesImpl() { Checkpoint({this}); }
+
+void BufferPoolManagerInstance::Checkpoint(const std::vector<BufferPoolManagerInstance *> &instances) {
+  // A checkpoint makes every dirty page durable, including the pages of writes that are in flight when it starts.
+  // latch_ is only held to pick the dirty pages and to mark them as being written; they are copied and written without
+  // it, CHECKPOINT_BATCH_PAGES at a time, so that misses neither wait for the I/O nor run out of unpinned frames. The
+  // pages of all instances go out in one page id order, so that the pages of different shards that are neighbours on
+  // disk share a vectored write, and one Sync at the end makes the whole checkpoint durable.
+  DiskManager *disk_manager = instances.front()->disk_manager_;
+  std::vector<std::pair<page_id_t, size_t>> dirty_pages;
+  for (size_t i = 0; i < instances.size(); i++) {
+    BUSTUB_ASSERT(instances[i]->disk_manager_ == disk_manager, "A checkpoint covers instances of one disk manager.");
+    instances[i]->CollectDirtyPages(i, &dirty_pages);
+  }
+  std::sort(dirty_pages.begin(), dirty_pages.end());
+
+  std::unique_ptr<char, decltype(&free)> copies{nullptr, &free};
+  if (!dirty_pages.empty()) {
+    copies.reset(
+        static_cast<char *>(aligned_alloc(DiskManager::DIRECT_IO_ALIGNMENT, CHECKPOINT_BATCH_PAGES * PAGE_SIZE)));
+  }
+  std::vector<std::vector<page_id_t>> batch(instances.size());
+  std::vector<std::vector<std::pair<page_id_t, frame_id_t>>> writes(instances.size());
+  for (size_t first = 0; first < dirty_pages.size(); first += CHECKPOINT_BATCH_PAGES) {
+    const size_t last = std::min(first + CHECKPOINT_BATCH_PAGES, dirty_pages.size());
+    for (auto &page_ids : batch) {
+      page_ids.clear();
+    }
+    for (size_t i = first; i < last; i++) {
+      batch[dirty_pages[i].second].push_back(dirty_pages[i].first);
+    }
+    WriteScheduler scheduler(disk_manager);
+    char *copy = copies.get();
+    for (size_t i = 0; i < instances.size(); i++) {
+      writes[i].clear();
+      if (!batch[i].empty()) {
+        instances[i]->StartCheckpointWrites(batch[i], &writes[i]);
+        instances[i]->CopyPages(writes[i], copy, &scheduler);
+        copy += writes[i].size() * PAGE_SIZE;
+      }
+    }
+    scheduler.Flush(false);
+    for (size_t i = 0; i < instances.size(); i++) {
+      if (!writes[i].empty()) {
+        instances[i]->EndPageWrites(writes[i]);
+        instances[i]->metrics_.Add(BufferPoolMetric::FLUSHES, writes[i].size());
+      }
+    }
+  }
+  disk_manager->Sync();
+}
+
+void BufferPoolManagerInstance::CollectDirtyPages(size_t instance,
+                                                  std::vector<std::pair<page_id_t, size_t>> *dirty_pages) {
+  std::unique_lock latch{latch_};
+  page_write_done_cv_.wait(latch, [&] { return pages_being_written_.empty(); });
+  page_table_.ForEach([&](page_id_t page_id, frame_id_t frame_id) {
+    if (pages_[frame_id].is_dirty_) {
+      dirty_pages->emplace_back(page_id, instance);
+    }
+  });
+}
+
+void BufferPoolManagerInstance::StartCheckpointWrites(const std::vector<page_id_t> &page_ids,
+                                                      std::vector<std::pair<page_id_t, frame_id_t>> *writes) {
+  // A page that is clean by now was written back by an eviction or by another write, which is over once no write of
+  // the page is in flight; the Sync of the checkpoint covers it.
+  std::unique_lock latch{latch_};
+  for (page_id_t page_id : page_ids) {
+    WaitForPageWrite(&latch, page_id);
+    frame_id_t frame_id;
+    if (page_table_.Find(page_id, &frame_id) && pages_[frame_id].is_dirty_) {
+      StartPageWrite(page_id, frame_id);
+      writes->emplace_back(page_id, frame_id);
+    }
+  }
+}
+
+void BufferPoolManagerInstance::PrefetchPagesImpl(const std::vector<page_id_t> &page_ids) {
+  {
+    std::scoped_lock latch{latch_};
+    for (page_id_t page_id : page_ids) {
+      if (page_id < 0) {
+        continue;
+      }
+      BUSTUB_ASSERT(page_id % num_instances_ == instance_index_, "Prefetched pages must belong to this BPI");
+      if (prefetch_queue_.size() >= pool_size_) {
+        break;
+      }
+      prefetch_queue_.push_back(page_id);
+    }
+    if (!prefetch_thread_.joinable()) {
+      prefetch_thread_ = std::thread(&BufferPoolManagerInstance::PrefetchLoop, this);
+    }
+  }
+  prefetch_cv_.notify_all();
+}
+
+bool BufferPoolManagerInstance::Resize(size_t pool_size) {
+  BUSTUB_ASSERT(pool_size > 0, "A buffer pool needs at least one frame.");
+  if (pool_size > frame_arena_.GetMaxFrames()) {
+    return false;
+  }
+  std::scoped_lock resize_latch{resize_latch_};
+  const size_t old_pool_size = pool_size_;
+  if (pool_size > old_pool_size) {
+    std::scoped_lock latch{latch_};
+    GrowPool(pool_size);
+    return true;
+  }
+  if (pool_size == old_pool_size) {
+    return true;
+  }
+
+  // Write the dirty pages back before taking latch_, so that fetches do not wait for the I/O.
+  WriteBackFrames(pool_size, old_pool_size);
+  {
+    std::unique_lock latch{latch_};
+    if (!ShrinkPool(&latch, pool_size)) {
+      return false;
+    }
+  }
+  // The removed frames are parked at FRAME_FREE and only a resize can bring them back, so nobody else touches them.
+  frame_arena_.Release(static_cast<frame_id_t>(pool_size), old_pool_size - pool_size);
+  return true;
+}
+
+void BufferPoolManagerInstance::GrowPool(size_t pool_size) {
+  for (size_t i = num_descriptors_; i < pool_size; ++i) {
+    new (&pages_[i]) Page(frame_arena_.GetFrame(static_cast<frame_id_t>(i)));
+    pages_[i].pin_count_ = FRAME_FREE;
+  }
+  num_descriptors_ = std::max(num_descriptors_, pool_size);
+  page_table_.Reserve(pool_size);
+  replacer_->Resize(pool_size);
+  for (size_t i = pool_size_; i < pool_size; ++i) {
+    free_list_.emplace_back(static_cast<frame_id_t>(i));
+  }
+  pool_size_ = pool_size;
+}
+
+bool BufferPoolManagerInstance::ShrinkPool(std::unique_lock<std::mutex> *latch, size_t pool_size) {
+  // Prefetch threads read into locked frames without latch_; let them finish rather than fail.
+  prefetch_done_cv_.wait(*latch, [&] { return prefetch_in_flight_.empty(); });
+
+  // Lock every resident frame to be removed first, so that a pinned one can still call the whole shrink off.
+  std::vector<frame_id_t> locked;
+  for (size_t i = pool_size; i < pool_size_; ++i) {
+    auto frame_id = static_cast<frame_id_t>(i);
+    if (pages_[frame_id].pin_count_ == FRAME_FREE) {
+      continue;
+    }
+    if (!TryLockFrame(frame_id)) {
+      for (frame_id_t locked_frame_id : locked) {
+        pages_[locked_frame_id].pin_count_.store(0);
+      }
+      return false;
+    }
+    locked.push_back(frame_id);
+  }
+
+  for (frame_id_t frame_id : locked) {
+    Page *page = &pages_[frame_id];
+    replacer_->Remove(frame_id);
+    EvictFrame(frame_id);
+    page->page_id_ = INVALID_PAGE_ID;
+    page->pin_count_ = FRAME_FREE;
+  }
+  free_list_.remove_if([&](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= pool_size; });
+  replacer_->Resize(pool_size);
+  pool_size_ = pool_size;
+  return true;
+}
+
+void BufferPoolManagerInstance::WriteBackFrames(size_t first_frame, size_t last_frame) {
+  for (size_t i = first_frame; i < last_frame; ++i) {
+    page_id_t page_id = pages_[i].page_id_;
+    if (pages_[i].is_dirty_ && page_id != INVALID_PAGE_ID) {
+      WritePageBack(page_id, true);
+    }
+  }
+}
+
+bool BufferPoolManagerInstance::WritePageBack(page_id_t page_id, bool only_dirty) {
+  frame_id_t frame_id;
+  {
+    std::unique_lock latch{latch_};
+    WaitForPageWrite(&latch, page_id);
+    if (!page_table_.Find(page_id, &frame_id) || (only_dirty && !pages_[frame_id].is_dirty_)) {
+      return false;
+    }
+    StartPageWrite(page_id, frame_id);
+  }
+
+  // Unpins do not take latch_, so only the page latch orders the write against updates.
+  Page *page = &pages_[frame_id];
+  page->RLatch();
+  disk_manager_->WritePage(page_id, page->data_);
+  page->RUnlatch();
+  metrics_.Add(BufferPoolMetric::FLUSHES);
+  EndPageWrites({{page_id, frame_id}});
+  return true;
+}
+
+void BufferPoolManagerInstance::CopyPages(const std::vector<std::pair<page_id_t, frame_id_t>> &writes, char *copies,
+                                          WriteScheduler *scheduler) {
+  for (size_t i = 0; i < writes.size(); i++) {
+    Page *page = &pages_[writes[i].second];
+    char *copy = copies + i * PAGE_SIZE;
+    page->RLatch();
+    memcpy(copy, page->data_, PAGE_SIZE);
+    page->RUnlatch();
+    scheduler->Add(writes[i].first, copy);
+  }
+}
+
+void BufferPoolManagerInstance::WaitForPageWrite(std::unique_lock<std::mutex> *latch, page_id_t page_id) {
+  if (pages_being_written_.count(page_id) > 0) {
+    page_write_done_cv_.wait(*latch, [&] { return pages_being_written_.count(page_id) == 0; });
+  }
+}
+
+void BufferPoolManagerInstance::StartPageWrite(page_id_t page_id, frame_id_t frame_id) {
+  // Resident frames cannot be locked while latch_ is held, so the pin count is not negative here.
+  pages_[frame_id].pin_count_++;
+  pages_[frame_id].is_dirty_ = false;
+  pages_being_written_.insert(page_id);
+}
+
+void BufferPoolManagerInstance::EndPageWrites(const std::vector<std::pair<page_id_t, frame_id_t>> &writes) {
+  {
+    std::scoped_lock latch{latch_};
+    for (const auto &[page_id, frame_id] : writes) {
+      pages_being_written_.erase(page_id);
+      if (--pages_[frame_id].pin_count_ == 0) {
+        replacer_->Unpin(frame_id);
+      }
+    }
+  }
+  page_write_done_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::RunBackgroundWriter(const BackgroundWriterOptions &options) {
+  BUSTUB_ASSERT(!background_writer_.joinable(), "The background writer is already running.");
+  BUSTUB_ASSERT(options.max_pages_per_round_ > 0, "The background writer must write at least one page per round.");
+  background_writer_options_ = options;
+  background_writer_stop_ = false;
+  background_writer_wake_ = false;
+  background_writer_ = std::thread(&BufferPoolManagerInstance::BackgroundWriterLoop, this);
+}
+
+void BufferPoolManagerInstance::StopBackgroundWriter() {
+  if (!background_writer_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock latch{latch_};
+    background_writer_stop_ = true;
+  }
+  background_writer_cv_.notify_one();
+  background_writer_.join();
+}
+
+bool BufferPoolManagerInstance::DumpResidentPages(const std::string &file_name) {
+  WarmRestartHeader header{WARM_RESTART_MAGIC, 0};
+  std::vector<page_id_t> page_ids;
+  {
+    std::scoped_lock latch{latch_};
+    std::vector<frame_id_t> frames;
+    replacer_->GetAccessOrder(&frames);
+    // Resident frames that the replacer cannot rank go last, in frame order.
+    for (size_t frame_id = 0; frame_id < pool_size_; frame_id++) {
+      frames.push_back(static_cast<frame_id_t>(frame_id));
+    }
+    std::vector<bool> listed(pool_size_, false);
+    for (frame_id_t frame_id : frames) {
+      if (static_cast<size_t>(frame_id) >= pool_size_ || listed[frame_id]) {
+        continue;
+      }
+      listed[frame_id] = true;
+      page_id_t page_id = pages_[frame_id].page_id_;
+      frame_id_t resident;
+      if (page_id != INVALID_PAGE_ID && page_table_.Find(page_id, &resident) && resident == frame_id) {
+        page_ids.push_back(page_id);
+      }
+    }
+  }
+  header.num_pages_ = static_cast<uint32_t>(page_ids.size());
+
+  // Write a new file and rename it over the old one, so that a crash in between leaves the old dump intact.
+  const std::string temp_file_name = file_name + ".tmp";
+  std::ofstream out(temp_file_name, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(page_ids.data()), page_ids.size() * sizeof(page_id_t));
+  out.close();
+  if (!out) {
+    std::remove(temp_file_name.c_str());
+    return false;
+  }
+  return std::rename(temp_file_name.c_str(), file_name.c_str()) == 0;
+}
+
+size_t BufferPoolManagerInstance::LoadResidentPages(const std::string &file_name) {
+  std::ifstream in(file_name, std::ios::binary | std::ios::ate);
+  auto file_size = static_cast<size_t>(std::max<std::streamoff>(in.tellg(), 0));
+  in.seekg(0);
+  WarmRestartHeader header;
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic_ != WARM_RESTART_MAGIC ||
+      file_size != sizeof(header) + header.num_pages_ * sizeof(page_id_t)) {
+    return 0;
+  }
+  std::vector<page_id_t> page_ids(header.num_pages_);
+  if (!in.read(reinterpret_cast<char *>(page_ids.data()), page_ids.size() * sizeof(page_id_t))) {
+    return 0;
+  }
+
+  // Claim free frames for the most recently used pages that fit. The least recently used page takes the first free
+  // frame, so that policies that sweep the frames in order meet it first. Like a prefetch, a claimed frame stays
+  // locked and out of the page table until its read is done.
+  std::vector<std::pair<page_id_t, frame_id_t>> claims;
+  {
+    std::scoped_lock latch{latch_};
+    std::vector<page_id_t> hot_page_ids;
+    for (page_id_t page_id : page_ids) {
+      frame_id_t frame_id;
+      if (hot_page_ids.size() == free_list_.size()) {
+        break;
+      }
+      if (static_cast<uint32_t>(page_id) % num_instances_ == instance_index_ &&
+          disk_manager_->IsPageAllocated(page_id) && !page_table_.Find(page_id, &frame_id) &&
+          prefetch_in_flight_.count(page_id) == 0) {
+        hot_page_ids.push_back(page_id);
+      }
+    }
+    for (auto it = hot_page_ids.rbegin(); it != hot_page_ids.rend(); ++it) {
+      frame_id_t frame_id = free_list_.front();
+      free_list_.pop_front();
+      Page *page = &pages_[frame_id];
+      page->pin_count_ = FRAME_LOCKED;
+      page->page_id_ = *it;
+      page->is_dirty_ = false;
+      prefetch_in_flight_.insert(*it);
+      claims.emplace_back(*it, frame_id);
+    }
+  }
+
+  // Read the pages in page id order, in batches, publishing each batch as soon as it is read.
+  std::vector<std::pair<page_id_t, frame_id_t>> reads(claims);
+  std::sort(reads.begin(), reads.end());
+  std::vector<page_id_t> batch_page_ids;
+  std::vector<char *> batch_pages_data;
+  size_t num_loaded = 0;
+  while (num_loaded < reads.size()) {
+    size_t num_pages = std::min<size_t>(WARM_RESTART_BATCH_PAGES, reads.size() - num_loaded);
+    batch_page_ids.clear();
+    batch_pages_data.clear();
+    for (size_t i = num_loaded; i < num_loaded + num_pages; i++) {
+      batch_page_ids.push_back(reads[i].first);
+      batch_pages_data.push_back(pages_[reads[i].second].data_);
+    }
+    ReadPages(batch_page_ids, batch_pages_data);
+
+    std::scoped_lock latch{latch_};
+    for (size_t i = num_loaded; i < num_loaded + num_pages; i++) {
+      prefetch_in_flight_.erase(reads[i].first);
+      page_table_.Insert(reads[i].first, reads[i].second);
+      pages_[reads[i].second].pin_count_.store(0);
+    }
+    num_loaded += num_pages;
+    prefetch_done_cv_.notify_all();
+    if (warm_restart_stop_) {
+      // Hand back the frames that were claimed but not read.
+      for (size_t i = num_loaded; i < reads.size(); i++) {
+        prefetch_in_flight_.erase(reads[i].first);
+        pages_[reads[i].second].page_id_ = INVALID_PAGE_ID;
+        pages_[reads[i].second].pin_count_ = FRAME_FREE;
+        free_list_.push_back(reads[i].second);
+      }
+      break;
+    }
+  }
+
+  // The loaded frames become evictable only now, least recently used first, so that the replacer ranks them in the
+  // order of the previous run rather than in page id order. Frames that a fetch has pinned and unpinned meanwhile are
+  // already in the replacer.
+  std::scoped_lock latch{latch_};
+  for (const auto &[page_id, frame_id] : claims) {
+    if (pages_[frame_id].page_id_ == page_id && pages_[frame_id].pin_count_ == 0) {
+      replacer_->Unpin(frame_id);
+    }
+  }
+  metrics_.Add(BufferPoolMetric::WARM_LOADS, num_loaded);
+  return num_loaded;
+}
+
+void BufferPoolManagerInstance::RunWarmRestart(const std::string &file_name,
+                                               std::chrono::milliseconds dump_interval) {
+  BUSTUB_ASSERT(!warm_restart_thread_.joinable(), "The warm restart thread is already running.");
+  warm_restart_file_ = file_name;
+  warm_restart_dump_interval_ = dump_interval;
+  warm_restart_stop_ = false;
+  warm_restart_thread_ = std::thread(&BufferPoolManagerInstance::WarmRestartLoop, this);
+}
+
+void BufferPoolManagerInstance::StopWarmRestart() {
+  if (!warm_restart_thread_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock latch{latch_};
+    warm_restart_stop_ = true;
+  }
+  warm_restart_cv_.notify_one();
+  warm_restart_thread_.join();
+  DumpResidentPages(warm_restart_file_);
+}
+
+BufferPoolMetricsSnapshot BufferPoolManagerInstance::GetMetrics() {
+  BufferPoolMetricsSnapshot snapshot = metrics_.Snapshot();
+  snapshot.counters_[static_cast<size_t>(BufferPoolMetric::VICTIM_FRAMES_SCANNED)] = replacer_->GetNumFramesScanned();
+  return snapshot;
+}
+
+uint64_t BufferPoolManagerInstance::GetNumForegroundWrites() const {
+  BufferPoolMetricsSnapshot snapshot = metrics_.Snapshot();
+  return snapshot.Get(BufferPoolMetric::DIRTY_EVICTIONS) + snapshot.Get(BufferPoolMetric::FLUSHES);
+}
+
+uint64_t BufferPoolManagerInstance::GetNumBackgroundWrites() const {
+  return metrics_.Snapshot().Get(BufferPoolMetric::BACKGROUND_WRITES);
+}
+
+uint64_t BufferPoolManagerInstance::GetNumPrefetches() const {
+  return metrics_.Snapshot().Get(BufferPoolMetric::PREFETCHES);
+}
+
+bool BufferPoolManagerInstance::FindReplacementFrame(frame_id_t *frame_id, BufferAccessStrategy *strategy) {
+  if (strategy != nullptr) {
+    BufferAccessStrategy::RingSlot *slot = strategy->NextSlot();
+    // The ring may hold frames of other instances of a parallel buffer pool; those are not ours to recycle.
+    Page *page = slot->page_;
+    if (page >= pages_ && page < pages_ + pool_size_ && page->page_id_ == slot->page_id_ &&
+        TryLockFrame(static_cast<frame_id_t>(page - pages_))) {
+      *frame_id = static_cast<frame_id_t>(page - pages_);
+      replacer_->Remove(*frame_id);
+      EvictFrame(*frame_id, false);
+      return true;
+    }
+  }
+
+  if (!free_list_.empty()) {
+    // Free frames cannot be pinned, so nobody races for them.
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    pages_[*frame_id].pin_count_ = FRAME_LOCKED;
+    return true;
+  }
+
+  // Nothing in the free list or the replacer means that all pages are pinned.
+  if (!FindVictim(frame_id)) {
+    return false;
+  }
+  EvictFrame(*frame_id);
+  return true;
+}
+
+bool BufferPoolManagerInstance::FindVictim(frame_id_t *frame_id) {
+  // Unlatched fetches pin frames without telling the replacer, so a victim may turn out to be pinned. Such a frame is
+  // dropped from the replacer with its access history; the unpin that brings its pin count back to zero hands it back.
+  // Only a frame that is locked for replacement forgets its history.
+  auto prefer = [&](frame_id_t candidate) { return pages_[candidate].pin_count_ == 0 && !pages_[candidate].is_dirty_; };
+  while (true) {
+    metrics_.Add(BufferPoolMetric::VICTIM_SCANS);
+    if (!replacer_->PreferredVictim(frame_id, prefer, CLEAN_VICTIM_LOOKAHEAD)) {
+      return false;
+    }
+    if (TryLockFrame(*frame_id)) {
+      replacer_->Remove(*frame_id);
+      if (pages_[*frame_id].is_dirty_) {
+        // Eviction has to write a page itself, so the background writer is falling behind.
+        background_writer_wake_ = true;
+        background_writer_cv_.notify_one();
+      }
+      return true;
+    }
+  }
+}
+
+bool BufferPoolManagerInstance::TryPinFrame(frame_id_t frame_id, page_id_t page_id) {
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_.load();
+  do {
+    if (pin_count < 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+
+  // The frame may have been replaced between the lookup and the pin. The pin keeps it from being replaced now.
+  if (page->page_id_ == page_id) {
+    return true;
+  }
+  if (page->pin_count_.fetch_sub(1) == 1) {
+    replacer_->Unpin(frame_id);
+  }
+  return false;
+}
+
+bool BufferPoolManagerInstance::TryLockFrame(frame_id_t frame_id) {
+  int unpinned = 0;
+  return pages_[frame_id].pin_count_.compare_exchange_strong(unpinned, FRAME_LOCKED);
+}
+
+void BufferPoolManagerInstance::EvictFrame(frame_id_t frame_id, bool keep_compressed) {
+  Page *victim = &pages_[frame_id];
+  // Pages that are being written stay pinned, so a locked frame never has a write in flight that could land later.
+  BUSTUB_ASSERT(pages_being_written_.count(victim->page_id_) == 0, "Cannot evict a page that is being written.");
+  if (victim->is_dirty_) {
+    disk_manager_->WritePage(victim->page_id_, victim->data_);
+    metrics_.Add(BufferPoolMetric::DIRTY_EVICTIONS);
+    victim->is_dirty_ = false;
+  } else {
+    metrics_.Add(BufferPoolMetric::CLEAN_EVICTIONS);
+  }
+  // The page is clean now, so the cached copy matches the disk.
+  if (keep_compressed && compressed_cache_ != nullptr && compressed_cache_->Insert(victim->page_id_, victim->data_)) {
+    metrics_.Add(BufferPoolMetric::COMPRESSED_CACHE_PUTS);
+  }
+  page_table_.Erase(victim->page_id_);
+  // A zero-copy page pointed into the disk manager's mapping; the frame's own memory takes over again.
+  victim->data_ = frame_arena_.GetFrame(frame_id);
+}
+
+bool BufferPoolManagerInstance::MapPage(Page *page, page_id_t page_id) {
+  if (!buffer_pool_zero_copy) {
+    return false;
+  }
+  const char *mapped = disk_manager_->GetMappedPage(page_id);
+  if (mapped == nullptr) {
+    return false;
+  }
+  // The mapping is read-only; writes through the page fault instead of changing the file.
+  page->data_ = const_cast<char *>(mapped);
+  return true;
+}
+
+void BufferPoolManagerInstance::ReadPage(page_id_t page_id, char *page_data) {
+  if (compressed_cache_ != nullptr && compressed_cache_->Lookup(page_id, page_data)) {
+    metrics_.Add(BufferPoolMetric::COMPRESSED_CACHE_HITS);
+    return;
+  }
+  disk_manager_->ReadPage(page_id, page_data);
+}
+
+void BufferPoolManagerInstance::ReadPages(const std::vector<page_id_t> &page_ids,
+                                          const std::vector<char *> &pages_data) {
+  std::vector<page_id_t> disk_page_ids;
+  std::vector<char *> disk_pages_data;
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    if (compressed_cache_ != nullptr && compressed_cache_->Lookup(page_ids[i], pages_data[i])) {
+      metrics_.Add(BufferPoolMetric::COMPRESSED_CACHE_HITS);
+    } else {
+      disk_page_ids.push_back(page_ids[i]);
+      disk_pages_data.push_back(pages_data[i]);
+    }
+  }
+  if (!disk_page_ids.empty()) {
+    disk_manager_->ReadPages(disk_page_ids.data(), disk_pages_data.data(), disk_page_ids.size());
+  }
+}
+
+void BufferPoolManagerInstance::AddFrameToRing(BufferAccessStrategy *strategy, frame_id_t frame_id) {
+  if (strategy != nullptr) {
+    strategy->ring_[strategy->current_] = {&pages_[frame_id], pages_[frame_id].page_id_};
+  }
+}
+
+void BufferPoolManagerInstance::PrefetchLoop() {
+  std::unique_lock latch{latch_};
+  while (true) {
+    // Keep at most PREFETCH_IO_DEPTH frames locked for reads, so that foreground fetches still find victims.
+    prefetch_cv_.wait(latch, [&] {
+      return prefetch_stop_ ||
+             (!prefetch_queue_.empty() && num_prefetch_reads_ < static_cast<size_t>(PREFETCH_IO_DEPTH));
+    });
+    if (prefetch_stop_) {
+      return;
+    }
+    std::vector<std::pair<page_id_t, frame_id_t>> reads;
+    while (!prefetch_queue_.empty() && num_prefetch_reads_ < static_cast<size_t>(PREFETCH_IO_DEPTH)) {
+      page_id_t page_id = prefetch_queue_.front();
+      prefetch_queue_.pop_front();
+      // Reading in a page that is not allocated would shadow the frame of a later NewPage that allocates it.
+      frame_id_t frame_id;
+      if (!disk_manager_->IsPageAllocated(page_id) || page_table_.Find(page_id, &frame_id) ||
+          prefetch_in_flight_.count(page_id) > 0 || !FindReplacementFrame(&frame_id, nullptr)) {
+        continue;
+      }
+      // The frame stays locked and out of the page table during the read. Fetches of the page wait for it.
+      Page *page = &pages_[frame_id];
+      page->page_id_ = page_id;
+      page->is_dirty_ = false;
+      prefetch_in_flight_.insert(page_id);
+      num_prefetch_reads_++;
+      reads.emplace_back(page_id, frame_id);
+    }
+    latch.unlock();
+
+    // Submit all reads that miss the compressed cache as one batch; each page is published as soon as it is read.
+    std::vector<DiskRequest> requests;
+    for (const auto &[page_id, frame_id] : reads) {
+      if (compressed_cache_ != nullptr && compressed_cache_->Lookup(page_id, pages_[frame_id].data_)) {
+        metrics_.Add(BufferPoolMetric::COMPRESSED_CACHE_HITS);
+        FinishPrefetch(page_id, frame_id, true);
+        continue;
+      }
+      auto finish = [this, page_id = page_id, frame_id = frame_id](bool ok) { FinishPrefetch(page_id, frame_id, ok); };
+      requests.push_back({false, page_id, pages_[frame_id].data_, finish});
+    }
+    if (!requests.empty()) {
+      disk_manager_->Submit(&requests);
+    }
+    latch.lock();
+  }
+}
+
+void BufferPoolManagerInstance::FinishPrefetch(page_id_t page_id, frame_id_t frame_id, bool ok) {
+  std::scoped_lock latch{latch_};
+  prefetch_in_flight_.erase(page_id);
+  num_prefetch_reads_--;
+  if (ok) {
+    page_table_.Insert(page_id, frame_id);
+    pages_[frame_id].pin_count_.store(0);
+    replacer_->Unpin(frame_id);
+    metrics_.Add(BufferPoolMetric::PREFETCHES);
+  } else {
+    // The frame holds whatever the failed read left behind; a fetch of the page reads it again.
+    pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+    pages_[frame_id].pin_count_ = FRAME_FREE;
+    free_list_.push_back(frame_id);
+  }
+  prefetch_done_cv_.notify_all();
+  prefetch_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::SetPagePriorityImpl(Page *page, PagePriority priority) {
+  replacer_->SetPriority(static_cast<frame_id_t>(page - pages_), priority);
+}
+
+size_t BufferPoolManagerInstance::FetchPagesImpl(const page_id_t *page_ids, size_t num_pages, Page **pages) {
+  // Hits take the unlatched fast path, as in FetchPageImpl.
+  size_t num_fetched = 0;
+  std::vector<size_t> missed;
+  for (size_t i = 0; i < num_pages; i++) {
+    frame_id_t frame_id;
+    pages[i] = nullptr;
+    if (page_table_.Find(page_ids[i], &frame_id) && TryPinFrame(frame_id, page_ids[i])) {
+      replacer_->RecordAccess(frame_id);
+      metrics_.Add(BufferPoolMetric::FETCH_HITS);
+      pages[i] = &pages_[frame_id];
+      num_fetched++;
+    } else {
+      missed.push_back(i);
+    }
+  }
+  if (missed.empty()) {
+    return num_fetched;
+  }
+
+  // Claim a frame for every distinct missing page. Like a prefetch, a claimed frame stays locked and out of the page
+  // table while it is read, and fetches of its page wait for the batch. Pages that someone else is reading are left
+  // for after the batch: waiting for them while holding claims could deadlock with a batch that waits for ours.
+  auto miss_start = std::chrono::steady_clock::now();
+  std::vector<page_id_t> read_page_ids;
+  std::vector<char *> read_pages_data;
+  std::vector<frame_id_t> read_frames;
+  std::vector<int> read_pins;
+  std::vector<size_t> deferred;
+  std::unique_lock latch{latch_};
+  for (size_t i : missed) {
+    page_id_t page_id = page_ids[i];
+    auto claimed = std::find(read_page_ids.begin(), read_page_ids.end(), page_id);
+    if (claimed != read_page_ids.end()) {
+      size_t read = claimed - read_page_ids.begin();
+      read_pins[read]++;
+      pages[i] = &pages_[read_frames[read]];
+      num_fetched++;
+      continue;
+    }
+    if (prefetch_in_flight_.count(page_id) > 0) {
+      deferred.push_back(i);
+      continue;
+    }
+    frame_id_t frame_id;
+    if (page_table_.Find(page_id, &frame_id)) {
+      pages_[frame_id].pin_count_++;
+      replacer_->RecordAccess(frame_id);
+      metrics_.Add(BufferPoolMetric::FETCH_HITS);
+      pages[i] = &pages_[frame_id];
+      num_fetched++;
+      continue;
+    }
+    if (!FindReplacementFrame(&frame_id, nullptr)) {
+      metrics_.Add(BufferPoolMetric::NO_FREE_FRAME);
+      continue;
+    }
+    Page *page = &pages_[frame_id];
+    page->page_id_ = page_id;
+    page->is_dirty_ = false;
+    replacer_->RecordAccess(frame_id);
+    pages[i] = page;
+    num_fetched++;
+    if (MapPage(page, page_id)) {
+      page_table_.Insert(page_id, frame_id);
+      page->pin_count_.store(1);
+      metrics_.Add(BufferPoolMetric::FETCH_MISSES);
+      continue;
+    }
+    prefetch_in_flight_.insert(page_id);
+    read_page_ids.push_back(page_id);
+    read_pages_data.push_back(page->data_);
+    read_frames.push_back(frame_id);
+    read_pins.push_back(1);
+  }
+  latch.unlock();
+
+  if (!read_page_ids.empty()) {
+    ReadPages(read_page_ids, read_pages_data);
+    auto miss_latency = std::chrono::steady_clock::now() - miss_start;
+    latch.lock();
+    for (size_t read = 0; read < read_page_ids.size(); read++) {
+      prefetch_in_flight_.erase(read_page_ids[read]);
+      page_table_.Insert(read_page_ids[read], read_frames[read]);
+      pages_[read_frames[read]].pin_count_.store(read_pins[read]);
+      metrics_.Add(BufferPoolMetric::FETCH_MISSES);
+      metrics_.RecordMissLatency(miss_latency);
+    }
+    prefetch_done_cv_.notify_all();
+    latch.unlock();
+  }
+
+  // Our claims are published, so the deferred pages can be waited for one by one.
+  for (size_t i : deferred) {
+    pages[i] = FetchPageImpl(page_ids[i], nullptr);
+    num_fetched += pages[i] != nullptr ? 1 : 0;
+  }
+  return num_fetched;
+}
+
+void BufferPoolManagerInstance::WaitForPrefetch(std::unique_lock<std::mutex> *latch, page_id_t page_id) {
+  if (prefetch_in_flight_.count(page_id) > 0) {
+    metrics_.Add(BufferPoolMetric::PIN_WAITS);
+    prefetch_done_cv_.wait(*latch, [&] { return prefetch_in_flight_.count(page_id) == 0; });
+  }
+}
+
+void BufferPoolManagerInstance::WarmRestartLoop() {
+  LoadResidentPages(warm_restart_file_);
+  std::unique_lock latch{latch_};
+  while (true) {
+    warm_restart_cv_.wait_for(latch, warm_restart_dump_interval_, [&] { return warm_restart_stop_; });
+    if (warm_restart_stop_) {
+      return;
+    }
+    latch.unlock();
+    DumpResidentPages(warm_restart_file_);
+    latch.lock();
+  }
+}
+
+void BufferPoolManagerInstance::BackgroundWriterLoop() {
+  while (true) {
+    double dirty_fraction = BackgroundWriterRound();
+    std::unique_lock latch{latch_};
+    if (background_writer_stop_) {
+      return;
+    }
+    // Above the high watermark the writer keeps going; otherwise it sleeps until the next round is due.
+    if (dirty_fraction <= background_writer_options_.high_watermark_) {
+      background_writer_cv_.wait_for(latch, background_writer_options_.interval_,
+                                     [&] { return background_writer_stop_ || background_writer_wake_; });
+    }
+    background_writer_wake_ = false;
+    if (background_writer_stop_) {
+      return;
+    }
+  }
+}
+
+double BufferPoolManagerInstance::BackgroundWriterRound() {
+  std::vector<std::pair<page_id_t, frame_id_t>> to_write;
+  double dirty_fraction;
+  {
+    std::scoped_lock latch{latch_};
+    size_t num_dirty = 0;
+    std::vector<std::pair<page_id_t, frame_id_t>> candidates;
+    page_table_.ForEach([&](page_id_t page_id, frame_id_t frame_id) {
+      if (pages_[frame_id].is_dirty_) {
+        num_dirty++;
+        if (pages_[frame_id].pin_count_ == 0) {
+          candidates.emplace_back(page_id, frame_id);
+        }
+      }
+    });
+    dirty_fraction = static_cast<double>(num_dirty) / static_cast<double>(pool_size_);
+    if (candidates.empty() || dirty_fraction <= background_writer_options_.low_watermark_) {
+      return dirty_fraction;
+    }
+
+    // Sweep the dirty pages in page id order, continuing where the previous round stopped, so that consecutive writes
+    // are mostly sequential on disk and no page is starved.
+    std::sort(candidates.begin(), candidates.end());
+    auto start = std::upper_bound(candidates.begin(), candidates.end(),
+                                  std::make_pair(background_writer_cursor_, static_cast<frame_id_t>(pool_size_)));
+    size_t num_to_write = std::min(candidates.size(), background_writer_options_.max_pages_per_round_);
+    for (size_t i = 0; i < num_to_write; i++) {
+      if (start == candidates.end()) {
+        start = candidates.begin();
+      }
+      to_write.push_back(*start++);
+    }
+    background_writer_cursor_ = to_write.back().first;
+
+    // Pages that another write holds are pinned, so they are never candidates, and writes of a page do not overlap.
+    for (const auto &[page_id, frame_id] : to_write) {
+      StartPageWrite(page_id, frame_id);
+    }
+  }
+
+  // Background writes need not be durable, so there is no Sync. The copies are aligned like frames, so that direct I/O
+  // can write them as they are.
+  std::unique_ptr<char, decltype(&free)> copies{
+      static_cast<char *>(aligned_alloc(DiskManager::DIRECT_IO_ALIGNMENT, to_write.size() * PAGE_SIZE)), &free};
+  WriteScheduler scheduler(disk_manager_);
+  CopyPages(to_write, copies.get(), &scheduler);
+  scheduler.Flush(false);
+  metrics_.Add(BufferPoolMetric::BACKGROUND_WRITES, to_write.size());
+  EndPageWrites(to_write);
+  return dirty_fraction;
+}
+
+page_id_t BufferPoolManagerInstance::AllocatePage(page_id_t near_page_id) {
+  const page_id_t page_id = disk_manager_->AllocatePage(near_page_id, num_instances_, instance_index_);
+  BUSTUB_ASSERT(page_id % num_instances_ == instance_index_,
+                "Allocated pages must mod back to this BPI when the parallel buffer pool routes them");
+  return page_id;
+}
+
+}  // namespace bustub
@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics.cpp
+//
+// Identification: src/buffer/buffer_pool_metrics.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_metrics.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace bustub {
+
+double BufferPoolMetricsSnapshot::HitRatio() const {
+  uint64_t fetches = Get(BufferPoolMetric::FETCH_HITS) + Get(BufferPoolMetric::FETCH_MISSES);
+  return fetches == 0 ? 0 : static_cast<double>(Get(BufferPoolMetric::FETCH_HITS)) / static_cast<double>(fetches);
+}
+
+double BufferPoolMetricsSnapshot::MeanVictimScanLength() const {
+  uint64_t scans = Get(BufferPoolMetric::VICTIM_SCANS);
+  uint64_t frames_scanned = Get(BufferPoolMetric::VICTIM_FRAMES_SCANNED);
+  return scans == 0 ? 0 : static_cast<double>(frames_scanned) / static_cast<double>(scans);
+}
+
+uint64_t BufferPoolMetricsSnapshot::MissLatencyPercentile(double fraction) const {
+  uint64_t total = 0;
+  for (uint64_t count : miss_latency_) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++) {
+    seen += miss_latency_[i];
+    if (seen >= std::max<uint64_t>(rank, 1)) {
+      return uint64_t{1} << i;
+    }
+  }
+  return uint64_t{1} << (NUM_LATENCY_BUCKETS - 1);
+}
+
+BufferPoolMetricsSnapshot BufferPoolMetricsSnapshot::Diff(const BufferPoolMetricsSnapshot &earlier) const {
+  BufferPoolMetricsSnapshot diff;
+  for (size_t i = 0; i < counters_.size(); i++) {
+    diff.counters_[i] = counters_[i] - earlier.counters_[i];
+  }
+  for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++) {
+    diff.miss_latency_[i] = miss_latency_[i] - earlier.miss_latency_[i];
+  }
+  return diff;
+}
+
+void BufferPoolMetricsSnapshot::Merge(const BufferPoolMetricsSnapshot &other) {
+  for (size_t i = 0; i < counters_.size(); i++) {
+    counters_[i] += other.counters_[i];
+  }
+  for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++) {
+    miss_latency_[i] += other.miss_latency_[i];
+  }
+}
+
+const char *BufferPoolMetricsSnapshot::GetName(BufferPoolMetric metric) {
+  switch (metric) {
+    case BufferPoolMetric::FETCH_HITS:
+      return "fetch_hits";
+    case BufferPoolMetric::FETCH_MISSES:
+      return "fetch_misses";
+    case BufferPoolMetric::NO_FREE_FRAME:
+      return "no_free_frame";
+    case BufferPoolMetric::NEW_PAGES:
+      return "new_pages";
+    case BufferPoolMetric::CLEAN_EVICTIONS:
+      return "clean_evictions";
+    case BufferPoolMetric::DIRTY_EVICTIONS:
+      return "dirty_evictions";
+    case BufferPoolMetric::FLUSHES:
+      return "flushes";
+    case BufferPoolMetric::BACKGROUND_WRITES:
+      return "background_writes";
+    case BufferPoolMetric::PREFETCHES:
+      return "prefetches";
+    case BufferPoolMetric::COMPRESSED_CACHE_HITS:
+      return "compressed_cache_hits";
+    case BufferPoolMetric::COMPRESSED_CACHE_PUTS:
+      return "compressed_cache_puts";
+    case BufferPoolMetric::WARM_LOADS:
+      return "warm_loads";
+    case BufferPoolMetric::PIN_WAITS:
+      return "pin_waits";
+    case BufferPoolMetric::VICTIM_SCANS:
+      return "victim_scans";
+    case BufferPoolMetric::VICTIM_FRAMES_SCANNED:
+      return "victim_frames_scanned";
+    case BufferPoolMetric::NUM_METRICS:
+      break;
+  }
+  return "unknown";
+}
+
+std::string BufferPoolMetricsSnapshot::ToString() const {
+  std::ostringstream os;
+  for (size_t i = 0; i < counters_.size(); i++) {
+    os << GetName(static_cast<BufferPoolMetric>(i)) << " " << counters_[i] << "\n";
+  }
+  os << "hit_ratio " << HitRatio() << "\n";
+  os << "mean_victim_scan_length " << MeanVictimScanLength() << "\n";
+  os << "miss_latency_us p50<=" << MissLatencyPercentile(0.5) << " p99<=" << MissLatencyPercentile(0.99) << "\n";
+  for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++) {
+    if (miss_latency_[i] > 0) {
+      os << "miss_latency_us[" << (i == 0 ? 0 : uint64_t{1} << (i - 1)) << "," << (uint64_t{1} << i) << ") "
+         << miss_latency_[i] << "\n";
+    }
+  }
+  return os.str();
+}
+
+void BufferPoolMetrics::RecordMissLatency(std::chrono::nanoseconds latency) {
+  auto us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+  size_t bucket = 0;
+  while (us > 0 && bucket < NUM_LATENCY_BUCKETS - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  stripes_[GetStripeIndex()].miss_latency_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+BufferPoolMetricsSnapshot BufferPoolMetrics::Snapshot() const {
+  BufferPoolMetricsSnapshot snapshot;
+  for (const Stripe &stripe : stripes_) {
+    for (size_t i = 0; i < snapshot.counters_.size(); i++) {
+      snapshot.counters_[i] += stripe.counters_[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++) {
+      snapshot.miss_latency_[i] += stripe.miss_latency_[i].load(std::memory_order_relaxed);
+    }
+  }
+  return snapshot;
+}
+
+size_t BufferPoolMetrics::GetStripeIndex() {
+  // Threads are dealt stripes round-robin on their first event, so up to BUFFER_POOL_METRICS_STRIPES threads never
+  // share a cache line.
+  static std::atomic<size_t> next_stripe{0};
+  thread_local size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % BUFFER_POOL_METRICS_STRIPES;
+  return stripe;
+}
+
+}  // namespace bustub
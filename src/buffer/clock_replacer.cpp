@@ -12,50 +12,151 @@
 
 #include "buffer/clock_replacer.h"
 
-using namespace std;
+#include <algorithm>
+
+#include "common/macros.h"
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {
-    candidates = new list<int>;
-    candidate_attendance = new vector<int>(num_pages, 0);
+ClockReplacer::ClockReplacer(size_t num_pages, size_t max_pages)
+    : frames_(std::max(num_pages, max_pages)), num_frames_(num_pages) {}
+
+ClockReplacer::~ClockReplacer() = default;
+
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock latch{latch_};
+
+  // Every pass takes a credit from every evictable frame it passes, so the hand stops within one revolution more than
+  // the largest credit at the latest, unless concurrent unpins keep granting credits.
+  size_t num_scanned = 0;
+  while (size_ > 0) {
+    FrameState &frame = frames_[hand_];
+    const size_t current = hand_;
+    hand_ = (hand_ + 1) % num_frames_;
+    num_scanned++;
+    if (!frame.evictable_.load(std::memory_order_relaxed)) {
+      continue;
+    }
+    if (SpendCredit(&frame)) {
+      continue;
+    }
+    // The frame may have been pinned since it was checked.
+    if (frame.evictable_.exchange(false)) {
+      size_--;
+      ResetPriority(&frame);
+      *frame_id = static_cast<frame_id_t>(current);
+      RecordFramesScanned(num_scanned);
+      return true;
+    }
+  }
+  RecordFramesScanned(num_scanned);
+  return false;
 }
 
-ClockReplacer::~ClockReplacer() {
-    delete candidates;
-    delete candidate_attendance;
+bool ClockReplacer::SpendCredit(FrameState *frame) {
+  uint8_t credits = frame->credits_.load(std::memory_order_relaxed);
+  // A plain decrement could wrap around if a concurrent unpin of a temp page reset the credits to 0.
+  while (credits > 0 && !frame->credits_.compare_exchange_weak(credits, credits - 1, std::memory_order_relaxed)) {
+  }
+  return credits > 0;
 }
 
-bool ClockReplacer::Victim(frame_id_t *frame_id) { 
-    if (candidates->size() == 0) {
-        return false;
-    }
+bool ClockReplacer::PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer,
+                                    size_t lookahead) {
+  std::scoped_lock latch{latch_};
 
-    int victim_id = candidates->front();
-    candidates->pop_front();
-    *frame_id = victim_id;
-    candidate_attendance->at(victim_id) = 0;
-    return true;
+  // Sweep like Victim, but treat the first lookahead frames that Victim would return as candidates. Credits are only
+  // granted by concurrent unpins during the sweep, so it meets at most a handful of frames twice before considering
+  // enough candidates. Frames that are passed over stay evictable without credits.
+  size_t num_scanned = 0;
+  while (size_ > 0) {
+    const size_t max_candidates = std::min<size_t>(lookahead, size_);
+    size_t first_candidate = num_frames_;
+    size_t chosen = num_frames_;
+    size_t num_candidates = 0;
+    while (chosen == num_frames_ && size_ > 0) {
+      FrameState &frame = frames_[hand_];
+      const size_t current = hand_;
+      hand_ = (hand_ + 1) % num_frames_;
+      num_scanned++;
+      if (!frame.evictable_.load(std::memory_order_relaxed)) {
+        continue;
+      }
+      if (SpendCredit(&frame)) {
+        continue;
+      }
+      if (prefer(static_cast<frame_id_t>(current))) {
+        chosen = current;
+      } else if (first_candidate == num_frames_) {
+        first_candidate = current;
+      }
+      if (++num_candidates >= max_candidates && chosen == num_frames_) {
+        chosen = first_candidate;
+      }
+    }
+    // The chosen frame may have been pinned since it was checked; sweep again in that case.
+    if (chosen != num_frames_ && frames_[chosen].evictable_.exchange(false)) {
+      size_--;
+      ResetPriority(&frames_[chosen]);
+      *frame_id = static_cast<frame_id_t>(chosen);
+      RecordFramesScanned(num_scanned);
+      return true;
+    }
+  }
+  RecordFramesScanned(num_scanned);
+  return false;
 }
 
 void ClockReplacer::Pin(frame_id_t frame_id) {
-    if (candidate_attendance->at(frame_id) == 1) {
-            candidates->remove(frame_id);
-            candidate_attendance->at(frame_id) = 0;
-    }
+  if (frames_.at(frame_id).evictable_.exchange(false)) {
+    size_--;
+  }
 }
 
 void ClockReplacer::Unpin(frame_id_t frame_id) {
-    // add to the clock replacer vec
-    if (candidate_attendance->at(frame_id)) {
-        return;
+  FrameState &frame = frames_.at(frame_id);
+  frame.credits_.store(PRIORITY_CREDITS[static_cast<size_t>(frame.priority_.load(std::memory_order_relaxed))],
+                       std::memory_order_relaxed);
+  if (!frame.evictable_.exchange(true)) {
+    size_++;
+  }
+}
+
+void ClockReplacer::SetPriority(frame_id_t frame_id, PagePriority priority) {
+  frames_.at(frame_id).priority_.store(priority, std::memory_order_relaxed);
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  Pin(frame_id);
+  ResetPriority(&frames_.at(frame_id));
+}
+
+size_t ClockReplacer::Size() { return size_; }
+
+void ClockReplacer::GetAccessOrder(std::vector<frame_id_t> *frames) {
+  std::scoped_lock latch{latch_};
+  // Pinned frames are in use, and frames with credits left were used since the hand last took their last credit. The
+  // rest rank by how long ago the hand took it: the frame right behind the hand most recently.
+  std::vector<frame_id_t> unreferenced;
+  for (size_t i = 1; i <= num_frames_; i++) {
+    size_t frame_id = (hand_ + num_frames_ - i) % num_frames_;
+    const FrameState &frame = frames_[frame_id];
+    if (!frame.evictable_.load(std::memory_order_relaxed) || frame.credits_.load(std::memory_order_relaxed) > 0) {
+      frames->push_back(static_cast<frame_id_t>(frame_id));
+    } else {
+      unreferenced.push_back(static_cast<frame_id_t>(frame_id));
     }
-    candidates->push_back(frame_id);
-    candidate_attendance->at(frame_id) = 1;
+  }
+  frames->insert(frames->end(), unreferenced.begin(), unreferenced.end());
 }
 
-size_t ClockReplacer::Size() {
-    return candidates->size();
- }
+void ClockReplacer::Resize(size_t num_frames) {
+  std::scoped_lock latch{latch_};
+  BUSTUB_ASSERT(num_frames <= frames_.size(), "The replacer cannot grow beyond its maximum size.");
+  num_frames_ = num_frames;
+  if (hand_ >= num_frames_) {
+    hand_ = 0;
+  }
+}
 
 }  // namespace bustub
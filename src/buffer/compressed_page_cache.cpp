@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <cstring>
+
+#include "common/util/lz_compressor.h"
+
+namespace bustub {
+
+CompressedPageCache::CompressedPageCache(size_t capacity) : capacity_(capacity), arena_(new char[capacity]) {}
+
+bool CompressedPageCache::Insert(page_id_t page_id, const char *page_data) {
+  // Compress outside the latch; only the copy into the arena is serialized.
+  char compressed[PAGE_SIZE];
+  size_t size = LZCompressor::Compress(page_data, PAGE_SIZE, compressed, PAGE_SIZE - 1);
+
+  std::scoped_lock latch{latch_};
+  auto it = entries_.find(page_id);
+  if (it != entries_.end()) {
+    EraseEntry(it);
+  }
+  if (size == 0 || size > capacity_) {
+    return false;
+  }
+  size_t offset = Allocate(size);
+  memcpy(arena_.get() + offset, compressed, size);
+  log_.emplace_back(page_id, offset);
+  entries_[page_id] = {offset, size};
+  bytes_stored_ += size;
+  return true;
+}
+
+bool CompressedPageCache::Lookup(page_id_t page_id, char *page_data) {
+  std::scoped_lock latch{latch_};
+  auto it = entries_.find(page_id);
+  if (it == entries_.end()) {
+    return false;
+  }
+  size_t page_size;
+  bool decompressed = LZCompressor::Decompress(arena_.get() + it->second.offset_, it->second.size_, page_data,
+                                               PAGE_SIZE, &page_size) &&
+                      page_size == PAGE_SIZE;
+  EraseEntry(it);
+  return decompressed;
+}
+
+void CompressedPageCache::Erase(page_id_t page_id) {
+  std::scoped_lock latch{latch_};
+  auto it = entries_.find(page_id);
+  if (it != entries_.end()) {
+    EraseEntry(it);
+  }
+}
+
+size_t CompressedPageCache::GetNumPages() {
+  std::scoped_lock latch{latch_};
+  return entries_.size();
+}
+
+size_t CompressedPageCache::GetBytesStored() {
+  std::scoped_lock latch{latch_};
+  return bytes_stored_;
+}
+
+double CompressedPageCache::GetCompressionRatio() {
+  std::scoped_lock latch{latch_};
+  if (bytes_stored_ == 0) {
+    return 0;
+  }
+  return static_cast<double>(entries_.size() * PAGE_SIZE) / static_cast<double>(bytes_stored_);
+}
+
+size_t CompressedPageCache::Allocate(size_t size) {
+  // Log entries that are still in the arena lie in [tail_, capacity_) from the previous lap, followed by [0, tail_)
+  // from the current one. A write at the tail overwrites the oldest entries of the previous lap.
+  size_t start = tail_;
+  if (start + size > capacity_) {
+    // Wrap around. The rest of the previous lap is older than anything that is about to be overwritten.
+    while (!log_.empty() && log_.front().second >= tail_) {
+      auto it = entries_.find(log_.front().first);
+      if (it != entries_.end() && it->second.offset_ == log_.front().second) {
+        EraseEntry(it);
+      }
+      log_.pop_front();
+    }
+    start = 0;
+  }
+  while (!log_.empty() && log_.front().second >= start && log_.front().second < start + size) {
+    auto it = entries_.find(log_.front().first);
+    if (it != entries_.end() && it->second.offset_ == log_.front().second) {
+      EraseEntry(it);
+    }
+    log_.pop_front();
+  }
+  tail_ = start + size;
+  return start;
+}
+
+void CompressedPageCache::EraseEntry(std::unordered_map<page_id_t, Entry>::iterator it) {
+  bytes_stored_ -= it->second.size_;
+  entries_.erase(it);
+}
+
+}  // namespace bustub
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table.cpp
+//
+// Identification: src/buffer/concurrent_page_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/concurrent_page_table.h"
+
+namespace bustub {
+
+ConcurrentPageTable::ConcurrentPageTable(size_t max_entries) {
+  tables_.push_back(MakeTable(max_entries));
+  current_.store(tables_.back().get(), std::memory_order_release);
+}
+
+std::unique_ptr<ConcurrentPageTable::Table> ConcurrentPageTable::MakeTable(size_t max_entries) {
+  // Keep the load factor at or below one half, so that probe sequences stay short.
+  auto table = std::make_unique<Table>();
+  table->capacity_ = 16;
+  while (table->capacity_ < 2 * max_entries) {
+    table->capacity_ *= 2;
+  }
+  table->mask_ = table->capacity_ - 1;
+  table->slots_ = std::make_unique<std::atomic<uint64_t>[]>(table->capacity_);
+  for (size_t i = 0; i < table->capacity_; i++) {
+    table->slots_[i].store(EMPTY, std::memory_order_relaxed);
+  }
+  return table;
+}
+
+void ConcurrentPageTable::Reserve(size_t max_entries) {
+  if (2 * max_entries <= tables_.back()->capacity_) {
+    return;
+  }
+  std::unique_ptr<Table> table = MakeTable(max_entries);
+  ForEach([&](page_id_t page_id, frame_id_t frame_id) { InsertInto(table.get(), page_id, frame_id); });
+  tables_.push_back(std::move(table));
+  current_.store(tables_.back().get(), std::memory_order_release);
+}
+
+size_t ConcurrentPageTable::HomeSlot(const Table &table, page_id_t page_id) {
+  // Fibonacci hashing spreads the mostly consecutive page ids over the whole table.
+  return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >> 32) &
+         table.mask_;
+}
+
+bool ConcurrentPageTable::Find(page_id_t page_id, frame_id_t *frame_id) const {
+  const Table &table = *current_.load(std::memory_order_acquire);
+  for (size_t i = HomeSlot(table, page_id);; i = (i + 1) & table.mask_) {
+    uint64_t slot = table.slots_[i].load(std::memory_order_acquire);
+    if (slot == EMPTY) {
+      return false;
+    }
+    if (UnpackPageId(slot) == page_id) {
+      *frame_id = UnpackFrameId(slot);
+      return true;
+    }
+  }
+}
+
+void ConcurrentPageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Invalid page ids cannot be mapped.");
+  BUSTUB_ASSERT(size_ < tables_.back()->capacity_ / 2, "The page table holds more entries than it was sized for.");
+  InsertInto(tables_.back().get(), page_id, frame_id);
+  size_++;
+}
+
+void ConcurrentPageTable::InsertInto(Table *table, page_id_t page_id, frame_id_t frame_id) {
+  size_t i = HomeSlot(*table, page_id);
+  while (table->slots_[i].load(std::memory_order_relaxed) != EMPTY) {
+    BUSTUB_ASSERT(UnpackPageId(table->slots_[i].load(std::memory_order_relaxed)) != page_id,
+                  "The page is already mapped.");
+    i = (i + 1) & table->mask_;
+  }
+  table->slots_[i].store(Pack(page_id, frame_id), std::memory_order_release);
+}
+
+bool ConcurrentPageTable::Erase(page_id_t page_id) {
+  Table &table = *tables_.back();
+  size_t hole = HomeSlot(table, page_id);
+  while (true) {
+    uint64_t slot = table.slots_[hole].load(std::memory_order_relaxed);
+    if (slot == EMPTY) {
+      return false;
+    }
+    if (UnpackPageId(slot) == page_id) {
+      break;
+    }
+    hole = (hole + 1) & table.mask_;
+  }
+
+  // Backward-shift deletion: move later entries of the probe run into the hole if their home slot allows it. Each
+  // entry is copied before its old slot is cleared, so a concurrent Find sees it at least once or, at worst, misses it.
+  for (size_t i = (hole + 1) & table.mask_;; i = (i + 1) & table.mask_) {
+    uint64_t slot = table.slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY) {
+      break;
+    }
+    size_t home = HomeSlot(table, UnpackPageId(slot));
+    // The entry may move to the hole only if the hole lies cyclically within [home, i).
+    if (((i - home) & table.mask_) >= ((i - hole) & table.mask_)) {
+      table.slots_[hole].store(slot, std::memory_order_release);
+      hole = i;
+    }
+  }
+  table.slots_[hole].store(EMPTY, std::memory_order_release);
+  size_--;
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+FrameArena::FrameArena(size_t num_frames, bool use_huge_pages, size_t max_frames)
+    : max_frames_(std::max(num_frames, max_frames)) {
+  const size_t size = max_frames_ * PAGE_SIZE;
+  const int reserve_flags = max_frames_ > num_frames ? MAP_NORESERVE : 0;
+
+  if (use_huge_pages && reserve_flags == 0) {
+    // Explicit huge pages need the mapping length to be a multiple of the huge page size.
+    const size_t huge_size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    void *mapping = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mapping != MAP_FAILED) {
+      mapping_ = base_ = static_cast<char *>(mapping);
+      mapping_size_ = huge_size;
+      backing_ = HugePageBacking::HUGETLB;
+      return;
+    }
+  }
+  if (use_huge_pages) {
+    // Transparent huge pages only cover 2 MB-aligned ranges, so over-allocate and align the start.
+    void *mapping = mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | reserve_flags, -1, 0);
+    if (mapping != MAP_FAILED) {
+      mapping_ = static_cast<char *>(mapping);
+      mapping_size_ = size + HUGE_PAGE_SIZE;
+      auto aligned = (reinterpret_cast<uintptr_t>(mapping_) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+      base_ = reinterpret_cast<char *>(aligned);
+      backing_ = madvise(base_, size, MADV_HUGEPAGE) == 0 ? HugePageBacking::TRANSPARENT : HugePageBacking::NONE;
+      return;
+    }
+  } else {
+    void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | reserve_flags, -1, 0);
+    if (mapping != MAP_FAILED) {
+      mapping_ = base_ = static_cast<char *>(mapping);
+      mapping_size_ = size;
+      // Keep the kernel from using huge pages behind our back, so that the two modes can be compared.
+      madvise(base_, size, MADV_NOHUGEPAGE);
+      return;
+    }
+  }
+
+  throw Exception(ExceptionType::OUT_OF_MEMORY,
+                  "Cannot map a frame arena of " + std::to_string(max_frames_) + " frames.");
+}
+
+void FrameArena::Release(frame_id_t first_frame, size_t num_frames) {
+  auto begin = reinterpret_cast<uintptr_t>(GetFrame(first_frame));
+  auto end = begin + num_frames * PAGE_SIZE;
+  if (backing_ == HugePageBacking::HUGETLB) {
+    // Explicit huge pages can only be released whole.
+    begin = (begin + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    end &= ~(HUGE_PAGE_SIZE - 1);
+  }
+  if (begin < end) {
+    madvise(reinterpret_cast<void *>(begin), end - begin, MADV_DONTNEED);
+  }
+}
+
+FrameArena::~FrameArena() { munmap(mapping_, mapping_size_); }
+
+}  // namespace bustub
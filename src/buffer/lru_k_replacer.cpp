@@ -0,0 +1,199 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, size_t max_pages)
+    : k_(k), frames_(std::max(num_pages, max_pages)), pending_(frames_.size() * k), num_frames_(num_pages) {
+  BUSTUB_ASSERT(k > 0, "LRU-K needs to remember at least one access per frame.");
+}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock latch{latch_};
+  auto victim = FindVictim([](frame_id_t) { return false; }, 1);
+  if (victim == evictable_.end()) {
+    return false;
+  }
+  *frame_id = std::get<2>(*victim);
+  frames_[*frame_id].evictable_ = false;
+  evictable_.erase(victim);
+  ForgetHistory(*frame_id);
+  return true;
+}
+
+bool LRUKReplacer::PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer,
+                                   size_t lookahead) {
+  std::scoped_lock latch{latch_};
+  auto victim = FindVictim(prefer, lookahead);
+  if (victim == evictable_.end()) {
+    return false;
+  }
+  // Unlike Victim, the victim keeps its history until the caller removes it: the caller may find the frame pinned and
+  // pass it over, and a frame that is still in use must not look cold when it is unpinned.
+  *frame_id = std::get<2>(*victim);
+  frames_[*frame_id].evictable_ = false;
+  evictable_.erase(victim);
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock latch{latch_};
+  FrameInfo &frame = frames_.at(frame_id);
+  if (frame.evictable_) {
+    evictable_.erase(GetEvictionKey(frame_id));
+    frame.evictable_ = false;
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  FrameInfo &frame = frames_.at(frame_id);
+  if (frame.evictable_) {
+    return;
+  }
+  std::scoped_lock latch{latch_};
+  if (frame.evictable_) {
+    return;
+  }
+  ApplyPendingAccesses(frame_id);
+  // A frame that was never accessed is treated as if it was accessed just now.
+  if (frame.history_.empty()) {
+    frame.history_.push_back(current_timestamp_.fetch_add(1, std::memory_order_relaxed));
+    frame.applied_until_ = frame.history_.back() + 1;
+  }
+  frame.evictable_ = true;
+  evictable_.insert(GetEvictionKey(frame_id));
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  FrameInfo &frame = frames_.at(frame_id);
+  const uint64_t timestamp = current_timestamp_.fetch_add(1, std::memory_order_relaxed);
+  const uint64_t slot = frame.num_recorded_.fetch_add(1, std::memory_order_relaxed) % k_;
+  pending_[frame_id * k_ + slot].store(timestamp, std::memory_order_relaxed);
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock latch{latch_};
+  FrameInfo &frame = frames_.at(frame_id);
+  if (frame.evictable_) {
+    evictable_.erase(GetEvictionKey(frame_id));
+    frame.evictable_ = false;
+  }
+  ForgetHistory(frame_id);
+}
+
+size_t LRUKReplacer::Size() {
+  std::scoped_lock latch{latch_};
+  return evictable_.size();
+}
+
+void LRUKReplacer::GetAccessOrder(std::vector<frame_id_t> *frames) {
+  std::scoped_lock latch{latch_};
+  std::vector<std::pair<uint64_t, frame_id_t>> last_accesses;
+  for (size_t i = 0; i < num_frames_; i++) {
+    auto frame_id = static_cast<frame_id_t>(i);
+    ApplyPendingAccesses(frame_id);
+    if (!frames_[i].history_.empty()) {
+      last_accesses.emplace_back(frames_[i].history_.back(), frame_id);
+    }
+  }
+  std::sort(last_accesses.begin(), last_accesses.end(), std::greater<>());
+  for (const auto &last_access : last_accesses) {
+    frames->push_back(last_access.second);
+  }
+}
+
+void LRUKReplacer::Resize(size_t num_frames) {
+  std::scoped_lock latch{latch_};
+  BUSTUB_ASSERT(num_frames <= frames_.size(), "The replacer cannot grow beyond its maximum size.");
+  for (size_t i = num_frames; i < num_frames_; i++) {
+    BUSTUB_ASSERT(!frames_[i].evictable_, "Frames must be removed from the replacer before it shrinks.");
+  }
+  num_frames_ = num_frames;
+}
+
+LRUKReplacer::EvictionKey LRUKReplacer::GetEvictionKey(frame_id_t frame_id) const {
+  const FrameInfo &frame = frames_[frame_id];
+  return {frame.history_.size() >= k_, frame.history_.front(), frame_id};
+}
+
+bool LRUKReplacer::ApplyPendingAccesses(frame_id_t frame_id) {
+  FrameInfo &frame = frames_[frame_id];
+  // Every access in the history is older than every pending one, so only the pending ones need sorting.
+  const size_t num_applied = frame.history_.size();
+  for (size_t i = 0; i < k_; i++) {
+    uint64_t timestamp = pending_[frame_id * k_ + i].load(std::memory_order_relaxed);
+    if (timestamp >= frame.applied_until_) {
+      frame.history_.push_back(timestamp);
+    }
+  }
+  if (frame.history_.size() == num_applied) {
+    return false;
+  }
+  // The key of an evictable frame changes, so its entry has to move.
+  if (frame.evictable_) {
+    evictable_.erase({num_applied >= k_, frame.history_.front(), frame_id});
+  }
+  std::sort(frame.history_.begin() + num_applied, frame.history_.end());
+  frame.applied_until_ = frame.history_.back() + 1;
+  if (frame.history_.size() > k_) {
+    frame.history_.erase(frame.history_.begin(), frame.history_.end() - k_);
+  }
+  if (frame.evictable_) {
+    evictable_.insert(GetEvictionKey(frame_id));
+  }
+  return true;
+}
+
+void LRUKReplacer::ForgetHistory(frame_id_t frame_id) {
+  FrameInfo &frame = frames_[frame_id];
+  frame.history_.clear();
+  frame.applied_until_ = current_timestamp_.load(std::memory_order_relaxed);
+}
+
+std::set<LRUKReplacer::EvictionKey>::iterator LRUKReplacer::FindVictim(const std::function<bool(frame_id_t)> &prefer,
+                                                                       size_t lookahead) {
+  // Peek at the candidates in place, so that the ones passed over keep their access history. A candidate with pending
+  // accesses moves back in the order, past candidates that were already considered, so the search goes on from the
+  // entry after its old key.
+  auto victim = evictable_.end();
+  size_t considered = 0;
+  auto it = evictable_.begin();
+  while (it != evictable_.end() && considered < lookahead) {
+    const EvictionKey key = *it;
+    const frame_id_t candidate = std::get<2>(key);
+    if (ApplyPendingAccesses(candidate)) {
+      it = evictable_.upper_bound(key);
+      continue;
+    }
+    ++considered;
+    if (victim == evictable_.end()) {
+      victim = it;
+    }
+    if (prefer(candidate)) {
+      victim = it;
+      break;
+    }
+    ++it;
+  }
+  RecordFramesScanned(considered);
+  return victim;
+}
+
+}  // namespace bustub
@@ -0,0 +1,205 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <string>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     LogManager *log_manager, ReplacerType replacer_type) {
+  BUSTUB_ASSERT(num_instances > 0, "A parallel buffer pool needs at least one instance.");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, log_manager,
+        replacer_type));
+  }
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  size_t pool_size = 0;
+  for (auto &instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+bool ParallelBufferPoolManager::Resize(size_t pool_size) {
+  const size_t instance_pool_size = (pool_size + instances_.size() - 1) / instances_.size();
+  bool resized = true;
+  for (auto &instance : instances_) {
+    resized = instance->Resize(instance_pool_size) && resized;
+  }
+  return resized;
+}
+
+BufferPoolMetricsSnapshot ParallelBufferPoolManager::GetMetrics() {
+  BufferPoolMetricsSnapshot snapshot;
+  for (auto &instance : instances_) {
+    snapshot.Merge(instance->GetMetrics());
+  }
+  return snapshot;
+}
+
+void ParallelBufferPoolManager::RunBackgroundWriter(const BackgroundWriterOptions &options) {
+  for (auto &instance : instances_) {
+    instance->RunBackgroundWriter(options);
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  for (auto &instance : instances_) {
+    instance->StopBackgroundWriter();
+  }
+}
+
+bool ParallelBufferPoolManager::DumpResidentPages(const std::string &file_name) {
+  bool dumped = true;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    dumped = instances_[i]->DumpResidentPages(file_name + "." + std::to_string(i)) && dumped;
+  }
+  return dumped;
+}
+
+size_t ParallelBufferPoolManager::LoadResidentPages(const std::string &file_name) {
+  size_t num_loaded = 0;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    num_loaded += instances_[i]->LoadResidentPages(file_name + "." + std::to_string(i));
+  }
+  return num_loaded;
+}
+
+void ParallelBufferPoolManager::RunWarmRestart(const std::string &file_name, std::chrono::milliseconds dump_interval) {
+  for (size_t i = 0; i < instances_.size(); i++) {
+    instances_[i]->RunWarmRestart(file_name + "." + std::to_string(i), dump_interval);
+  }
+}
+
+void ParallelBufferPoolManager::StopWarmRestart() {
+  for (auto &instance : instances_) {
+    instance->StopWarmRestart();
+  }
+}
+
+uint64_t ParallelBufferPoolManager::GetNumForegroundWrites() const {
+  uint64_t num_writes = 0;
+  for (const auto &instance : instances_) {
+    num_writes += instance->GetNumForegroundWrites();
+  }
+  return num_writes;
+}
+
+uint64_t ParallelBufferPoolManager::GetNumBackgroundWrites() const {
+  uint64_t num_writes = 0;
+  for (const auto &instance : instances_) {
+    num_writes += instance->GetNumBackgroundWrites();
+  }
+  return num_writes;
+}
+
+BufferPoolManagerInstance *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Invalid page ids do not belong to any instance.");
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, strategy);
+}
+
+bool ParallelBufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPageImpl(page_id_t *page_id, BufferAccessStrategy *strategy,
+                                             page_id_t near_page_id) {
+  // Concurrent callers may start from the same instance; that only affects balance, not correctness.
+  const size_t num_instances = instances_.size();
+  const size_t start = next_instance_.fetch_add(1) % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    BufferPoolManagerInstance *instance = instances_[(start + i) % num_instances].get();
+    Page *page = near_page_id == INVALID_PAGE_ID ? instance->NewPage(page_id, strategy)
+                                                 : instance->NewPageNear(page_id, near_page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  *page_id = INVALID_PAGE_ID;
+  return nullptr;
+}
+
+bool ParallelBufferPoolManager::DeletePageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPagesImpl() {
+  // Flushing the shards one by one would write no two neighbouring pages together and sync once per shard.
+  std::vector<BufferPoolManagerInstance *> instances;
+  for (auto &instance : instances_) {
+    instances.push_back(instance.get());
+  }
+  BufferPoolManagerInstance::Checkpoint(instances);
+}
+
+void ParallelBufferPoolManager::PrefetchPagesImpl(const std::vector<page_id_t> &page_ids) {
+  std::vector<std::vector<page_id_t>> per_instance(instances_.size());
+  for (page_id_t page_id : page_ids) {
+    if (page_id < 0) {
+      continue;
+    }
+    per_instance[static_cast<size_t>(page_id) % instances_.size()].push_back(page_id);
+  }
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (!per_instance[i].empty()) {
+      instances_[i]->PrefetchPages(per_instance[i]);
+    }
+  }
+}
+
+void ParallelBufferPoolManager::SetPagePriorityImpl(Page *page, PagePriority priority) {
+  GetBufferPoolManager(page->GetPageId())->SetPagePriority(page, priority);
+}
+
+size_t ParallelBufferPoolManager::FetchPagesImpl(const page_id_t *page_ids, size_t num_pages, Page **pages) {
+  // Positions in the caller's arrays of the pages owned by each instance.
+  std::vector<std::vector<size_t>> per_instance(instances_.size());
+  for (size_t i = 0; i < num_pages; i++) {
+    per_instance[static_cast<size_t>(page_ids[i]) % instances_.size()].push_back(i);
+  }
+  size_t num_fetched = 0;
+  std::vector<page_id_t> instance_page_ids;
+  std::vector<Page *> instance_pages;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (per_instance[i].empty()) {
+      continue;
+    }
+    instance_page_ids.clear();
+    for (size_t position : per_instance[i]) {
+      instance_page_ids.push_back(page_ids[position]);
+    }
+    instance_pages.resize(instance_page_ids.size());
+    num_fetched += instances_[i]->FetchPages(instance_page_ids.data(), instance_page_ids.size(), instance_pages.data());
+    for (size_t j = 0; j < per_instance[i].size(); j++) {
+      pages[per_instance[i][j]] = instance_pages[j];
+    }
+  }
+  return num_fetched;
+}
+
+}  // namespace bustub
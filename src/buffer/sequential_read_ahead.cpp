@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sequential_read_ahead.cpp
+//
+// Identification: src/buffer/sequential_read_ahead.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/sequential_read_ahead.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace bustub {
+
+void SequentialReadAhead::OnAdvance(page_id_t from_page_id, page_id_t to_page_id) {
+  if (window_ == 0 || from_page_id == INVALID_PAGE_ID || to_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+
+  const page_id_t stride = to_page_id - from_page_id;
+  if (stride != stride_ || stride == 0) {
+    // The pattern broke; start a new run at this page.
+    stride_ = stride;
+    frontier_ = to_page_id;
+    return;
+  }
+
+  // Top the window up only once half of it has been consumed, so that prefetches are issued in batches.
+  const auto pages_ahead = static_cast<size_t>(std::max<page_id_t>((frontier_ - to_page_id) / stride_, 0));
+  if (pages_ahead > window_ / 2) {
+    return;
+  }
+  std::vector<page_id_t> page_ids;
+  for (size_t i = pages_ahead + 1; i <= window_; i++) {
+    page_id_t page_id = to_page_id + static_cast<page_id_t>(i) * stride_;
+    if (page_id < 0) {
+      break;
+    }
+    page_ids.push_back(page_id);
+  }
+  if (!page_ids.empty()) {
+    frontier_ = page_ids.back();
+    num_prefetched_ += page_ids.size();
+    buffer_pool_manager_->PrefetchPages(page_ids);
+  }
+}
+
+}  // namespace bustub
@@ -20,4 +20,16 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+bool buffer_pool_use_huge_pages = true;
+
+size_t buffer_pool_max_frames = 1 << 18;
+
+size_t buffer_pool_compressed_cache_size = 0;
+
+bool buffer_pool_zero_copy = false;
+
+bool disk_manager_use_io_uring = true;
+
+size_t disk_manager_extent_pages = 256;
+
 }  // namespace bustub
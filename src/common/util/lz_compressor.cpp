@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_compressor.cpp
+//
+// Identification: src/common/util/lz_compressor.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/lz_compressor.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+uint32_t Read32(const char *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+/** Writes a length in the continuation format: bytes of 255, then a final byte smaller than 255. */
+bool WriteLength(size_t length, char *dst, size_t dst_capacity, size_t *op) {
+  while (length >= 255) {
+    if (*op >= dst_capacity) {
+      return false;
+    }
+    dst[(*op)++] = static_cast<char>(255);
+    length -= 255;
+  }
+  if (*op >= dst_capacity) {
+    return false;
+  }
+  dst[(*op)++] = static_cast<char>(length);
+  return true;
+}
+
+/** Reads a length in the continuation format and adds it to length. */
+bool ReadLength(const unsigned char *src, size_t src_size, size_t *ip, size_t *length) {
+  unsigned char byte;
+  do {
+    if (*ip >= src_size) {
+      return false;
+    }
+    byte = src[(*ip)++];
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/**
+ * Writes one sequence: the token, the literals and, unless this is the last sequence, the match.
+ * @return false if dst is too small
+ */
+bool WriteSequence(const char *literals, size_t num_literals, size_t offset, size_t match_length, bool last, char *dst,
+                   size_t dst_capacity, size_t *op) {
+  if (*op >= dst_capacity) {
+    return false;
+  }
+  const size_t token_position = (*op)++;
+  unsigned char token = static_cast<unsigned char>(std::min<size_t>(num_literals, 15) << 4);
+  if (num_literals >= 15 && !WriteLength(num_literals - 15, dst, dst_capacity, op)) {
+    return false;
+  }
+  if (*op + num_literals > dst_capacity) {
+    return false;
+  }
+  memcpy(dst + *op, literals, num_literals);
+  *op += num_literals;
+
+  if (!last) {
+    if (*op + 2 > dst_capacity) {
+      return false;
+    }
+    dst[(*op)++] = static_cast<char>(offset & 0xFF);
+    dst[(*op)++] = static_cast<char>(offset >> 8);
+    token |= static_cast<unsigned char>(std::min<size_t>(match_length, 15));
+    if (match_length >= 15 && !WriteLength(match_length - 15, dst, dst_capacity, op)) {
+      return false;
+    }
+  }
+  dst[token_position] = static_cast<char>(token);
+  return true;
+}
+
+}  // namespace
+
+size_t LZCompressor::Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) {
+  // Positions of the last occurrence of each hashed 4-byte sequence, plus one so that zero means "none".
+  std::array<uint32_t, 1 << HASH_BITS> table{};
+  size_t op = 0;
+  size_t anchor = 0;
+  size_t ip = 0;
+
+  while (ip + MIN_MATCH + LAST_LITERALS <= src_size) {
+    const uint32_t sequence = Read32(src + ip);
+    const uint32_t hash = (sequence * 2654435761U) >> (32 - HASH_BITS);
+    const size_t candidate = table[hash];
+    table[hash] = static_cast<uint32_t>(ip + 1);
+    if (candidate == 0 || ip - (candidate - 1) > MAX_OFFSET || Read32(src + candidate - 1) != sequence) {
+      ip++;
+      continue;
+    }
+
+    const size_t match = candidate - 1;
+    size_t length = MIN_MATCH;
+    while (ip + length < src_size - LAST_LITERALS && src[match + length] == src[ip + length]) {
+      length++;
+    }
+    if (!WriteSequence(src + anchor, ip - anchor, ip - match, length - MIN_MATCH, false, dst, dst_capacity, &op)) {
+      return 0;
+    }
+    ip += length;
+    anchor = ip;
+  }
+
+  if (!WriteSequence(src + anchor, src_size - anchor, 0, 0, true, dst, dst_capacity, &op)) {
+    return 0;
+  }
+  return op;
+}
+
+bool LZCompressor::Decompress(const char *src, size_t src_size, char *dst, size_t dst_capacity, size_t *dst_size) {
+  const auto *in = reinterpret_cast<const unsigned char *>(src);
+  size_t ip = 0;
+  size_t op = 0;
+
+  while (ip < src_size) {
+    const unsigned char token = in[ip++];
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !ReadLength(in, src_size, &ip, &num_literals)) {
+      return false;
+    }
+    if (num_literals > src_size - ip || num_literals > dst_capacity - op) {
+      return false;
+    }
+    memcpy(dst + op, src + ip, num_literals);
+    ip += num_literals;
+    op += num_literals;
+    if (ip == src_size) {
+      // The last sequence has no match.
+      break;
+    }
+
+    if (src_size - ip < 2) {
+      return false;
+    }
+    const size_t offset = in[ip] | (static_cast<size_t>(in[ip + 1]) << 8);
+    ip += 2;
+    size_t length = token & 0x0F;
+    if (length == 15 && !ReadLength(in, src_size, &ip, &length)) {
+      return false;
+    }
+    length += MIN_MATCH;
+    if (offset == 0 || offset > op || length > dst_capacity - op) {
+      return false;
+    }
+    // Matches may overlap their own output, e.g. to repeat a run of bytes, so they are copied front to back.
+    for (size_t i = 0; i < length; i++) {
+      dst[op + i] = dst[op - offset + i];
+    }
+    op += length;
+  }
+
+  *dst_size = op;
+  return true;
+}
+
+}  // namespace bustub
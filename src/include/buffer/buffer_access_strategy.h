@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class Page;
+
+/**
+ * BufferAccessStrategy lets a large sequential operation, e.g. a sequential scan or a bulk insert, run through a small
+ * private ring of frames instead of the whole buffer pool.
+ *
+ * When a fetch or new page with a strategy needs a frame, the buffer pool first tries to recycle the frame in the
+ * current ring slot. If that frame still holds the page the ring put there and nobody has it pinned, it is reused.
+ * Otherwise a frame is taken from the free list or the replacer as usual and remembered in the slot. The operation
+ * therefore evicts at most ring_size pages of the shared working set, no matter how many pages it touches.
+ *
+ * A strategy belongs to a single operation and is not thread-safe.
+ */
+class BufferAccessStrategy {
+  friend class BufferPoolManagerInstance;
+
+ public:
+  /**
+   * Creates a new BufferAccessStrategy.
+   * @param ring_size the number of frames the operation may occupy at once
+   */
+  explicit BufferAccessStrategy(size_t ring_size = BUFFER_ACCESS_STRATEGY_RING_SIZE) : ring_(ring_size) {
+    BUSTUB_ASSERT(ring_size > 0, "The ring needs at least one slot.");
+  }
+
+  DISALLOW_COPY(BufferAccessStrategy);
+
+  /** @return the number of frames in the ring */
+  size_t GetRingSize() const { return ring_.size(); }
+
+ private:
+  struct RingSlot {
+    /** The frame that the ring last placed a page in, nullptr if the slot is empty. */
+    Page *page_{nullptr};
+    /** The page that was placed in the frame, so that a frame taken over by someone else is not recycled. */
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /** Advances the ring and returns the slot that the next miss should use. */
+  RingSlot *NextSlot() {
+    current_ = (current_ + 1) % ring_.size();
+    return &ring_[current_];
+  }
+
+  std::vector<RingSlot> ring_;
+  size_t current_{0};
+};
+
+}  // namespace bustub
@@ -12,11 +12,12 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
-#include <unordered_map>
+#include <vector>
 
-#include "buffer/clock_replacer.h"
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_metrics.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -25,29 +26,24 @@ namespace bustub {
 
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * This is the interface that the rest of the system (table heaps, hash tables, executors) programs against. It is
+ * implemented by BufferPoolManagerInstance, which owns a single pool of frames, and by ParallelBufferPoolManager,
+ * which shards pages across several independent instances.
  */
 class BufferPoolManager {
  public:
   enum class CallbackType { BEFORE, AFTER };
   using bufferpool_callback_fn = void (*)(enum CallbackType, const page_id_t page_id);
 
-  /**
-   * Creates a new BufferPoolManager.
-   * @param pool_size the size of the buffer pool
-   * @param disk_manager the disk manager
-   * @param log_manager the log manager (for testing only: nullptr = disable logging)
-   */
-  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManager() = default;
 
-  /**
-   * Destroys an existing BufferPoolManager.
-   */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager() = default;
 
   /** Grading function. Do not modify! */
   Page *FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
-    auto *result = FetchPageImpl(page_id);
+    auto *result = FetchPageImpl(page_id, nullptr);
     GradingCallback(callback, CallbackType::AFTER, page_id);
     return result;
   }
@@ -71,7 +67,7 @@ class BufferPoolManager {
   /** Grading function. Do not modify! */
   Page *NewPage(page_id_t *page_id, bufferpool_callback_fn callback = nullptr) {
     GradingCallback(callback, CallbackType::BEFORE, INVALID_PAGE_ID);
-    auto *result = NewPageImpl(page_id);
+    auto *result = NewPageImpl(page_id, nullptr, INVALID_PAGE_ID);
     GradingCallback(callback, CallbackType::AFTER, *page_id);
     return result;
   }
@@ -91,13 +87,104 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
-  /** @return pointer to all the pages in the buffer pool */
-  Page *GetPages() { return pages_; }
+  /**
+   * Fetch the requested page, recycling frames from the strategy's ring on a miss.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the calling operation, nullptr to use the whole pool
+   * @return the requested page
+   */
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) { return FetchPageImpl(page_id, strategy); }
+
+  /**
+   * Creates a new page, recycling frames from the strategy's ring.
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy of the calling operation, nullptr to use the whole pool
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPage(page_id_t *page_id, BufferAccessStrategy *strategy) {
+    return NewPageImpl(page_id, strategy, INVALID_PAGE_ID);
+  }
+
+  /**
+   * Fetch the requested page and tag it with a priority class. See SetPagePriority.
+   * @param page_id id of page to be fetched
+   * @param priority the priority class of the page
+   * @return the requested page
+   */
+  Page *FetchPage(page_id_t page_id, PagePriority priority) {
+    Page *page = FetchPageImpl(page_id, nullptr);
+    if (page != nullptr) {
+      SetPagePriorityImpl(page, priority);
+    }
+    return page;
+  }
+
+  /**
+   * Creates a new page and tags it with a priority class. See SetPagePriority.
+   * @param[out] page_id id of created page
+   * @param priority the priority class of the page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPage(page_id_t *page_id, PagePriority priority) {
+    Page *page = NewPageImpl(page_id, nullptr, INVALID_PAGE_ID);
+    if (page != nullptr) {
+      SetPagePriorityImpl(page, priority);
+    }
+    return page;
+  }
+
+  /**
+   * Creates a new page close to another one on disk, reusing a free page near it if there is one, so that pages of one
+   * table or index stay clustered and scans of them read neighbouring pages.
+   * @param[out] page_id id of created page
+   * @param near_page_id a page that the new page should be close to, e.g. the previous page of the same table
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPageNear(page_id_t *page_id, page_id_t near_page_id) { return NewPageImpl(page_id, nullptr, near_page_id); }
+
+  /**
+   * Tags a pinned page with a priority class. The replacer evicts pages of lower classes first, e.g. heap pages before
+   * index pages, but ages all of them so that none starves. The class sticks to the page while it is resident, and
+   * fetches without a class leave it alone; a page that is read in again starts out as HEAP.
+   * @param page a page that the caller has pinned
+   * @param priority the priority class of the page
+   */
+  void SetPagePriority(Page *page, PagePriority priority) { SetPagePriorityImpl(page, priority); }
+
+  /**
+   * Asks the buffer pool to load pages in the background, so that later fetches of them hit. This is only a hint:
+   * pages that are already resident, that are not allocated, or that cannot get a frame are skipped. Prefetched
+   * pages are left unpinned.
+   * @param page_ids ids of the pages that are likely to be fetched soon
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids) { PrefetchPagesImpl(page_ids); }
+
+  /**
+   * Fetches several pages at once. The pages that are not resident are read as one batch, sorted by page id, so that
+   * runs of neighbouring pages take a single read. Every fetched page is pinned once per occurrence in page_ids.
+   * @param page_ids ids of the pages to fetch
+   * @param num_pages number of pages to fetch
+   * @param[out] pages the fetched pages, in the order of page_ids; nullptr where no frame could be found
+   * @return the number of pages that were fetched
+   */
+  size_t FetchPages(const page_id_t *page_ids, size_t num_pages, Page **pages) {
+    return FetchPagesImpl(page_ids, num_pages, pages);
+  }
+
+  /** @return size of the buffer pool, in frames */
+  virtual size_t GetPoolSize() = 0;
+
+  /**
+   * Grows or shrinks the buffer pool while it is in use.
+   * @param pool_size the new size of the buffer pool, in frames
+   * @return false if the pool could not be resized, e.g. because pages in the frames to be removed are pinned
+   */
+  virtual bool Resize(size_t pool_size) = 0;
 
-  /** @return size of the buffer pool */
-  size_t GetPoolSize() { return pool_size_; }
+  /** @return the current values of the metrics of the buffer pool; diff two snapshots to get the activity in between */
+  virtual BufferPoolMetricsSnapshot GetMetrics() = 0;
 
- private:
+ protected:
   /**
    * Grading function. Do not modify!
    * Invokes the callback function if it is not null.
@@ -114,9 +201,10 @@ class BufferPoolManager {
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
+   * @param strategy the access strategy to take a frame from on a miss, nullptr to use the whole pool
    * @return the requested page
    */
-  Page *FetchPageImpl(page_id_t page_id);
+  virtual Page *FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) = 0;
 
   /**
    * Unpin the target page from the buffer pool.
@@ -124,49 +212,57 @@ class BufferPoolManager {
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page pin count is <= 0 before this call, true otherwise
    */
-  bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
+  virtual bool UnpinPageImpl(page_id_t page_id, bool is_dirty) = 0;
 
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  bool FlushPageImpl(page_id_t page_id);
+  virtual bool FlushPageImpl(page_id_t page_id) = 0;
 
   /**
    * Creates a new page in the buffer pool.
    * @param[out] page_id id of created page
+   * @param strategy the access strategy to take a frame from, nullptr to use the whole pool
+   * @param near_page_id a page that the new page should be close to on disk, or INVALID_PAGE_ID
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  Page *NewPageImpl(page_id_t *page_id);
+  virtual Page *NewPageImpl(page_id_t *page_id, BufferAccessStrategy *strategy, page_id_t near_page_id) = 0;
 
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  bool DeletePageImpl(page_id_t page_id);
-
-  /**
-   * Flushes all the pages in the buffer pool to disk.
-   */
-  void FlushAllPagesImpl();
-
-  /** Number of pages in the buffer pool. */
-  size_t pool_size_;
-  /** Array of buffer pool pages. */
-  Page *pages_;
-  /** Pointer to the disk manager. */
-  DiskManager *disk_manager_ __attribute__((__unused__));
-  /** Pointer to the log manager. */
-  LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  Replacer *replacer_;
-  /** List of free pages. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  virtual bool DeletePageImpl(page_id_t page_id) = 0;
+
+  /**
+   * Flushes all the dirty pages in the buffer pool to disk, and waits until they are durable.
+   */
+  virtual void FlushAllPagesImpl() = 0;
+
+  /**
+   * Queues pages to be read into the buffer pool asynchronously.
+   * @param page_ids ids of the pages to prefetch
+   */
+  virtual void PrefetchPagesImpl(const std::vector<page_id_t> &page_ids) = 0;
+
+  /**
+   * Fetches a batch of pages from the buffer pool.
+   * @param page_ids ids of the pages to fetch
+   * @param num_pages number of pages to fetch
+   * @param[out] pages the fetched pages, nullptr where no frame could be found
+   * @return the number of pages that were fetched
+   */
+  virtual size_t FetchPagesImpl(const page_id_t *page_ids, size_t num_pages, Page **pages) = 0;
+
+  /**
+   * Tags a pinned page with a priority class.
+   * @param page the page
+   * @param priority the priority class
+   */
+  virtual void SetPagePriorityImpl(Page *page, PagePriority priority) = 0;
 };
+
 }  // namespace bustub
@@ -0,0 +1,504 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance.h
+//
+// Identification: src/include/buffer/buffer_pool_manager_instance.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_metrics.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/concurrent_page_table.h"
+#include "buffer/frame_arena.h"
+#include "buffer/lru_k_replacer.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/write_scheduler.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * Tuning knobs for the background writer of a BufferPoolManagerInstance. The writer rate is at most
+ * max_pages_per_round_ pages every interval_.
+ */
+struct BackgroundWriterOptions {
+  /** Time the writer sleeps between two rounds. */
+  std::chrono::milliseconds interval_{BGWRITER_INTERVAL};
+  /** Maximum number of pages written in one round. */
+  size_t max_pages_per_round_{BGWRITER_MAX_PAGES_PER_ROUND};
+  /** The writer stays idle while at most this fraction of the frames is dirty. */
+  double low_watermark_{0.1};
+  /** While more than this fraction of the frames is dirty, the writer runs rounds back to back without sleeping. */
+  double high_watermark_{0.5};
+};
+
+/**
+ * BufferPoolManagerInstance owns a single, fixed-size array of frames and reads disk pages into it.
+ *
+ * An instance may be one shard of a ParallelBufferPoolManager. In that case it only ever holds page ids p with
+ * p % num_instances == instance_index, and it allocates new page ids from that residue class.
+ *
+ * Unpinning a page only marks it dirty. Dirty pages are written back when they are evicted or flushed, or ahead of
+ * time by an optional background writer thread, so that evictions mostly find clean victims. A checkpoint
+ * (FlushAllPages) holds latch_ only to mark its pages as being written, and copies and writes them without it.
+ *
+ * Prefetched pages are read by a prefetch thread, started on the first PrefetchPages call. It claims frames for up to
+ * PREFETCH_IO_DEPTH queued pages at a time and submits their reads to the disk manager as one asynchronous batch. A
+ * page enters the page table only once its read is done; a fetch of a page that is still being read waits for the
+ * read. The background writer likewise submits each round as one batch of writes. FetchPages
+ * claims frames for all of its misses under one acquisition of latch_, marks them as being read the same way, and
+ * reads them with a single DiskManager::ReadPages call outside the latch.
+ *
+ * For a warm restart, the instance can save the ids of its resident pages to a side file, most recently used first,
+ * and read them back in a later run. The reload takes the hottest pages that fit the free frames, so it never pushes
+ * out pages that requests have already brought in, sorts them by page id and reads them in batches of
+ * WARM_RESTART_BATCH_PAGES. The replacer learns about the reloaded frames in the recency order of the dump.
+ *
+ * A fetch that hits does not take latch_: it looks the page up in a ConcurrentPageTable and pins the frame with an
+ * atomic increment of its pin count, then checks that the frame still holds the page. Misses, evictions and all other
+ * operations that change the page table run under latch_. To replace a frame, the pool moves its pin count from 0 to
+ * FRAME_LOCKED, which unlatched fetches cannot pin; free frames are parked at FRAME_FREE. Unlatched fetches do not
+ * call Replacer::Pin, so the replacer may hand out a frame that has been pinned in the meantime; such a frame is
+ * skipped, and the unpin that brings its pin count back to zero makes it evictable again.
+ *
+ * The pool can be resized while it is in use, up to buffer_pool_max_frames frames (or its initial size, if larger).
+ * Address space for that many frames and descriptors is reserved up front, so frames never move and unlatched fetches
+ * can keep using them. Growing appends frames to the free list. Shrinking removes the frames at the end of the pool:
+ * it writes their dirty pages back without latch_, then evicts them under latch_ and hands their memory back to the
+ * kernel. Descriptors of removed frames stay constructed, parked at FRAME_FREE, for fetches that still find them
+ * through a stale page table lookup.
+ *
+ * With buffer_pool_compressed_cache_size set, evicted pages are kept in a CompressedPageCache, which misses consult
+ * before the disk. Frames recycled through a BufferAccessStrategy ring are not cached, so that scans do not flush it.
+ *
+ * With buffer_pool_zero_copy set and a disk manager that maps its file (see MmapDiskManager), a fetch that misses
+ * points the frame's page at the mapped page instead of reading it, and the frame gets its own memory back when it is
+ * replaced. Such pages are read-only: writing to them faults.
+ */
+class BufferPoolManagerInstance : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new standalone BufferPoolManagerInstance.
+   * @param pool_size the size of the buffer pool
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used to pick victim frames
+   */
+  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::CLOCK);
+
+  /**
+   * Creates a new BufferPoolManagerInstance that is one shard of a parallel buffer pool.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of instances in the parallel buffer pool
+   * @param instance_index index of this instance in the parallel buffer pool
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used to pick victim frames
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::CLOCK);
+
+  /**
+   * Destroys an existing BufferPoolManagerInstance, after writing back its dirty pages. The disk manager must still be
+   * alive.
+   */
+  ~BufferPoolManagerInstance() override;
+
+  /** @return pointer to all the pages in the buffer pool */
+  Page *GetPages() { return pages_; }
+
+  /** @return the compressed cache of evicted pages, or nullptr if it is disabled */
+  CompressedPageCache *GetCompressedCache() { return compressed_cache_.get(); }
+
+  /** @return what kind of pages back the frame data */
+  HugePageBacking GetHugePageBacking() const { return frame_arena_.GetBacking(); }
+
+  /** @return size of the buffer pool */
+  size_t GetPoolSize() override { return pool_size_; }
+
+  /**
+   * Grows or shrinks the buffer pool. Shrinking fails, and changes nothing, if a page in one of the frames to be
+   * removed is pinned.
+   * @param pool_size the new size of the buffer pool, at least 1 and at most the reserved size
+   * @return true if the pool was resized
+   */
+  bool Resize(size_t pool_size) override;
+
+  /**
+   * Starts the background writer thread, which trickles dirty, unpinned pages to disk in page id order.
+   * @param options the rate and watermarks of the writer
+   */
+  void RunBackgroundWriter(const BackgroundWriterOptions &options = {});
+
+  /**
+   * Stops and joins the background writer thread. Does nothing if it is not running.
+   */
+  void StopBackgroundWriter();
+
+  /**
+   * Saves the ids of the resident pages, most recently used first, to a side file. The file is replaced atomically.
+   * @param file_name the side file
+   * @return false if the file could not be written
+   */
+  bool DumpResidentPages(const std::string &file_name);
+
+  /**
+   * Reads the pages listed in a side file written by DumpResidentPages into free frames. Page ids of a previous run
+   * are not handed out again by NewPage.
+   * @param file_name the side file
+   * @return the number of pages read in; 0 if the file does not exist or is not a valid dump
+   */
+  size_t LoadResidentPages(const std::string &file_name);
+
+  /**
+   * Starts the warm restart thread. It first reloads the pages saved in the side file, while the pool serves
+   * requests, and then saves the resident pages to the file every dump_interval.
+   * @param file_name the side file
+   * @param dump_interval time between two saves
+   */
+  void RunWarmRestart(const std::string &file_name,
+                      std::chrono::milliseconds dump_interval = WARM_RESTART_DUMP_INTERVAL);
+
+  /**
+   * Stops and joins the warm restart thread, and saves the resident pages one last time. Does nothing if the thread
+   * is not running. Called on destruction.
+   */
+  void StopWarmRestart();
+
+  BufferPoolMetricsSnapshot GetMetrics() override;
+
+  /**
+   * Writes the dirty pages of several instances that share a disk manager, e.g. the shards of a parallel buffer pool,
+   * as one checkpoint: in one page id order across the instances, with one Sync at the end.
+   * @param instances the instances to flush, all with the same disk manager
+   */
+  static void Checkpoint(const std::vector<BufferPoolManagerInstance *> &instances);
+
+  /** @return the number of page writes done on the critical path of a request, i.e. by evictions and flushes */
+  uint64_t GetNumForegroundWrites() const;
+
+  /** @return the number of page writes done by the background writer */
+  uint64_t GetNumBackgroundWrites() const;
+
+  /** @return the number of pages that were read into the pool by prefetching */
+  uint64_t GetNumPrefetches() const;
+
+ protected:
+  Page *FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  Page *NewPageImpl(page_id_t *page_id, BufferAccessStrategy *strategy, page_id_t near_page_id) override;
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  void FlushAllPagesImpl() override;
+
+  void PrefetchPagesImpl(const std::vector<page_id_t> &page_ids) override;
+
+  size_t FetchPagesImpl(const page_id_t *page_ids, size_t num_pages, Page **pages) override;
+
+  void SetPagePriorityImpl(Page *page, PagePriority priority) override;
+
+ private:
+  /**
+   * Finds a frame to hold a new page. With a strategy, the frame in the strategy's next ring slot is recycled if
+   * possible. Otherwise the frame comes from the free list and then from the replacer. A dirty victim is written back
+   * and its page table entry is removed. Must be called with latch_ held.
+   * @param[out] frame_id the frame that can be reused
+   * @param strategy the access strategy of the caller, or nullptr
+   * @return false if every frame is pinned, true otherwise
+   */
+  bool FindReplacementFrame(frame_id_t *frame_id, BufferAccessStrategy *strategy);
+
+  /**
+   * Picks a victim from the replacer and locks it, preferring clean frames: up to CLEAN_VICTIM_LOOKAHEAD candidates
+   * are considered in search of one that can be evicted without a write. Must be called with latch_ held.
+   * @param[out] frame_id the victim frame
+   * @return false if every frame is pinned, true otherwise
+   */
+  bool FindVictim(frame_id_t *frame_id);
+
+  /**
+   * Pins a frame without latch_, if it is not locked and still holds the given page.
+   * @param frame_id the frame the page table pointed to
+   * @param page_id the page that is being fetched
+   * @return true if the page is now pinned, false if the caller has to take the slow path
+   */
+  bool TryPinFrame(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Locks an unpinned frame for replacement by moving its pin count from 0 to FRAME_LOCKED.
+   * @param frame_id the frame to lock
+   * @return false if the frame is pinned
+   */
+  bool TryLockFrame(frame_id_t frame_id);
+
+  /**
+   * Evicts the page in a frame: writes it back if it is dirty, hands it to the compressed cache and removes it from
+   * the page table. Must be called with latch_ held.
+   * @param frame_id the frame whose page is evicted
+   * @param keep_compressed false to not put the page into the compressed cache
+   */
+  void EvictFrame(frame_id_t frame_id, bool keep_compressed = true);
+
+  /**
+   * Reads a page into a frame, from the compressed cache if it holds the page and from disk otherwise.
+   * @param page_id the page to read
+   * @param[out] page_data the frame to read into
+   */
+  void ReadPage(page_id_t page_id, char *page_data);
+
+  /**
+   * Points a page at its copy in the disk manager's mapping, in zero-copy mode.
+   * @param page the page of a locked frame
+   * @param page_id the page to map
+   * @return true if the page was mapped, false if it has to be read
+   */
+  bool MapPage(Page *page, page_id_t page_id);
+
+  /**
+   * Reads pages into frames. Pages held by the compressed cache come from there; the rest are read from disk in one
+   * batch.
+   * @param page_ids the pages to read
+   * @param[out] pages_data the frames to read into
+   */
+  void ReadPages(const std::vector<page_id_t> &page_ids, const std::vector<char *> &pages_data);
+
+  /**
+   * Records a frame in the strategy's current ring slot, once the frame holds its new page.
+   * @param strategy the access strategy of the caller, or nullptr
+   * @param frame_id the frame that was taken for the strategy
+   */
+  void AddFrameToRing(BufferAccessStrategy *strategy, frame_id_t frame_id);
+
+  /**
+   * Allocates a page id on disk that belongs to this instance.
+   * @param near_page_id a page that the new page should be close to, or INVALID_PAGE_ID
+   * @return the id of the allocated page
+   */
+  page_id_t AllocatePage(page_id_t near_page_id);
+
+  /**
+   * Deallocates a page on disk.
+   * @param page_id id of the page to deallocate
+   */
+  void DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
+
+  /**
+   * Adds frames to the end of the pool. Must be called with latch_ held.
+   * @param pool_size the new size of the pool, larger than the current one
+   */
+  void GrowPool(size_t pool_size);
+
+  /**
+   * Removes the frames at the end of the pool. Must be called with latch_ held; waits for prefetches with it.
+   * @param latch the held latch_
+   * @param pool_size the new size of the pool, smaller than the current one
+   * @return false if a page in the frames to be removed is pinned
+   */
+  bool ShrinkPool(std::unique_lock<std::mutex> *latch, size_t pool_size);
+
+  /**
+   * Writes a resident page back in place, under its read latch and without latch_. The page is pinned and its dirty
+   * flag cleared for the write, so that an update that lands during the write marks it dirty again.
+   * @param page_id the page to write
+   * @param only_dirty true to skip the page if it is clean
+   * @return false if the page is not resident, or clean and skipped
+   */
+  bool WritePageBack(page_id_t page_id, bool only_dirty);
+
+  /**
+   * Copies pages out under their read latches, one at a time, and queues the copies, so that no page latch is held
+   * across the I/O. The pages must have been marked by StartPageWrite.
+   * @param writes the pages to write and their frames
+   * @param copies room for a copy of every page, aligned to DiskManager::DIRECT_IO_ALIGNMENT
+   * @param scheduler the scheduler that writes the copies
+   */
+  void CopyPages(const std::vector<std::pair<page_id_t, frame_id_t>> &writes, char *copies, WriteScheduler *scheduler);
+
+  /**
+   * Lists the dirty pages for a checkpoint, once the writes in flight are over, so that the checkpoint covers them.
+   * Takes latch_.
+   * @param instance the index of this instance in the checkpoint
+   * @param[out] dirty_pages gets the dirty pages of this instance, each with the index of this instance
+   */
+  void CollectDirtyPages(size_t instance, std::vector<std::pair<page_id_t, size_t>> *dirty_pages);
+
+  /**
+   * Marks the pages of a checkpoint batch that are still dirty as being written, waiting for writes of them that are
+   * in flight. Takes latch_.
+   * @param page_ids pages of this instance
+   * @param[out] writes gets the marked pages and their frames
+   */
+  void StartCheckpointWrites(const std::vector<page_id_t> &page_ids,
+                             std::vector<std::pair<page_id_t, frame_id_t>> *writes);
+
+  /**
+   * Waits until no write of a page is in flight. Writes of the same page must not overlap: a copy taken before an
+   * update could otherwise land on disk after a newer write of the page, while the page is already marked clean.
+   * @param latch the held lock on latch_
+   * @param page_id the page to wait for
+   */
+  void WaitForPageWrite(std::unique_lock<std::mutex> *latch, page_id_t page_id);
+
+  /**
+   * Marks a resident page as being written: pins it, so that it cannot be evicted during the write, and clears its
+   * dirty flag. Must be called with latch_ held, when no write of the page is in flight.
+   * @param page_id the page that is about to be written
+   * @param frame_id its frame
+   */
+  void StartPageWrite(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Ends the writes of pages marked by StartPageWrite and unpins them. Takes latch_.
+   * @param writes the written pages and their frames
+   */
+  void EndPageWrites(const std::vector<std::pair<page_id_t, frame_id_t>> &writes);
+
+  /**
+   * Writes back the dirty pages in a range of frames, without latch_.
+   * @param first_frame the first frame of the range
+   * @param last_frame one past the last frame of the range
+   */
+  void WriteBackFrames(size_t first_frame, size_t last_frame);
+
+  /** Body of the prefetch thread. */
+  void PrefetchLoop();
+
+  /**
+   * Publishes a prefetched page once its read is done, or returns its frame to the free list if the read failed. Runs
+   * on an I/O thread of the disk manager.
+   * @param page_id the page that was read
+   * @param frame_id the locked frame it was read into
+   * @param ok false if the read failed
+   */
+  void FinishPrefetch(page_id_t page_id, frame_id_t frame_id, bool ok);
+
+  /**
+   * Waits until no prefetch read is in flight for a page.
+   * @param latch the held lock on latch_
+   * @param page_id the page to wait for
+   */
+  void WaitForPrefetch(std::unique_lock<std::mutex> *latch, page_id_t page_id);
+
+  /** Body of the warm restart thread. */
+  void WarmRestartLoop();
+
+  /** Body of the background writer thread. */
+  void BackgroundWriterLoop();
+
+  /**
+   * Runs one round of the background writer.
+   * @return the fraction of frames that were dirty at the start of the round
+   */
+  double BackgroundWriterRound();
+
+  /** Number of dirty victims the replacer may pass over when looking for a clean one. */
+  static constexpr size_t CLEAN_VICTIM_LOOKAHEAD = 8;
+  /** Pin count of a frame that is being replaced or loaded by a prefetch. Such a frame cannot be pinned. */
+  static constexpr int FRAME_LOCKED = -1;
+  /** Pin count of a frame on the free list. Such a frame cannot be pinned. */
+  static constexpr int FRAME_FREE = -2;
+
+  /** Number of pages in the buffer pool. Changed under latch_. */
+  std::atomic<size_t> pool_size_;
+  /** Number of instances in the parallel buffer pool that this instance belongs to. */
+  const uint32_t num_instances_ = 1;
+  /** Index of this instance in the parallel buffer pool. */
+  const uint32_t instance_index_ = 0;
+  /** The data of the frames, one PAGE_SIZE-aligned region backed by huge pages where possible. */
+  FrameArena frame_arena_;
+  /**
+   * Array of page descriptors, one per frame, cache-line aligned and separate from the frame data. Reserved for the
+   * maximum size of the pool; the first num_descriptors_ are constructed.
+   */
+  Page *pages_;
+  size_t num_descriptors_{0};
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** Pointer to the log manager. */
+  LogManager *log_manager_ __attribute__((__unused__));
+  /** Page table for keeping track of buffer pool pages. Read without latch_, updated under latch_. */
+  ConcurrentPageTable page_table_;
+  /** Replacer to find unpinned pages for replacement. */
+  Replacer *replacer_;
+  /** List of free pages. */
+  std::list<frame_id_t> free_list_;
+  /** Serializes page table updates, free_list_ and the replacement of frames. Not taken by fetches that hit. */
+  std::mutex latch_;
+  /** Serializes resizes, which drop latch_ while they write back or release frames. */
+  std::mutex resize_latch_;
+  /** Second-tier cache of evicted pages, or nullptr. */
+  std::unique_ptr<CompressedPageCache> compressed_cache_;
+
+  /** The background writer thread, if it is running. */
+  std::thread background_writer_;
+  BackgroundWriterOptions background_writer_options_;
+  /** Set to stop the background writer. Protected by latch_. */
+  bool background_writer_stop_{false};
+  /** Set when eviction ran into a dirty victim, to start a round before the interval is up. Protected by latch_. */
+  bool background_writer_wake_{false};
+  /** Wakes up the background writer when it has to stop, or when eviction ran into dirty victims. */
+  std::condition_variable background_writer_cv_;
+  /** The background writer continues its sweep after the page id it wrote last. */
+  page_id_t background_writer_cursor_{INVALID_PAGE_ID};
+
+  /** The prefetch thread; not joinable until the first prefetch. */
+  std::thread prefetch_thread_;
+  /** Page ids waiting to be prefetched. At most pool_size_ are queued; further hints are dropped. */
+  std::deque<page_id_t> prefetch_queue_;
+  /** Set to stop the prefetch thread. Protected by latch_. */
+  bool prefetch_stop_{false};
+  /** Wakes up the prefetch thread when pages are queued, when reads complete or when it has to stop. */
+  std::condition_variable prefetch_cv_;
+  /** Pages that are still being read by a prefetch, batched fetch or reload. They are not in the page table yet. */
+  std::unordered_set<page_id_t> prefetch_in_flight_;
+  /** Number of reads the prefetch thread has in flight. Protected by latch_. */
+  size_t num_prefetch_reads_{0};
+  /** Signalled whenever a prefetch read completes. */
+  std::condition_variable prefetch_done_cv_;
+  /** Pages that a flush, a write-back or the background writer is writing. They stay pinned meanwhile. */
+  std::unordered_set<page_id_t> pages_being_written_;
+  /** Signalled whenever a page write ends. */
+  std::condition_variable page_write_done_cv_;
+
+  /** The warm restart thread, if it is running. */
+  std::thread warm_restart_thread_;
+  std::string warm_restart_file_;
+  std::chrono::milliseconds warm_restart_dump_interval_{WARM_RESTART_DUMP_INTERVAL};
+  /** Set to stop the warm restart thread. Protected by latch_. */
+  bool warm_restart_stop_{false};
+  /** Wakes up the warm restart thread when it has to stop. */
+  std::condition_variable warm_restart_cv_;
+
+  /** Counters of the events of this instance. The replacer counts the frames its victim searches look at. */
+  BufferPoolMetrics metrics_;
+};
+}  // namespace bustub
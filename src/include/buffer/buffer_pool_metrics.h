@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics.h
+//
+// Identification: src/include/buffer/buffer_pool_metrics.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <string>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** The events that a buffer pool counts. */
+enum class BufferPoolMetric {
+  FETCH_HITS,             // fetches of resident pages
+  FETCH_MISSES,           // fetches that read the page from disk
+  NO_FREE_FRAME,          // fetches and new pages that failed because every frame was pinned
+  NEW_PAGES,              // pages created
+  CLEAN_EVICTIONS,        // pages evicted without a write
+  DIRTY_EVICTIONS,        // pages written back by their eviction
+  FLUSHES,                // pages written by FlushPage, FlushAllPages and shrinking resizes
+  BACKGROUND_WRITES,      // pages written by the background writer
+  PREFETCHES,             // pages read in by prefetching
+  COMPRESSED_CACHE_HITS,  // misses served by the compressed cache instead of the disk
+  COMPRESSED_CACHE_PUTS,  // evicted pages stored in the compressed cache
+  WARM_LOADS,             // pages read in from the resident page set of a previous run
+  PIN_WAITS,              // fetches that found the page but had to wait for it to become pinnable
+  VICTIM_SCANS,           // victim searches in the replacer
+  VICTIM_FRAMES_SCANNED,  // frames the replacer looked at during victim searches
+  NUM_METRICS
+};
+
+/** The number of buckets of latency histograms. Bucket i counts latencies in [2^(i-1), 2^i) microseconds. */
+static constexpr size_t NUM_LATENCY_BUCKETS = 24;
+
+/**
+ * BufferPoolMetricsSnapshot holds the values of the metrics of a buffer pool at one point in time. Snapshots of the
+ * same pool can be diffed to get the activity in between, and snapshots of several pools can be merged.
+ */
+struct BufferPoolMetricsSnapshot {
+  /** @return the value of a counter */
+  uint64_t Get(BufferPoolMetric metric) const { return counters_[static_cast<size_t>(metric)]; }
+
+  /** @return the fraction of fetches that hit, or 0 if there were no fetches */
+  double HitRatio() const;
+
+  /** @return the average number of frames a victim search looked at, or 0 if there were no victim searches */
+  double MeanVictimScanLength() const;
+
+  /**
+   * @param fraction the fraction of misses, in [0, 1]
+   * @return an upper bound, in microseconds, of the miss service time that this fraction of misses did not exceed
+   */
+  uint64_t MissLatencyPercentile(double fraction) const;
+
+  /**
+   * @param earlier a snapshot of the same buffer pool taken before this one
+   * @return the activity between the two snapshots
+   */
+  BufferPoolMetricsSnapshot Diff(const BufferPoolMetricsSnapshot &earlier) const;
+
+  /**
+   * Adds the metrics of another buffer pool to this snapshot.
+   * @param other the snapshot to add
+   */
+  void Merge(const BufferPoolMetricsSnapshot &other);
+
+  /** @return a human-readable dump of all the metrics, one per line */
+  std::string ToString() const;
+
+  /** @return the name of a counter in the text dump */
+  static const char *GetName(BufferPoolMetric metric);
+
+  std::array<uint64_t, static_cast<size_t>(BufferPoolMetric::NUM_METRICS)> counters_{};
+  /** Histogram of the time from a fetch missing to the page being ready, see NUM_LATENCY_BUCKETS. */
+  std::array<uint64_t, NUM_LATENCY_BUCKETS> miss_latency_{};
+};
+
+/**
+ * BufferPoolMetrics counts the events of one buffer pool. To keep the cost on the hot paths down to an uncontended
+ * relaxed increment, the counters are striped across cache lines and every thread sticks to one stripe; a snapshot
+ * sums all stripes.
+ */
+class BufferPoolMetrics {
+ public:
+  BufferPoolMetrics() = default;
+
+  DISALLOW_COPY_AND_MOVE(BufferPoolMetrics);
+
+  /**
+   * Counts an event.
+   * @param metric the event
+   * @param count the number of times it happened
+   */
+  void Add(BufferPoolMetric metric, uint64_t count = 1) {
+    Stripe &stripe = stripes_[GetStripeIndex()];
+    stripe.counters_[static_cast<size_t>(metric)].fetch_add(count, std::memory_order_relaxed);
+  }
+
+  /**
+   * Records how long a fetch miss took to serve.
+   * @param latency the time from the miss to the page being ready
+   */
+  void RecordMissLatency(std::chrono::nanoseconds latency);
+
+  /** @return the current values of all metrics */
+  BufferPoolMetricsSnapshot Snapshot() const;
+
+ private:
+  struct alignas(64) Stripe {
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(BufferPoolMetric::NUM_METRICS)> counters_{};
+    std::array<std::atomic<uint64_t>, NUM_LATENCY_BUCKETS> miss_latency_{};
+  };
+
+  /** @return the stripe of the calling thread */
+  static size_t GetStripeIndex();
+
+  std::array<Stripe, BUFFER_POOL_METRICS_STRIPES> stripes_;
+};
+
+}  // namespace bustub
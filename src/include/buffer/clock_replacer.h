@@ -12,7 +12,8 @@
 
 #pragma once
 
-#include <list>
+#include <atomic>
+#include <functional>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -23,14 +24,25 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Every frame has a slot in a fixed array with an evictable bit and a credit counter, as in generalized clock. Pin
+ * and Unpin update the slot atomically in constant time without taking a latch, so that they stay off the buffer
+ * pool's contended paths; an unpin refills the counter with as many credits as the priority class of the page is
+ * worth. Victim sweeps a clock hand over the array, taking one credit from each evictable frame it passes and stopping
+ * at the first evictable frame that has none left; only the hand is protected by a latch. Pages of higher classes thus
+ * survive more revolutions of the hand, but an index page that is no longer used still runs out eventually.
+ *
+ * The array is allocated once for the largest number of frames the replacer may ever track, so that resizing only
+ * changes how far the hand sweeps and never moves the slots that latch-free Pin and Unpin calls touch.
  */
 class ClockReplacer : public Replacer {
  public:
   /**
    * Create a new ClockReplacer.
    * @param num_pages the maximum number of pages the ClockReplacer will be required to store
+   * @param max_pages the number of pages the ClockReplacer may be resized to at most; num_pages if smaller
    */
-  explicit ClockReplacer(size_t num_pages);
+  explicit ClockReplacer(size_t num_pages, size_t max_pages = 0);
 
   /**
    * Destroys the ClockReplacer.
@@ -39,18 +51,59 @@ class ClockReplacer : public Replacer {
 
   bool Victim(frame_id_t *frame_id) override;
 
+  bool PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer,
+                       size_t lookahead) override;
+
   void Pin(frame_id_t frame_id) override;
 
   void Unpin(frame_id_t frame_id) override;
 
   size_t Size() override;
 
+  void SetPriority(frame_id_t frame_id, PagePriority priority) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  void GetAccessOrder(std::vector<frame_id_t> *frames) override;
+
+  /**
+   * Revolutions of the hand a frame survives after an unpin, by priority class: a temp page goes on the first pass, a
+   * heap page gets the classic second chance, and index pages survive several revolutions.
+   */
+  static constexpr uint8_t PRIORITY_CREDITS[NUM_PAGE_PRIORITIES] = {0, 1, 16, 64};
+
+  void Resize(size_t num_frames) override;
+
  private:
-  // TODO(student): implement me!
-  int size = 0;
-  int index = 0;
-  std::list<int> *candidates;
-  std::vector<int> *candidate_attendance;
+  struct FrameState {
+    /** True if the frame is in the replacer, i.e. unpinned and may be victimized. */
+    std::atomic<bool> evictable_{false};
+    /** Number of times the hand may still pass the frame before it can be victimized. Refilled by Unpin. */
+    std::atomic<uint8_t> credits_{0};
+    /** Priority class of the page in the frame. */
+    std::atomic<PagePriority> priority_{PagePriority::HEAP};
+  };
+
+  /**
+   * Takes a credit from a frame as the hand passes it.
+   * @return true if the frame had a credit left, i.e. survives this pass
+   */
+  static bool SpendCredit(FrameState *frame);
+
+  /** Forgets the priority class of a frame that is leaving the replacer. */
+  static void ResetPriority(FrameState *frame) {
+    frame->priority_.store(PagePriority::HEAP, std::memory_order_relaxed);
+  }
+
+  std::vector<FrameState> frames_;
+  /** Number of frames the hand sweeps over. Protected by latch_. */
+  size_t num_frames_;
+  /** Number of evictable frames. */
+  std::atomic<size_t> size_{0};
+  /** The frame the clock hand points at. Protected by latch_. */
+  size_t hand_{0};
+  /** Serializes the sweeps of Victim and PreferredVictim. */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
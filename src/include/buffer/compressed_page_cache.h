@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * CompressedPageCache is a second-tier cache for pages that the buffer pool evicted. Pages are compressed with
+ * LZCompressor into a bounded arena, so the cache holds several times as many pages as the same memory would hold
+ * frames, and a buffer pool miss that hits it costs a decompression instead of a disk read.
+ *
+ * The cache only holds clean pages, i.e. pages whose latest version is on disk, and is exclusive: a page leaves the
+ * cache when it is looked up, because it is then back in the buffer pool. The arena is a circular log. New pages are
+ * appended at its tail and, once it wraps around, overwrite the oldest pages first, so eviction is FIFO. Pages that
+ * leave the cache early only leave a hole that is reclaimed when the tail reaches it.
+ */
+class CompressedPageCache {
+ public:
+  /**
+   * Creates a new CompressedPageCache.
+   * @param capacity the size of the arena, in bytes
+   */
+  explicit CompressedPageCache(size_t capacity);
+
+  DISALLOW_COPY_AND_MOVE(CompressedPageCache);
+
+  /**
+   * Stores a page, replacing an older copy of it. Pages that do not compress to less than PAGE_SIZE are not stored.
+   * @param page_id the id of the page
+   * @param page_data the PAGE_SIZE bytes of data of the page, which must be the same as on disk
+   * @return true if the page was stored
+   */
+  bool Insert(page_id_t page_id, const char *page_data);
+
+  /**
+   * Looks up a page and, if it is cached, decompresses it and removes it from the cache.
+   * @param page_id the id of the page
+   * @param[out] page_data the PAGE_SIZE bytes to decompress the page into
+   * @return true if the page was cached
+   */
+  bool Lookup(page_id_t page_id, char *page_data);
+
+  /**
+   * Drops a page, e.g. because it was deleted. Does nothing if the page is not cached.
+   * @param page_id the id of the page
+   */
+  void Erase(page_id_t page_id);
+
+  /** @return the number of cached pages */
+  size_t GetNumPages();
+
+  /** @return the compressed size of the cached pages, in bytes */
+  size_t GetBytesStored();
+
+  /** @return the size of the arena, in bytes */
+  size_t GetCapacity() const { return capacity_; }
+
+  /** @return how many times more pages the cached pages take uncompressed than compressed, or 0 if it is empty */
+  double GetCompressionRatio();
+
+ private:
+  struct Entry {
+    size_t offset_;
+    size_t size_;
+  };
+
+  /** Makes room for size bytes at the tail of the log and returns their offset. Must be called with latch_ held. */
+  size_t Allocate(size_t size);
+
+  /** Removes a page from entries_. Must be called with latch_ held. */
+  void EraseEntry(std::unordered_map<page_id_t, Entry>::iterator it);
+
+  const size_t capacity_;
+  std::unique_ptr<char[]> arena_;
+  /** Where the next page is written. */
+  size_t tail_{0};
+  /** The pages in the arena in the order they were written, including those that left the cache since. */
+  std::deque<std::pair<page_id_t, size_t>> log_;
+  /** The cached pages. */
+  std::unordered_map<page_id_t, Entry> entries_;
+  size_t bytes_stored_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table.h
+//
+// Identification: src/include/buffer/concurrent_page_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ConcurrentPageTable maps resident page ids to the frames that hold them. It is an open-addressing hash table with
+ * linear probing, sized once for the number of frames, whose slots are single 64-bit atomics. Lookups take no latch.
+ *
+ * Updates must be serialized by the caller (the buffer pool's latch). Erase uses backward-shift deletion, so the table
+ * never accumulates tombstones. While an entry is being shifted, a concurrent Find may miss it: a Find that returns
+ * false is only a hint, and the caller has to repeat the lookup under the latch before concluding that the page is
+ * not resident. A Find that returns true may also be stale by the time the caller uses the frame, so the caller must
+ * validate the frame's page id after pinning it.
+ *
+ * The table grows when the buffer pool does. Growing rehashes into a new slot array and publishes it; lookups that
+ * are still probing the old array may miss, or find a frame that has moved on, which the checks above already cover.
+ * Old arrays are kept until the table is destroyed, since there is no way to tell when the last such lookup is done;
+ * as the table at least doubles every time, they take less memory than the current one.
+ */
+class ConcurrentPageTable {
+ public:
+  /**
+   * Creates a new ConcurrentPageTable.
+   * @param max_entries the maximum number of entries the table will ever hold, i.e. the number of frames
+   */
+  explicit ConcurrentPageTable(size_t max_entries);
+
+  DISALLOW_COPY_AND_MOVE(ConcurrentPageTable);
+
+  /**
+   * Looks up a page without taking any latch.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame that held the page at the time of the lookup
+   * @return true if the page was found, false if it was not found or the lookup raced with an Erase
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const;
+
+  /**
+   * Inserts a mapping. The page must not be in the table. Callers must serialize updates.
+   * @param page_id the page
+   * @param frame_id the frame that holds the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Removes a mapping. Callers must serialize updates.
+   * @param page_id the page to remove
+   * @return true if the page was in the table
+   */
+  bool Erase(page_id_t page_id);
+
+  /**
+   * Makes room for more entries. Callers must serialize this with updates.
+   * @param max_entries the maximum number of entries the table will hold from now on
+   */
+  void Reserve(size_t max_entries);
+
+  /** @return the number of entries. Only exact when updates are quiescent. */
+  size_t Size() const { return size_; }
+
+  /**
+   * Calls f(page_id, frame_id) for every entry. Callers must serialize this with updates.
+   * @param f the function to call
+   */
+  template <typename F>
+  void ForEach(F &&f) const {
+    const Table &table = *tables_.back();
+    for (size_t i = 0; i < table.capacity_; i++) {
+      uint64_t slot = table.slots_[i].load(std::memory_order_acquire);
+      if (slot != EMPTY) {
+        f(UnpackPageId(slot), UnpackFrameId(slot));
+      }
+    }
+  }
+
+ private:
+  /** An empty slot. No entry packs to this, since INVALID_PAGE_ID is never inserted. */
+  static constexpr uint64_t EMPTY = ~static_cast<uint64_t>(0);
+
+  static uint64_t Pack(page_id_t page_id, frame_id_t frame_id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static page_id_t UnpackPageId(uint64_t slot) { return static_cast<page_id_t>(slot >> 32); }
+  static frame_id_t UnpackFrameId(uint64_t slot) { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  struct Table {
+    /** Number of slots, a power of two. */
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  };
+
+  /** @return a new, empty table with room for max_entries entries */
+  static std::unique_ptr<Table> MakeTable(size_t max_entries);
+
+  /** @return the home slot of a page */
+  static size_t HomeSlot(const Table &table, page_id_t page_id);
+
+  /** Inserts a mapping into the given table. */
+  static void InsertInto(Table *table, page_id_t page_id, frame_id_t frame_id);
+
+  /** The table that lookups probe. Always the last element of tables_. */
+  std::atomic<const Table *> current_;
+  /** All tables ever used; the older ones may still be probed by lookups that started before a Reserve. */
+  std::vector<std::unique_ptr<Table>> tables_;
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** HugePageBacking describes what kind of pages back a FrameArena. */
+enum class HugePageBacking {
+  /** Regular 4 KB pages. */
+  NONE,
+  /** Transparent huge pages: the kernel was advised to use 2 MB pages, and does so when it can. */
+  TRANSPARENT,
+  /** Explicit huge pages from the hugetlbfs pool. */
+  HUGETLB
+};
+
+/**
+ * FrameArena holds the data of all frames of a buffer pool in one contiguous, zeroed mmap region. Frame i starts at
+ * offset i * PAGE_SIZE, so every frame is PAGE_SIZE-aligned, as direct I/O requires (see DiskManager). Frames are read
+ * and written in place even when the disk manager bypasses the page cache.
+ *
+ * With huge pages, the arena first tries explicit 2 MB pages (MAP_HUGETLB), which only works if the administrator
+ * reserved them, and falls back to a 2 MB-aligned mapping with MADV_HUGEPAGE. Either way a large pool needs 512 times
+ * fewer TLB entries than with 4 KB pages.
+ *
+ * An arena can reserve address space for more frames than it starts with, so that a buffer pool can grow in place.
+ * Such an arena is mapped without reserving swap, memory is committed as frames are first touched, and Release hands
+ * the memory of frames back to the kernel. Explicit huge pages are only used for arenas without room to grow, since
+ * they would have to be taken from the hugetlbfs pool for the whole reservation up front.
+ */
+class FrameArena {
+ public:
+  /**
+   * Maps a new arena.
+   * @param num_frames the number of frames
+   * @param use_huge_pages true to back the arena with huge pages where possible, false to force 4 KB pages
+   * @param max_frames the number of frames to reserve address space for; num_frames if smaller
+   * @throws Exception(OUT_OF_MEMORY) if the arena cannot be mapped
+   */
+  FrameArena(size_t num_frames, bool use_huge_pages, size_t max_frames = 0);
+
+  /** Unmaps the arena. */
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /**
+   * @param frame_id the frame
+   * @return the PAGE_SIZE bytes of data of the frame
+   */
+  char *GetFrame(frame_id_t frame_id) const { return base_ + static_cast<size_t>(frame_id) * PAGE_SIZE; }
+
+  /**
+   * Returns the memory of a range of frames to the kernel. The frames read as zeroes when they are touched again.
+   * @param first_frame the first frame of the range
+   * @param num_frames the number of frames in the range
+   */
+  void Release(frame_id_t first_frame, size_t num_frames);
+
+  /** @return the number of frames the arena has address space for */
+  size_t GetMaxFrames() const { return max_frames_; }
+
+  /** @return what kind of pages back the arena */
+  HugePageBacking GetBacking() const { return backing_; }
+
+  /** Size of a huge page on x86-64 and arm64. */
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+ private:
+  /** Start of the frames. */
+  char *base_{nullptr};
+  /** Start and length of the mapping, which may begin before base_ to get a 2 MB-aligned base_. */
+  char *mapping_{nullptr};
+  size_t mapping_size_{0};
+  size_t max_frames_;
+  HugePageBacking backing_{HugePageBacking::NONE};
+};
+
+}  // namespace bustub
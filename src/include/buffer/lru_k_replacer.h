@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The backward k-distance of a frame is the difference in time between now and its k-th most recent access. The
+ * replacer evicts the frame with the largest backward k-distance. Frames with fewer than k recorded accesses have an
+ * infinite backward k-distance and are evicted first, in order of their earliest recorded access. Because a single
+ * sequential scan only touches each page once, scanned pages never reach k accesses and cannot push out pages that
+ * are re-referenced.
+ *
+ * Buffer pool hits record accesses without the latch: each frame has a ring of the timestamps of its last k accesses,
+ * which an access fills with two atomic increments and a store. The accesses are applied to the frame's history under
+ * the latch when the frame is pinned, unpinned or considered as a victim. An access only ever makes a frame's eviction
+ * key larger, so the victim search applies pending accesses lazily, to the candidates it looks at. Two accesses racing
+ * on the same frame may land in the ring out of order, and one that races with the victim search may be lost; either
+ * only makes the frame look slightly colder.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of most recent accesses to remember per frame
+   * @param max_pages the number of pages the LRUKReplacer may be resized to at most; num_pages if smaller
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K, size_t max_pages = 0);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override = default;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  bool PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer,
+                       size_t lookahead) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+  void GetAccessOrder(std::vector<frame_id_t> *frames) override;
+
+  void Resize(size_t num_frames) override;
+
+ private:
+  /** Eviction order key: (has k accesses, oldest remembered access timestamp, frame id). Smallest is evicted first. */
+  using EvictionKey = std::tuple<bool, uint64_t, frame_id_t>;
+
+  struct FrameInfo {
+    /** Timestamps of the last (up to) k applied accesses, oldest first. Protected by latch_. */
+    std::vector<uint64_t> history_;
+    /** Accesses with older timestamps are in the history or were forgotten. Protected by latch_. */
+    uint64_t applied_until_{1};
+    /**
+     * True if the frame is unpinned and may be victimized. Written under latch_; Unpin reads it without, since hits do
+     * not pin frames in the replacer and most unpins find the frame still evictable.
+     */
+    std::atomic<bool> evictable_{false};
+    /** Number of accesses recorded so far; picks the slot of the next one in the ring. */
+    std::atomic<uint64_t> num_recorded_{0};
+  };
+
+  EvictionKey GetEvictionKey(frame_id_t frame_id) const;
+
+  /**
+   * Moves the accesses that were recorded without the latch into the history of a frame, and the frame to its new place
+   * in evictable_ if it is evictable. Must be called with latch_ held.
+   * @return true if there were any
+   */
+  bool ApplyPendingAccesses(frame_id_t frame_id);
+
+  /** Forgets the history of a frame, including its pending accesses. Must be called with latch_ held. */
+  void ForgetHistory(frame_id_t frame_id);
+
+  /**
+   * Finds the victim among the first lookahead evictable frames, applying their pending accesses on the way. Must be
+   * called with latch_ held.
+   * @return the victim's entry in evictable_, or its end if there are no evictable frames
+   */
+  std::set<EvictionKey>::iterator FindVictim(const std::function<bool(frame_id_t)> &prefer, size_t lookahead);
+
+  const size_t k_;
+  /**
+   * Logical clock, bumped on every recorded access. Starts at 1, like applied_until_, so that an empty ring slot is
+   * never pending.
+   */
+  std::atomic<uint64_t> current_timestamp_{1};
+  /** Allocated for the largest number of frames, so that latch-free accesses never see it move. */
+  std::vector<FrameInfo> frames_;
+  /** The rings of pending accesses, k timestamps per frame. */
+  std::vector<std::atomic<uint64_t>> pending_;
+  /** Number of frames the replacer currently tracks. Protected by latch_. */
+  size_t num_frames_;
+  /** The evictable frames, ordered by eviction priority. */
+  std::set<EvictionKey> evictable_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
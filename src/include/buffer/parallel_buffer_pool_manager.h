@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards pages across several independent BufferPoolManagerInstances, each with its own
+ * latch, so that threads working on different pages do not contend on a single mutex.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used by every instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::CLOCK);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override = default;
+
+  /** @return size of the buffer pool, summed over all instances */
+  size_t GetPoolSize() override;
+
+  /**
+   * Resizes every instance to an equal share of the new size, rounded up.
+   * @param pool_size the new size of the buffer pool, summed over all instances
+   * @return false if any instance could not be resized; the others keep their new size
+   */
+  bool Resize(size_t pool_size) override;
+
+  /** @return the metrics of all instances, merged */
+  BufferPoolMetricsSnapshot GetMetrics() override;
+
+  /** @return the number of instances the pages are sharded across */
+  size_t GetNumInstances() const { return instances_.size(); }
+
+  /**
+   * Starts a background writer in every instance.
+   * @param options the rate and watermarks of each writer
+   */
+  void RunBackgroundWriter(const BackgroundWriterOptions &options = {});
+
+  /** Stops the background writers of all instances. */
+  void StopBackgroundWriter();
+
+  /**
+   * Saves the resident pages of every instance, instance i to file_name.i.
+   * @param file_name prefix of the side files
+   * @return false if a file could not be written
+   */
+  bool DumpResidentPages(const std::string &file_name);
+
+  /**
+   * Reads back the pages saved by DumpResidentPages into every instance.
+   * @param file_name prefix of the side files
+   * @return the number of pages read in
+   */
+  size_t LoadResidentPages(const std::string &file_name);
+
+  /**
+   * Starts the warm restart thread of every instance, instance i with the side file file_name.i.
+   * @param file_name prefix of the side files
+   * @param dump_interval time between two saves
+   */
+  void RunWarmRestart(const std::string &file_name,
+                      std::chrono::milliseconds dump_interval = WARM_RESTART_DUMP_INTERVAL);
+
+  /** Stops the warm restart thread of every instance, which saves its resident pages one last time. */
+  void StopWarmRestart();
+
+  /** @return the number of page writes done by evictions and flushes, summed over all instances */
+  uint64_t GetNumForegroundWrites() const;
+
+  /** @return the number of page writes done by the background writers, summed over all instances */
+  uint64_t GetNumBackgroundWrites() const;
+
+ protected:
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling the given page id
+   */
+  BufferPoolManagerInstance *GetBufferPoolManager(page_id_t page_id);
+
+  Page *FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  /**
+   * Creates a new page. Instances are tried round-robin, starting one past the instance that served the previous
+   * request, so that new pages are spread evenly across the shards.
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy to take a frame from, nullptr to use the whole pool
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPageImpl(page_id_t *page_id, BufferAccessStrategy *strategy, page_id_t near_page_id) override;
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  /**
+   * Checkpoints all instances as one batch, so that neighbouring pages owned by different instances are written
+   * together and the file is synced once.
+   */
+  void FlushAllPagesImpl() override;
+
+  /**
+   * Hands each page to the instance that owns it.
+   * @param page_ids ids of the pages to prefetch
+   */
+  void PrefetchPagesImpl(const std::vector<page_id_t> &page_ids) override;
+
+  /**
+   * Splits the batch by owning instance and fetches each part as one batch.
+   * @param page_ids ids of the pages to fetch
+   * @param num_pages number of pages to fetch
+   * @param[out] pages the fetched pages, nullptr where no frame could be found
+   * @return the number of pages that were fetched
+   */
+  size_t FetchPagesImpl(const page_id_t *page_ids, size_t num_pages, Page **pages) override;
+
+  void SetPagePriorityImpl(Page *page, PagePriority priority) override;
+
+ private:
+  /** The shards. Page p lives in instances_[p % instances_.size()]. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  /** The instance that the next NewPage call starts searching from. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
@@ -12,10 +12,23 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** ReplacerType selects the replacement policy that a buffer pool is constructed with. */
+enum class ReplacerType { CLOCK, LRU_K };
+
+/** PagePriority classes pages by how long they should stay in the buffer pool, lowest first. */
+enum class PagePriority : uint8_t { TEMP, HEAP, INDEX, INDEX_ROOT };
+
+/** The number of priority classes. */
+static constexpr size_t NUM_PAGE_PRIORITIES = 4;
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -31,6 +44,40 @@ class Replacer {
    */
   virtual bool Victim(frame_id_t *frame_id) = 0;
 
+  /**
+   * Remove a victim frame, preferring frames that satisfy a predicate. Up to lookahead candidates are considered in
+   * eviction order; the first preferred one is returned, or the first candidate if none is preferred. Candidates that
+   * are passed over stay evictable. Policies that keep access history may keep the victim's until Remove, so that a
+   * caller that claims the frame calls Remove, and one that finds the frame still in use unpins it again later.
+   * @param[out] frame_id id of frame that was removed
+   * @param prefer the predicate, e.g. "the frame is clean"
+   * @param lookahead the maximum number of candidates to consider
+   * @return true if a victim frame was found, false otherwise
+   */
+  virtual bool PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer,
+                               size_t lookahead) {
+    // Generic fallback: take candidates out and hand back the ones that were passed over.
+    std::vector<frame_id_t> candidates;
+    frame_id_t candidate;
+    while (candidates.size() < lookahead && Victim(&candidate)) {
+      candidates.push_back(candidate);
+      if (prefer(candidate)) {
+        break;
+      }
+    }
+    RecordFramesScanned(candidates.size());
+    if (candidates.empty()) {
+      return false;
+    }
+    *frame_id = prefer(candidates.back()) ? candidates.back() : candidates.front();
+    for (frame_id_t skipped : candidates) {
+      if (skipped != *frame_id) {
+        Unpin(skipped);
+      }
+    }
+    return true;
+  }
+
   /**
    * Pins a frame, indicating that it should not be victimized until it is unpinned.
    * @param frame_id the id of the frame to pin
@@ -43,8 +90,57 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Records that the page held by a frame was accessed. Policies that do not keep access history ignore this.
+   * @param frame_id the id of the frame that was accessed
+   */
+  virtual void RecordAccess(frame_id_t frame_id) {}
+
+  /**
+   * Removes a frame from the replacer entirely, e.g. because its page was deleted. Unlike Pin, this also forgets any
+   * access history that the policy keeps for the frame.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Sets the priority class of the page in a frame. Policies that support classes evict frames of lower classes first,
+   * with aging so that no class starves; others ignore this. The class sticks to the frame until the frame is
+   * victimized or removed, and then falls back to HEAP.
+   * @param frame_id the id of the frame
+   * @param priority the priority class of its page
+   */
+  virtual void SetPriority(frame_id_t frame_id, PagePriority priority) {}
+
+  /**
+   * Lists frames from the most to the least recently used, as far as the policy can tell, e.g. to save the hot set of
+   * the buffer pool across a restart. Frames that the policy cannot rank may be missing.
+   * @param[out] frames the frames, most recently used first
+   */
+  virtual void GetAccessOrder(std::vector<frame_id_t> *frames) {}
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
+
+  /**
+   * Changes the number of frames the replacer tracks, when the buffer pool is resized. Frames that go away must have
+   * been removed from the replacer first.
+   * @param num_frames the new number of frames
+   */
+  virtual void Resize(size_t num_frames) = 0;
+
+  /** @return the number of frames that victim searches have looked at so far */
+  uint64_t GetNumFramesScanned() const { return num_frames_scanned_.load(std::memory_order_relaxed); }
+
+ protected:
+  /**
+   * Counts frames that a victim search looked at.
+   * @param num_frames the number of frames
+   */
+  void RecordFramesScanned(size_t num_frames) { num_frames_scanned_.fetch_add(num_frames, std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> num_frames_scanned_{0};
 };
 
 }  // namespace bustub
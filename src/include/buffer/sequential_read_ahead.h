@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sequential_read_ahead.h
+//
+// Identification: src/include/buffer/sequential_read_ahead.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * SequentialReadAhead watches an operation that walks a chain of pages, e.g. a table heap scan, and prefetches the
+ * pages it is about to reach.
+ *
+ * The chain itself is only known one page at a time, so the read-ahead predicts it: once two consecutive hops have the
+ * same page id stride, the next window pages at that stride are prefetched, and the window is topped up as the walk
+ * advances. Table heaps are built by appending freshly allocated pages, so their chains are mostly sequential. A wrong
+ * prediction costs a wasted read but never correctness, since prefetching is only a hint.
+ */
+class SequentialReadAhead {
+ public:
+  /**
+   * Creates a new SequentialReadAhead.
+   * @param buffer_pool_manager the buffer pool to prefetch into
+   * @param window the number of pages to keep in flight ahead of the walk, 0 to disable read-ahead
+   */
+  explicit SequentialReadAhead(BufferPoolManager *buffer_pool_manager, size_t window = TABLE_READ_AHEAD_WINDOW)
+      : buffer_pool_manager_(buffer_pool_manager), window_(window) {}
+
+  /**
+   * Tells the read-ahead that the walk moved from one page to the next. Call this before fetching the next page.
+   * @param from_page_id the page the walk is leaving
+   * @param to_page_id the page the walk is moving to
+   */
+  void OnAdvance(page_id_t from_page_id, page_id_t to_page_id);
+
+  /** @return the number of pages prefetched so far */
+  size_t GetNumPrefetched() const { return num_prefetched_; }
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  size_t window_;
+  /** The page id distance of the last hop. */
+  page_id_t stride_{0};
+  /** The furthest page that has been prefetched in the current run. */
+  page_id_t frontier_{INVALID_PAGE_ID};
+  size_t num_prefetched_{0};
+};
+
+}  // namespace bustub
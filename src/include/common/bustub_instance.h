@@ -10,29 +10,51 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
 #include <string>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
 #include "recovery/checkpoint_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/memory_disk_manager.h"
+#include "storage/disk/throttled_disk_manager.h"
 
 namespace bustub {
 
+/** Where a BustubInstance keeps its pages and its log. */
+enum class StorageType { FILE, MEMORY };
+
 class BustubInstance {
  public:
-  explicit BustubInstance(const std::string &db_file_name) {
+  /**
+   * Creates a new BustubInstance. The buffer pool can be resized later through buffer_pool_manager_->Resize.
+   * @param db_file_name the database file; unused with StorageType::MEMORY
+   * @param buffer_pool_size the initial size of the buffer pool, in frames
+   * @param storage_type FILE for a DiskManager, MEMORY for a MemoryDiskManager, e.g. for benchmarks
+   * @param throttle_profile if not nullptr, the disk manager is wrapped in a ThrottledDiskManager with this profile
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t buffer_pool_size = BUFFER_POOL_SIZE,
+                          StorageType storage_type = StorageType::FILE,
+                          const ThrottleProfile *throttle_profile = nullptr) {
     enable_logging = false;
 
     // storage related
-    disk_manager_ = new DiskManager(db_file_name);
+    if (storage_type == StorageType::MEMORY) {
+      disk_manager_ = new MemoryDiskManager();
+    } else {
+      disk_manager_ = new DiskManager(db_file_name);
+    }
+    if (throttle_profile != nullptr) {
+      disk_manager_ = new ThrottledDiskManager(std::unique_ptr<DiskManager>(disk_manager_), *throttle_profile);
+    }
 
     // log related
     log_manager_ = new LogManager(disk_manager_);
 
-    buffer_pool_manager_ = new BufferPoolManager(BUFFER_POOL_SIZE, disk_manager_, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManagerInstance(buffer_pool_size, disk_manager_, log_manager_);
 
     // txn related
     lock_manager_ = new LockManager(TwoPLMode::STRICT, DeadlockMode::PREVENTION);  // S2PL
@@ -55,7 +77,7 @@ class BustubInstance {
   }
 
   DiskManager *disk_manager_;
-  BufferPoolManager *buffer_pool_manager_;
+  BufferPoolManagerInstance *buffer_pool_manager_;
   LockManager *lock_manager_;
   TransactionManager *transaction_manager_;
   LogManager *log_manager_;
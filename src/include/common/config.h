@@ -27,6 +27,24 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** True if buffer pools should back their frames with 2 MB huge pages where the system allows it. */
+extern bool buffer_pool_use_huge_pages;
+
+/** The number of frames a buffer pool instance can grow to; address space for this many frames is reserved up front. */
+extern size_t buffer_pool_max_frames;
+
+/** Bytes of compressed cache for evicted pages per buffer pool instance; 0 disables the cache. */
+extern size_t buffer_pool_compressed_cache_size;
+
+/** True if buffer pools should point frames at pages that the disk manager maps, instead of copying them. */
+extern bool buffer_pool_zero_copy;
+
+/** True if disk managers should run asynchronous page I/O through io_uring where the kernel allows it. */
+extern bool disk_manager_use_io_uring;
+
+/** Minimum pages by which disk managers grow the db file, reserving the space with fallocate; 1 disables it. */
+extern size_t disk_manager_extent_pages;
+
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
@@ -35,6 +53,19 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int LRUK_REPLACER_K = 2;                                     // lookback window for lru-k replacer
+static constexpr int BUFFER_ACCESS_STRATEGY_RING_SIZE = 32;                   // frames in a scan/bulk-write ring
+static constexpr int BGWRITER_MAX_PAGES_PER_ROUND = 64;                       // pages written per bgwriter round
+static constexpr std::chrono::milliseconds BGWRITER_INTERVAL{10};             // sleep between bgwriter rounds
+static constexpr int PREFETCH_IO_DEPTH = 32;                                  // prefetch reads in flight per BPI
+static constexpr int TABLE_READ_AHEAD_WINDOW = 8;                             // pages a table scan reads ahead
+static constexpr int OPTIMISTIC_READ_RETRIES = 4;                             // latch-free page read attempts
+static constexpr int BUFFER_POOL_METRICS_STRIPES = 16;                        // counter stripes per buffer pool
+static constexpr int WARM_RESTART_BATCH_PAGES = 64;                           // pages per warm restart read batch
+static constexpr int CHECKPOINT_BATCH_PAGES = 256;                            // pages copied per checkpoint write
+static constexpr std::chrono::milliseconds WARM_RESTART_DUMP_INTERVAL{60000};  // period of resident page set dumps
+static constexpr int DISK_IO_QUEUE_DEPTH = 64;                                 // async page I/Os in flight per disk
+static constexpr int DISK_EXTENT_GROWTH_DIVISOR = 8;                           // db file extents are >= 1/8 of it
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
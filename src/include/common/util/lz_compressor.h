@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_compressor.h
+//
+// Identification: src/include/common/util/lz_compressor.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * LZCompressor is a small, fast LZ77 codec in the style of the LZ4 block format, meant for pages: it trades
+ * compression ratio for speed, and needs no memory besides a hash table on the stack.
+ *
+ * The output is a series of sequences. Each starts with a token byte whose high nibble is the number of literals and
+ * whose low nibble is the match length minus MIN_MATCH; a nibble of 15 is continued by bytes of 255 and a final byte
+ * smaller than 255, all added up. The literals follow the token, then the match offset (2 bytes, little endian), then
+ * the continuation of the match length. The last sequence has literals only.
+ */
+class LZCompressor {
+ public:
+  /**
+   * Compresses a buffer.
+   * @param src the data to compress
+   * @param src_size the size of the data
+   * @param[out] dst the buffer to compress into
+   * @param dst_capacity the size of dst
+   * @return the size of the compressed data, or 0 if it does not fit into dst
+   */
+  static size_t Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity);
+
+  /**
+   * Decompresses a buffer. Corrupt input is detected rather than read or written out of bounds.
+   * @param src the compressed data
+   * @param src_size the size of the compressed data
+   * @param[out] dst the buffer to decompress into
+   * @param dst_capacity the size of dst
+   * @param[out] dst_size the size of the decompressed data
+   * @return false if the compressed data is corrupt or does not fit into dst
+   */
+  static bool Decompress(const char *src, size_t src_size, char *dst, size_t dst_capacity, size_t *dst_size);
+
+  /** @return the size that compressing src_size bytes can take in the worst case */
+  static constexpr size_t MaxCompressedSize(size_t src_size) { return src_size + src_size / 255 + 16; }
+
+ private:
+  /** Shortest match that is encoded as a match. */
+  static constexpr size_t MIN_MATCH = 4;
+  /** The last bytes of the input are always literals, so that matches never have to be checked against the end. */
+  static constexpr size_t LAST_LITERALS = 5;
+  /** Longest distance a match can reach back. */
+  static constexpr size_t MAX_OFFSET = 65535;
+  static constexpr int HASH_BITS = 12;
+};
+
+}  // namespace bustub
@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_io.h
+//
+// Identification: src/include/storage/disk/async_disk_io.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <linux/io_uring.h>
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class DiskManager;
+
+/** Called when an asynchronous page I/O completes, with true if the whole page was read or written. */
+using DiskCallback = std::function<void(bool)>;
+
+/** DiskRequest is one page read or write handed to DiskManager::Submit. */
+struct DiskRequest {
+  /** True for a write, false for a read. */
+  bool is_write_;
+  /** The page to read or write. */
+  page_id_t page_id_;
+  /** The PAGE_SIZE bytes of page data. A read fills them. They must stay valid until the callback has run. */
+  char *data_;
+  /** Called on an I/O thread once the request is done. */
+  DiskCallback callback_;
+};
+
+/**
+ * AsyncDiskIO runs the page reads and writes of a DiskManager in the background, so that a single thread can keep
+ * many page I/Os in flight. At most queue_depth requests are in flight at a time. Callbacks run on an I/O thread, so
+ * they should be short, and they must not submit requests themselves.
+ */
+class AsyncDiskIO {
+ public:
+  virtual ~AsyncDiskIO() = default;
+
+  /**
+   * Starts a batch of requests, and empties the vector. Requests may complete in any order.
+   * @param requests the requests
+   */
+  virtual void Submit(std::vector<DiskRequest> *requests) = 0;
+
+  /** @return true if requests go through io_uring, false if they are run by a pool of threads */
+  virtual bool UsesIoUring() const = 0;
+
+  /**
+   * Creates the backend for a disk manager: io_uring if the kernel allows it, a pool of threads otherwise.
+   * @param disk_manager the disk manager
+   * @param fd the descriptor of its db file
+   * @param queue_depth the maximum number of requests in flight
+   * @param use_io_uring false to always use the pool of threads
+   */
+  static std::unique_ptr<AsyncDiskIO> Create(DiskManager *disk_manager, int fd, size_t queue_depth,
+                                             bool use_io_uring);
+};
+
+/**
+ * IoUringDiskIO submits requests to an io_uring set up with raw system calls, so that it needs no liburing. Each
+ * Submit fills as many submission queue entries as there are free slots and hands them to the kernel with a single
+ * io_uring_enter, and blocks while all slots are taken. A completion thread waits for completions, reaps all that are
+ * ready in one go, and runs their callbacks.
+ */
+class IoUringDiskIO : public AsyncDiskIO {
+ public:
+  /**
+   * Sets up the ring and starts the completion thread. Check IsOpen afterwards.
+   * @param disk_manager the disk manager
+   * @param fd the descriptor of its db file
+   * @param queue_depth the maximum number of requests in flight
+   */
+  IoUringDiskIO(DiskManager *disk_manager, int fd, size_t queue_depth);
+
+  /** Waits for the requests in flight and tears down the ring. */
+  ~IoUringDiskIO() override;
+
+  DISALLOW_COPY_AND_MOVE(IoUringDiskIO);
+
+  /** @return false if the kernel refused to set up the ring */
+  bool IsOpen() const { return ring_fd_ >= 0; }
+
+  void Submit(std::vector<DiskRequest> *requests) override;
+
+  bool UsesIoUring() const override { return true; }
+
+ private:
+  /** Calls io_uring_enter, retrying when interrupted or when the kernel is short of resources. */
+  void Enter(unsigned to_submit, unsigned min_complete, unsigned flags);
+
+  /** Fills the submission queue entry at the given tail position. Must hold sq_latch_. */
+  void PrepareEntry(unsigned tail, uint8_t opcode, DiskRequest *request);
+
+  /** Finishes a request with the result of its completion queue entry, runs its callback and frees it. */
+  void Complete(DiskRequest *request, int result);
+
+  /** Body of the completion thread. */
+  void CompletionLoop();
+
+  DiskManager *disk_manager_;
+  int fd_;
+  size_t queue_depth_;
+  int ring_fd_{-1};
+
+  /** The mappings of the rings and of the submission queue entries. The rings may share one mapping. */
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  struct io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  /** Fields of the shared rings. Tails and heads are read and written with acquire and release ordering. */
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  struct io_uring_cqe *cqes_{nullptr};
+
+  /** Serializes submissions, and protects in_flight_. */
+  std::mutex sq_latch_;
+  /** Number of requests that have been submitted but not yet completed. */
+  size_t in_flight_{0};
+  /** Signalled when requests complete. */
+  std::condition_variable slots_cv_;
+  std::thread completion_thread_;
+};
+
+/**
+ * ThreadPoolDiskIO runs requests on a pool of threads with the synchronous, positional I/O of the disk manager. It is
+ * the fallback for kernels without io_uring. Submit only queues the requests, so it never blocks.
+ */
+class ThreadPoolDiskIO : public AsyncDiskIO {
+ public:
+  /**
+   * Starts the threads.
+   * @param disk_manager the disk manager
+   * @param num_threads the number of threads, i.e. the maximum number of requests in flight
+   */
+  ThreadPoolDiskIO(DiskManager *disk_manager, size_t num_threads);
+
+  /** Finishes the queued requests and joins the threads. */
+  ~ThreadPoolDiskIO() override;
+
+  DISALLOW_COPY_AND_MOVE(ThreadPoolDiskIO);
+
+  void Submit(std::vector<DiskRequest> *requests) override;
+
+  bool UsesIoUring() const override { return false; }
+
+ private:
+  /** Body of the I/O threads. */
+  void WorkerLoop();
+
+  DiskManager *disk_manager_;
+  std::vector<std::thread> threads_;
+  /** Requests waiting for a thread. Protected by latch_. */
+  std::deque<DiskRequest> queue_;
+  /** Set to stop the threads once the queue is empty. Protected by latch_. */
+  bool stop_{false};
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
+}  // namespace bustub
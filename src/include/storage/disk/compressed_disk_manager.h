@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager.h
+//
+// Identification: src/include/storage/disk/compressed_disk_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>  // NOLINT
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * CompressedDiskManager stores pages compressed, while its callers, e.g. the buffer pool, still read and write whole
+ * uncompressed pages. Every page write is compressed with LZCompressor and stored in a slot of a heap file next to
+ * the db file (db_file with the extension .zdb), sized to the compressed page rounded up to SLOT_ALIGNMENT bytes.
+ * Pages that do not compress below PAGE_SIZE - SLOT_ALIGNMENT bytes are stored as they are.
+ *
+ * Where each page lives is kept in a location map, an array of SlotEntry indexed by page id. The map is cached in
+ * memory and stored in the db file, whose page slots are otherwise unused: slot k holds the entries of the
+ * ENTRIES_PER_MAP_PAGE pages from k * ENTRIES_PER_MAP_PAGE on. The allocation bitmap stays where DiskManager keeps it.
+ * Like the bitmap, the map pages that changed are written by Sync and ShutDown, and the map is read back when the
+ * files are opened; free space in the heap is whatever the map does not point to.
+ *
+ * Slots are copy-on-write: a page write always goes to a fresh slot, so the slot that the last synced map points to
+ * stays intact until the next Sync has made the new map durable, and only then is it reused. A slot that only the
+ * in-memory map knew about is reused right away. Free slots merge with the free slots next to them, so that pages whose
+ * compressed size changes do not strand their old slots. A write takes the smallest free slot that fits, splitting it
+ * if needed, and otherwise appends to the heap.
+ *
+ * Submitted requests run synchronously, on the submitting thread, before Submit returns. Writes of the same page must
+ * not race each other, just as they would tear the page without compression.
+ */
+class CompressedDiskManager : public DiskManager {
+ public:
+  /** Slots start and end at multiples of this many bytes in the heap file. */
+  static constexpr size_t SLOT_ALIGNMENT = 512;
+  /** Number of SLOT_ALIGNMENT units that an uncompressed page takes. */
+  static constexpr size_t UNITS_PER_PAGE = PAGE_SIZE / SLOT_ALIGNMENT;
+
+  /** SlotEntry locates the stored copy of a page in the heap file. */
+  struct SlotEntry {
+    /** Offset of the slot, in SLOT_ALIGNMENT units. */
+    uint32_t unit_;
+    /** Bytes stored in the slot; PAGE_SIZE for an uncompressed page, 0 if the page has no slot. */
+    uint32_t size_;
+  };
+
+  /** Number of map entries in one page of the db file. */
+  static constexpr size_t ENTRIES_PER_MAP_PAGE = PAGE_SIZE / sizeof(SlotEntry);
+
+  /**
+   * Creates a new disk manager that stores pages compressed.
+   * @param db_file the file name of the database file; the heap file goes next to it
+   */
+  explicit CompressedDiskManager(const std::string &db_file);
+
+  ~CompressedDiskManager() override;
+
+  void ShutDown() override;
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) override;
+
+  void WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) override;
+
+  void Submit(std::vector<DiskRequest> *requests) override;
+
+  void Sync() override;
+
+  /** Deallocates a page and gives up its slot. */
+  void DeallocatePage(page_id_t page_id) override;
+
+  /** @return the number of pages that have a slot */
+  size_t GetNumStoredPages();
+
+  /** @return the bytes stored in the slots of all pages, before rounding up to SLOT_ALIGNMENT */
+  size_t GetStoredBytes();
+
+  /** @return the size of the heap file, including free slots */
+  size_t GetHeapSize();
+
+  /** @return the bytes that page writes have written to the heap file */
+  uint64_t GetHeapBytesWritten() const { return heap_bytes_written_; }
+
+  /** @return how many times more the stored pages take uncompressed than compressed, or 0 if none is stored */
+  double GetCompressionRatio();
+
+ protected:
+  /** Flushes the heap file to disk. WriteMap calls it before it writes any map page. */
+  virtual void SyncHeap();
+  /** Writes a page of the location map to its page slot in the db file. */
+  virtual void WriteMapPage(page_id_t map_page_id, const char *map_page);
+
+ private:
+  /** @return the number of SLOT_ALIGNMENT units that size bytes take */
+  static uint32_t UnitsFor(size_t size) { return static_cast<uint32_t>((size + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT); }
+  /** Reads the map pages of the db file and collects the free slots of the heap. */
+  void LoadMap();
+  /**
+   * Syncs the heap file, then writes the map pages that changed since they were last written.
+   * @param[out] synced_free if not nullptr, receives the slots to free once the written map is durable
+   */
+  void WriteMap(std::vector<std::pair<uint32_t, uint32_t>> *synced_free);
+  /** @return the unit of a new slot of num_units units. Must hold slot_latch_. */
+  uint32_t AllocateSlot(uint32_t num_units);
+  /** Adds a slot to the free slots, merged with its free neighbours. Must hold slot_latch_. */
+  void FreeSlot(uint32_t unit, uint32_t num_units);
+  /** Gives up the slot of a page, right away or after the next Sync. Must hold slot_latch_. */
+  void ReleaseSlot(page_id_t page_id);
+
+  // descriptor of the heap file
+  int heap_fd_{-1};
+  // the location map, indexed by page id. Protected by slot_latch_, like all members below.
+  std::vector<SlotEntry> slots_;
+  // for each map page, true if it changed since it was last written
+  std::vector<bool> map_dirty_;
+  // for each page, true if its slot was written after the last Sync, so that no synced map points to it
+  std::vector<bool> unsynced_;
+  // free slots, as first unit -> number of units, and the same slots as (number of units, first unit) for best fit
+  std::map<uint32_t, uint32_t> free_by_unit_;
+  std::set<std::pair<uint32_t, uint32_t>> free_by_size_;
+  // slots of pages that were rewritten or deallocated since the last Sync, which the synced map still points to
+  std::vector<std::pair<uint32_t, uint32_t>> pending_free_;
+  // end of the heap, in units
+  uint32_t heap_end_{0};
+  size_t num_stored_pages_{0};
+  size_t stored_bytes_{0};
+  std::atomic<uint64_t> heap_bytes_written_{0};
+  std::mutex slot_latch_;
+};
+
+}  // namespace bustub
@@ -12,54 +12,157 @@
 
 #pragma once
 
+#include <sys/uio.h>
+
 #include <atomic>
-#include <fstream>
+#include <cstdlib>
 #include <future>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/async_disk_io.h"
 
 namespace bustub {
 
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Pages are read and written with positional I/O on a file descriptor, so concurrent callers never share a file cursor
+ * and page I/O needs no latch. Writes only reach the kernel; they are made durable by an explicit Sync, e.g. at a
+ * checkpoint. Log writes are made durable before WriteLog returns, since WriteLog is called at commit.
+ *
+ * Page reads and writes can also be submitted in batches and complete in the background, so that a single thread can
+ * keep many of them in flight. They go through io_uring where the kernel allows it, and through a pool of threads
+ * otherwise; see AsyncDiskIO.
+ *
+ * In direct I/O mode, both files are opened with O_DIRECT, so that pages are cached once, in the buffer pool, and not
+ * a second time in the kernel page cache. Direct I/O needs buffers, file offsets and lengths that are multiples of
+ * DIRECT_IO_ALIGNMENT. Pages sit at multiples of PAGE_SIZE in the file, and buffer pool frames are PAGE_SIZE-aligned
+ * (see FrameArena), so page I/O on frames goes straight to the device. Buffers that are not aligned are bounced through
+ * an aligned copy. Log records have arbitrary sizes, so the disk manager keeps the last, partial block of the log in
+ * memory and rewrites it, padded with zeros, along with the next records. The padding is cut off by ShutDown; after a
+ * crash, up to one block of zeros may follow the last record.
+ *
+ * Which pages are allocated is tracked in a bitmap, so that deallocated pages are handed out again instead of the file
+ * growing forever. The bitmap is cached in memory and stored in reserved pages of the db file: every group of
+ * PAGES_PER_BITMAP pages is preceded by the bitmap page that covers it, so page page_id lives in slot
+ * page_id + page_id / PAGES_PER_BITMAP + 2 of the file. The bitmap is read back when the file is opened, and written
+ * by Sync and ShutDown. Like page writes, allocations after the last Sync may be lost in a crash.
+ *
+ * Slot 0 of the db file is a header that names the layout of the file, written when the file is created. A file
+ * without the header of the current layout, e.g. one written before the allocation bitmap existed, is refused: the
+ * constructor throws rather than read its pages from the wrong offsets.
+ *
+ * The db file grows by extents, reserved with fallocate before the first write past the end of the current one, so that
+ * pages written in sequence get contiguous blocks and writes inside an extent do not change the size of the file. An
+ * extent is disk_manager_extent_pages pages, or 1/DISK_EXTENT_GROWTH_DIVISOR of the file once that is more. The disk
+ * manager tracks the logical end of the file, past the last page written, separately from its physical end, past the
+ * last extent. ShutDown cuts the file back to its logical end.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io true to bypass the kernel page cache with O_DIRECT; falls back to buffered I/O if the file
+   * system does not support it
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool direct_io = false);
 
-  ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
-   * Write a page to the database file.
+   * Write a page to the database file. The page is not durable until the next Sync.
    * @param page_id id of the page
    * @param page_data raw page data
    */
-  void WritePage(page_id_t page_id, const char *page_data);
+  virtual void WritePage(page_id_t page_id, const char *page_data);
 
   /**
-   * Read a page from the database file.
+   * Read a page from the database file. A page past the end of the file reads as zeros.
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
-  void ReadPage(page_id_t page_id, char *page_data);
+  virtual void ReadPage(page_id_t page_id, char *page_data);
+
+  /**
+   * Read several pages from the database file. The pages are read in page id order, and each run of consecutive page
+   * ids is read with a single vectored read.
+   * @param page_ids ids of the pages
+   * @param[out] pages_data output buffers, one per page
+   * @param num_pages number of pages to read
+   */
+  virtual void ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages);
+
+  /**
+   * Write several pages to the database file. The pages are written in page id order, and each run of consecutive page
+   * ids is written with a single vectored write. Like WritePage, the pages are not durable until the next Sync.
+   * @param page_ids ids of the pages, each at most once
+   * @param pages_data raw page data, one buffer per page
+   * @param num_pages number of pages to write
+   */
+  virtual void WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages);
+
+  /**
+   * Gives access to a page without copying it, for disk managers that map their file into memory.
+   * @param page_id id of the page
+   * @return the page in a read-only mapping of the db file, or nullptr if the disk manager does not map its file or
+   * the page lies past the end of the mapping
+   */
+  virtual const char *GetMappedPage(page_id_t page_id) { return nullptr; }
+
+  /**
+   * Starts a batch of page reads and writes in the background, and empties the vector. The backend is started on the
+   * first call. Callbacks run on an I/O thread.
+   * @param requests the requests
+   */
+  virtual void Submit(std::vector<DiskRequest> *requests);
+
+  /**
+   * Runs a batch of page reads and writes in the background, and waits until all of them are done.
+   * @param requests the requests; their callbacks may be empty
+   */
+  void SubmitAndWait(std::vector<DiskRequest> *requests);
+
+  /**
+   * Starts a page read in the background.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the read is done
+   * @return a future that becomes true once the page is read in full
+   */
+  std::future<bool> SubmitRead(page_id_t page_id, char *page_data);
+
+  /**
+   * Starts a page write in the background. Like WritePage, the page is not durable until the next Sync.
+   * @param page_id id of the page
+   * @param page_data raw page data, which must stay valid until the write is done
+   * @return a future that becomes true once the page is written in full
+   */
+  std::future<bool> SubmitWrite(page_id_t page_id, const char *page_data);
+
+  /** @return true if submitted requests go through io_uring; starts the backend if it is not running */
+  bool UsesIoUring();
+
+  /**
+   * Waits until every page write that has returned is durable.
+   */
+  virtual void Sync();
 
   /**
-   * Append a log entry to the log file.
+   * Append a log entry to the log file, and wait until it is durable.
    * @param log_data raw log data
    * @param size size of log entry
    */
-  void WriteLog(char *log_data, int size);
+  virtual void WriteLog(char *log_data, int size);
 
   /**
    * Read a log entry from the log file.
@@ -68,29 +171,68 @@ class DiskManager {
    * @param offset offset of the log entry in the file
    * @return true if the read was successful, false otherwise
    */
-  bool ReadLog(char *log_data, int size, int offset);
+  virtual bool ReadLog(char *log_data, int size, int offset);
 
   /**
-   * Allocate a page on disk.
+   * Allocate a page on disk. Free pages are reused before the file grows: the first free page at or after
+   * near_page_id is taken, then the closest one before it, and otherwise the lowest free page. The search around
+   * near_page_id stops PAGES_PER_BITMAP pages away from it.
+   * @param near_page_id a page that the new page should be close to, or INVALID_PAGE_ID for no preference
+   * @param num_instances with instance_index, restricts the allocation to page ids that are instance_index modulo
+   * num_instances, as a parallel buffer pool routes them
+   * @param instance_index see num_instances
    * @return the id of the allocated page
    */
-  page_id_t AllocatePage();
+  page_id_t AllocatePage(page_id_t near_page_id = INVALID_PAGE_ID, uint32_t num_instances = 1,
+                         uint32_t instance_index = 0) {
+    return AllocatePageImpl(near_page_id, num_instances, instance_index);
+  }
 
   /**
-   * Deallocate a page on disk.
+   * Deallocate a page on disk, so that a later AllocatePage can reuse it.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(page_id_t page_id);
+  virtual void DeallocatePage(page_id_t page_id);
+
+  /**
+   * @param page_id id of a page
+   * @return true if the page is allocated
+   */
+  virtual bool IsPageAllocated(page_id_t page_id);
+
+  /** Number of pages covered by one bitmap page. */
+  static constexpr size_t PAGES_PER_BITMAP = PAGE_SIZE * 8;
+
+  /** @return true if the files were opened with O_DIRECT */
+  bool IsDirectIO() const { return direct_io_; }
+
+  /** @return true if the files were opened read-only; page and log writes then fail, and the bitmap is not written */
+  bool IsReadOnly() const { return read_only_; }
+
+  /** Alignment of buffers, offsets and lengths for direct I/O. Covers the logical block size of common devices. */
+  static constexpr size_t DIRECT_IO_ALIGNMENT = PAGE_SIZE;
 
-  /** @return the number of disk flushes */
+  /**
+   * @param data a buffer
+   * @return true if the buffer can be used for direct I/O as it is
+   */
+  static bool IsAligned(const void *data) { return reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0; }
+
+  /** @return the number of log flushes */
   int GetNumFlushes() const;
 
+  /** @return the number of page syncs */
+  int GetNumSyncs() const;
+
   /** @return true iff the in-memory content has not been flushed yet */
   bool GetFlushState() const;
 
   /** @return the number of disk writes */
   int GetNumWrites() const;
 
+  /** @return the number of disk reads */
+  int GetNumReads() const;
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -100,19 +242,165 @@ class DiskManager {
   /** Checks if the non-blocking flush future was set. */
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
+ protected:
+  /**
+   * Creates a disk manager without files, for subclasses that keep pages somewhere else, e.g. in memory. Such a
+   * subclass overrides page I/O, the log and Sync; the allocation bitmap is kept in memory only.
+   */
+  DiskManager();
+
+  /**
+   * Creates a disk manager that may only read an existing database file, e.g. the file of a read-only replica, or
+   * one that has no log, e.g. for one of several data files.
+   * @param db_file the file name of the database file
+   * @param direct_io true to bypass the kernel page cache with O_DIRECT
+   * @param read_only true to open the files read-only; they are not created if they do not exist
+   * @param open_log false to leave the log file alone; log writes then fail
+   */
+  DiskManager(const std::string &db_file, bool direct_io, bool read_only, bool open_log = true);
+
+  /** @return the descriptor of the db file, or -1 if it is not open */
+  int GetDbFd() const { return db_fd_; }
+
+  /** @return the logical size of the db file */
+  int64_t GetDbFileSize() const { return db_file_size_; }
+
+  /**
+   * Counts page reads that a subclass serves without the I/O of this class.
+   * @param num_reads the number of pages read
+   */
+  void CountReads(int num_reads) { num_reads_ += num_reads; }
+
+  /**
+   * Counts page writes that a subclass serves without the I/O of this class.
+   * @param num_writes the number of pages written
+   */
+  void CountWrites(int num_writes) { num_writes_ += num_writes; }
+
+  /** Counts a log flush that a subclass serves without the log file of this class. */
+  void CountFlush() { num_flushes_ += 1; }
+
+  /** Counts a page sync that a subclass serves without the db file of this class. */
+  void CountSync() { num_syncs_ += 1; }
+
+  /** Allocates a page; see AllocatePage. Overridden by disk managers that keep their allocation elsewhere. */
+  virtual page_id_t AllocatePageImpl(page_id_t near_page_id, uint32_t num_instances, uint32_t instance_index);
+
+  /**
+   * Writes the slot of a page in the db file, without counting a page write, e.g. for metadata that a subclass keeps
+   * in slots it does not use for pages.
+   * @param page_id id of the slot
+   * @param page_data PAGE_SIZE bytes of data
+   * @return false on an I/O error
+   */
+  bool WritePageSlot(page_id_t page_id, const char *page_data);
+
+  /**
+   * Reads the slot of a page in the db file, without counting a page read. A slot past the end of the file reads as
+   * zeros.
+   * @param page_id id of the slot
+   * @param[out] page_data PAGE_SIZE bytes of output buffer
+   * @return false on an I/O error
+   */
+  bool ReadPageSlot(page_id_t page_id, char *page_data);
+
+  /** Writes size bytes at offset of fd, retrying short writes. @return false on an I/O error */
+  static bool WriteFully(int fd, const char *data, size_t size, off_t offset);
+
+  /** @return the offset of a page in the db file */
+  static off_t PageOffset(page_id_t page_id) {
+    return (static_cast<off_t>(page_id) + page_id / PAGES_PER_BITMAP + 2) * PAGE_SIZE;
+  }
+
  private:
-  int GetFileSize(const std::string &file_name);
-  // stream to write log file
-  std::fstream log_io_;
+  friend class IoUringDiskIO;
+  friend class ThreadPoolDiskIO;
+
+  /** @return the backend for submitted requests, started on first use; nullptr after ShutDown */
+  AsyncDiskIO *GetAsyncIO();
+
+  /** @return the size of the open file fd, or -1 on error */
+  static int64_t GetFileSize(int fd);
+  /** Reads a run of consecutive pages that starts at page_id into the buffers of iov. @return false on an I/O error */
+  bool ReadRun(page_id_t page_id, struct iovec *iov, size_t num_pages);
+  /** Writes a run of consecutive pages that starts at page_id from the buffers of iov. @return false on an I/O error */
+  bool WriteRun(page_id_t page_id, struct iovec *iov, size_t num_pages);
+  /** @return the offset in the db file of the bitmap page of a group */
+  static off_t BitmapOffset(size_t group) {
+    return (static_cast<off_t>(group) * (PAGES_PER_BITMAP + 1) + 1) * PAGE_SIZE;
+  }
+  /**
+   * Writes the header of a new db file, or checks the header of an existing one.
+   * @return false if the file does not have the header of the current layout
+   */
+  bool CheckHeader();
+  /** Writes PAGE_SIZE bytes at offset of the db file, through an aligned copy if direct I/O needs one. */
+  bool WritePageAt(off_t offset, const char *page_data);
+  /** Reads PAGE_SIZE bytes at offset of the db file, through an aligned copy if direct I/O needs one. */
+  bool ReadPageAt(off_t offset, char *page_data);
+  /** Reads the bitmap pages of the db file into page_bitmap_. */
+  void LoadBitmap();
+  /** Writes the bitmap pages that changed since they were last written. Must hold bitmap_latch_. */
+  void WriteBitmap();
+  /** @return the first free page in [from, to) that is instance_index modulo num_instances, or INVALID_PAGE_ID */
+  page_id_t FindFreePage(page_id_t from, page_id_t to, uint32_t num_instances, uint32_t instance_index) const;
+  /** @return the last free page in [from, to) that is instance_index modulo num_instances, or INVALID_PAGE_ID */
+  page_id_t FindFreePageBackward(page_id_t from, page_id_t to, uint32_t num_instances, uint32_t instance_index) const;
+  /** @return true if the bit of page_id is set. Must hold bitmap_latch_. */
+  bool TestBit(page_id_t page_id) const {
+    return static_cast<size_t>(page_id) < page_bitmap_.size() * 64 &&
+           ((page_bitmap_[page_id / 64] >> (page_id % 64)) & 1) != 0;
+  }
+  /** Appends log records with direct I/O, rewriting the partial block at the end of the log. */
+  bool WriteLogDirect(const char *log_data, int size);
+  /** Reads log bytes at any offset with direct I/O, through an aligned buffer. @return bytes read, or -1 */
+  ssize_t ReadLogDirect(char *log_data, int size, int offset);
+  /** Raises db_file_size_ to at least size. */
+  void GrowFileSize(int64_t size);
+  /** Makes sure that the db file has space up to at least size, growing it by whole extents if it does not. */
+  void ReserveFileSpace(int64_t size);
+
+  // descriptor of the log file
+  int log_fd_{-1};
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // size of the log file; log writes always append at this offset. Only the log flush thread writes the log.
+  std::atomic<int64_t> log_file_size_{0};
+  // descriptor of the db file
+  int db_fd_{-1};
   std::string file_name_;
-  std::atomic<page_id_t> next_page_id_;
-  int num_flushes_;
-  int num_writes_;
-  bool flush_log_;
+  // true if both files were opened with O_DIRECT
+  bool direct_io_{false};
+  // true if both files were opened read-only
+  bool read_only_{false};
+  // in direct I/O mode, the partial block at the end of the log, rewritten by the next WriteLog. Aligned, and
+  // log_tail_capacity_ bytes long.
+  std::unique_ptr<char, decltype(&free)> log_tail_{nullptr, &free};
+  size_t log_tail_capacity_{0};
+  // logical size of the db file, the end of the last page written, tracked here so that reads need not stat the file
+  std::atomic<int64_t> db_file_size_{0};
+  // physical size of the db file, the end of the space reserved for it. Grown under extent_latch_.
+  std::atomic<int64_t> db_reserved_size_{0};
+  // false once fallocate turned out not to be supported
+  bool preallocate_{true};
+  std::mutex extent_latch_;
+  // the allocation bitmap, PAGES_PER_BITMAP bits per group; a set bit marks an allocated page
+  std::vector<uint64_t> page_bitmap_;
+  // for each group, true if its bitmap page changed since it was last written
+  std::vector<bool> bitmap_dirty_;
+  // one entry per residue class of the num_instances that allocated last: the pages of class i below
+  // first_free_pages_[i] are allocated
+  std::vector<page_id_t> first_free_pages_{0};
+  std::mutex bitmap_latch_;
+  std::atomic<int> num_flushes_;
+  std::atomic<int> num_syncs_;
+  std::atomic<int> num_writes_;
+  std::atomic<int> num_reads_;
+  std::atomic<bool> flush_log_;
   std::future<void> *flush_log_f_;
+  // backend of submitted requests, started by the first Submit and stopped by ShutDown. Protected by async_io_latch_.
+  std::unique_ptr<AsyncDiskIO> async_io_;
+  bool async_io_stopped_{false};
+  std::mutex async_io_latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_disk_manager.h
+//
+// Identification: src/include/storage/disk/memory_disk_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * MemoryDiskManager keeps pages and the log in memory, so that the buffer pool and the executors can be measured
+ * without the noise of a file system. Nothing survives the disk manager; Sync only counts.
+ *
+ * Every page gets its own buffer on its first write, which stays in place until the disk manager is destroyed, so
+ * page reads and writes only hold the latch to find the buffer, and copy outside of it. Like writes to a file,
+ * concurrent writes of the same page may tear it. A page that was never written reads as zeros.
+ *
+ * Submitted requests run synchronously, on the submitting thread, before Submit returns. Wrap the disk manager in a
+ * ThrottledDiskManager to give its I/O the latency, bandwidth and queue depth of a device.
+ */
+class MemoryDiskManager : public DiskManager {
+ public:
+  MemoryDiskManager() = default;
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) override;
+
+  void WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) override;
+
+  void Submit(std::vector<DiskRequest> *requests) override;
+
+  void Sync() override;
+
+  void WriteLog(char *log_data, int size) override;
+
+  bool ReadLog(char *log_data, int size, int offset) override;
+
+  /** @return the number of pages that have a buffer */
+  size_t GetNumStoredPages();
+
+  /** @return the size of the log */
+  size_t GetLogSize();
+
+ private:
+  /** @return the buffer of a page, or nullptr if the page was never written */
+  char *FindPage(page_id_t page_id);
+
+  // page buffers, indexed by page id. Protected by page_latch_.
+  std::vector<std::unique_ptr<char[]>> pages_;
+  size_t num_stored_pages_{0};
+  std::mutex page_latch_;
+  // the log. Protected by log_latch_.
+  std::vector<char> log_;
+  std::mutex log_latch_;
+};
+
+}  // namespace bustub
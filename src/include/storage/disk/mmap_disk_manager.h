@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mmap_disk_manager.h
+//
+// Identification: src/include/storage/disk/mmap_disk_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/** How a MmapDiskManager expects pages of its mapping to be accessed, passed on to the kernel with madvise. */
+enum class MmapAdvice { NORMAL, SEQUENTIAL, RANDOM, WILLNEED };
+
+/**
+ * MmapDiskManager serves an existing database file read-only from a shared memory mapping, e.g. on a replica that
+ * only runs analytic queries. A page read is a memcpy out of the mapping, so it costs no system call once the page is
+ * in the page cache, and a buffer pool in zero-copy mode (see buffer_pool_zero_copy) can point its frames at the
+ * mapping and skip the copy as well.
+ *
+ * The mapping covers the file as it was when the disk manager opened it; pages past its end are read through the
+ * file, and read as zeros. Page writes, log writes and allocations that would have to be written all fail, since the
+ * files are opened read-only.
+ *
+ * The kernel reads the mapping in on demand, guided by madvise: the whole mapping gets the advice passed to the
+ * constructor, e.g. SEQUENTIAL for a replica that mostly scans, and pages read with Submit, as the buffer pool
+ * prefetches them, are first advised WILLNEED so that their reads start together. Submitted reads complete before
+ * Submit returns, and their callbacks run on the submitting thread.
+ */
+class MmapDiskManager : public DiskManager {
+ public:
+  /**
+   * Maps a database file for reading.
+   * @param db_file the file name of the database file, which must exist
+   * @param advice how the pages will be accessed
+   */
+  explicit MmapDiskManager(const std::string &db_file, MmapAdvice advice = MmapAdvice::NORMAL);
+
+  ~MmapDiskManager() override;
+
+  /** Refuses to write; the mapping is read-only. */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /** Refuses to write, like WritePage. */
+  void WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) override;
+
+  const char *GetMappedPage(page_id_t page_id) override;
+
+  void Submit(std::vector<DiskRequest> *requests) override;
+
+  /**
+   * Tells the kernel how a range of pages will be accessed.
+   * @param first_page_id the first page of the range
+   * @param num_pages the number of pages in the range
+   * @param advice how the pages will be accessed
+   */
+  void Advise(page_id_t first_page_id, size_t num_pages, MmapAdvice advice);
+
+  /** @return the number of bytes of the db file that are mapped */
+  size_t GetMappedSize() const { return mapped_size_; }
+
+ private:
+  /** madvise on the part of [begin, end) that lies in the mapping, widened to whole OS pages. */
+  void AdviseRange(off_t begin, off_t end, MmapAdvice advice);
+
+  char *mapping_{nullptr};
+  size_t mapped_size_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// striped_disk_manager.h
+//
+// Identification: src/include/storage/disk/striped_disk_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * StripedDiskManager spreads the pages of a database over several data files, e.g. on different devices, so that
+ * concurrent misses and flushes keep all of them busy. Callers such as the buffer pool see one space of page ids.
+ *
+ * Page ids are cut into extents of stripe_pages consecutive pages, and the extents go to the data files in turns:
+ * extent e lives in data file e % N, as its (e / N)-th extent. Since pages are allocated from the lowest free page id,
+ * the files fill up evenly, and a scan of consecutive pages reads whole extents from each file in turn. The mapping
+ * is fixed, so the files must be reopened in the same order with the same stripe size.
+ *
+ * Every data file is a DiskManager of its own, without a log, with its own descriptor and its own asynchronous I/O
+ * queue. The db file passed to the constructor keeps the allocation bitmap, and the log goes next to it as usual.
+ * Submitted requests are split by data file and submitted to each queue. A batch of reads through ReadPages that spans
+ * several data files is read from all of them at once.
+ */
+class StripedDiskManager : public DiskManager {
+ public:
+  /** Pages per extent, unless the constructor is told otherwise. */
+  static constexpr size_t DEFAULT_STRIPE_PAGES = 64;
+
+  /**
+   * Creates a new striped disk manager.
+   * @param db_file the file name of the database file, which keeps the allocation bitmap
+   * @param data_files the file names of the data files, at least one; each must contain a '.'
+   * @param stripe_pages the number of consecutive pages that go to the same data file
+   * @param direct_io true to open the data files with O_DIRECT
+   */
+  StripedDiskManager(const std::string &db_file, const std::vector<std::string> &data_files,
+                     size_t stripe_pages = DEFAULT_STRIPE_PAGES, bool direct_io = false);
+
+  ~StripedDiskManager() override;
+
+  void ShutDown() override;
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) override;
+
+  void WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) override;
+
+  void Submit(std::vector<DiskRequest> *requests) override;
+
+  void Sync() override;
+
+  /** @return the number of data files */
+  size_t GetNumDataFiles() const { return data_files_.size(); }
+
+  /**
+   * @param page_id id of a page
+   * @return the index of the data file that holds the page, and the page's id within that file
+   */
+  std::pair<size_t, page_id_t> Locate(page_id_t page_id) const;
+
+  /**
+   * @param index index of a data file
+   * @return the disk manager of the data file, e.g. for its read and write counts
+   */
+  DiskManager *GetDataFile(size_t index) { return data_files_[index].get(); }
+
+ private:
+  class DataFile;
+
+  std::vector<std::unique_ptr<DiskManager>> data_files_;
+  const size_t stripe_pages_;
+};
+
+}  // namespace bustub
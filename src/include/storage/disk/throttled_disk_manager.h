@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// throttled_disk_manager.h
+//
+// Identification: src/include/storage/disk/throttled_disk_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/** ThrottleProfile describes the device that a ThrottledDiskManager emulates. */
+struct ThrottleProfile {
+  /** Time from the start of a read until its data starts to transfer. */
+  std::chrono::microseconds read_latency_{0};
+  /** Time from the start of a write until its data starts to transfer. */
+  std::chrono::microseconds write_latency_{0};
+  /** Time a Sync takes on top of the writes before it. */
+  std::chrono::microseconds sync_latency_{0};
+  /** Bytes per second that the device transfers, shared by all I/Os in flight; 0 for no limit. */
+  uint64_t bandwidth_{0};
+  /** Number of I/Os that the device serves at a time; further ones wait for a free slot. */
+  size_t queue_depth_{DISK_IO_QUEUE_DEPTH};
+
+  /** @return a profile like a SATA flash SSD */
+  static ThrottleProfile Ssd() {
+    return {std::chrono::microseconds(100), std::chrono::microseconds(30), std::chrono::microseconds(500),
+            500 * 1024 * 1024, 32};
+  }
+
+  /** @return a profile like a 7200 rpm hard disk: a seek and half a turn per I/O, one I/O at a time */
+  static ThrottleProfile Hdd() {
+    return {std::chrono::microseconds(8000), std::chrono::microseconds(8000), std::chrono::microseconds(8000),
+            150 * 1024 * 1024, 1};
+  }
+};
+
+/**
+ * ThrottledDiskManager wraps another disk manager, e.g. a MemoryDiskManager, and makes its page I/O as slow as the
+ * device of a ThrottleProfile, so that benchmarks of the buffer pool or the executors get the same numbers on any
+ * machine. The profile can be changed at any time; the default profile does not throttle, e.g. while a benchmark
+ * loads its data.
+ *
+ * Every I/O first waits for one of queue_depth_ slots, then for its latency, then for its transfer. Transfers take
+ * turns on a single channel of bandwidth_ bytes per second, so concurrent I/Os overlap their latencies but share the
+ * bandwidth. A batched read or write pays once per run of consecutive pages, since each run is a single request to
+ * the device. The wrapped disk manager does the actual I/O once the time is up.
+ *
+ * Submitted requests are served by DISK_IO_QUEUE_DEPTH I/O threads, started on the first Submit, so at most that many
+ * are in flight whatever the profile allows. Callbacks run on an I/O thread. Allocation, the log and the read and
+ * write counts are those of the wrapped disk manager; log writes also pay a write and a sync.
+ */
+class ThrottledDiskManager : public DiskManager {
+ public:
+  /**
+   * Creates a new throttled disk manager.
+   * @param disk_manager the disk manager that does the I/O; owned by the throttled disk manager
+   * @param profile the device to emulate
+   */
+  explicit ThrottledDiskManager(std::unique_ptr<DiskManager> disk_manager, const ThrottleProfile &profile = {});
+
+  ~ThrottledDiskManager() override;
+
+  void ShutDown() override;
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) override;
+
+  void WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) override;
+
+  void Submit(std::vector<DiskRequest> *requests) override;
+
+  void Sync() override;
+
+  void WriteLog(char *log_data, int size) override;
+
+  bool ReadLog(char *log_data, int size, int offset) override;
+
+  void DeallocatePage(page_id_t page_id) override;
+
+  bool IsPageAllocated(page_id_t page_id) override;
+
+  /** @param profile the device to emulate from now on */
+  void SetProfile(const ThrottleProfile &profile);
+
+  /** @return the device being emulated */
+  ThrottleProfile GetProfile();
+
+  /** @return the wrapped disk manager */
+  DiskManager *GetDiskManager() { return disk_manager_.get(); }
+
+ protected:
+  page_id_t AllocatePageImpl(page_id_t near_page_id, uint32_t num_instances, uint32_t instance_index) override;
+
+ private:
+  /** Waits until an I/O of num_bytes bytes would be done on the device, starting now. */
+  void Throttle(bool is_write, size_t num_bytes);
+  /** Throttles a batch of page I/Os once per run of consecutive pages. */
+  void ThrottleRuns(bool is_write, const page_id_t *page_ids, size_t num_pages);
+  /** Body of the I/O threads: serve queued requests until ShutDown. */
+  void ServeRequests();
+
+  std::unique_ptr<DiskManager> disk_manager_;
+  // the profile and the state of the emulated device. Protected by device_latch_.
+  ThrottleProfile profile_;
+  size_t num_in_flight_{0};
+  // time at which the transfer channel is free again
+  std::chrono::steady_clock::time_point channel_free_;
+  std::mutex device_latch_;
+  std::condition_variable slot_cv_;
+  // submitted requests and the threads that serve them. Protected by queue_latch_.
+  std::deque<DiskRequest> queue_;
+  std::vector<std::thread> io_threads_;
+  bool shut_down_{false};
+  std::mutex queue_latch_;
+  std::condition_variable queue_cv_;
+};
+
+}  // namespace bustub
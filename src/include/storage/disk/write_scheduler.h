@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// write_scheduler.h
+//
+// Identification: src/include/storage/disk/write_scheduler.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * WriteScheduler collects page writes, e.g. the dirty pages of a checkpoint, and hands them to a DiskManager as one
+ * batch. Flush sorts the pages by page id, so that DiskManager::WritePages writes every run of consecutive pages with
+ * a single vectored write, and makes the whole batch durable with a single Sync, instead of one write per page in
+ * whatever order the pages were found.
+ *
+ * The scheduler does not copy pages: their buffers must stay valid, and should stay unchanged, until Flush returns.
+ * A scheduler belongs to one thread at a time.
+ */
+class WriteScheduler {
+ public:
+  /**
+   * Creates a new write scheduler.
+   * @param disk_manager the disk manager that writes the pages
+   */
+  explicit WriteScheduler(DiskManager *disk_manager) : disk_manager_(disk_manager) {}
+
+  /**
+   * Queues a page write. If the page is already queued, the later write replaces the earlier one.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void Add(page_id_t page_id, const char *page_data);
+
+  /**
+   * Writes the queued pages in page id order and empties the queue.
+   * @param sync true to wait until the pages are durable, with one Sync for the whole batch
+   * @return the number of pages written
+   */
+  size_t Flush(bool sync);
+
+  /** @return the number of queued page writes */
+  size_t GetNumPending() const { return pending_.size(); }
+
+ private:
+  DiskManager *disk_manager_;
+  // queued writes, in the order they were added
+  std::vector<std::pair<page_id_t, const char *>> pending_;
+};
+
+}  // namespace bustub
@@ -18,6 +18,7 @@
 
 #include "common/config.h"
 #include "storage/index/int_comparator.h"
+#include "storage/page/page.h"
 #include "storage/page/hash_table_page_defs.h"
 
 namespace bustub {
@@ -93,6 +94,22 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * Collects the values of a key, probing from an index to the first never-occupied index or the end of the block.
+   * The block is read optimistically, without the page read latch: inserts and removes publish through the readable
+   * bits, and the probe is retried if a writer holding the page write latch (e.g. a resize) rewrites the block under
+   * it.
+   *
+   * @param page the page that holds this block
+   * @param bucket_ind the index in the block to start probing at
+   * @param key key to look up
+   * @param comparator comparator for keys
+   * @param[out] result the values associated with the key in this block are appended to it
+   * @return true if the probe stopped at a never-occupied index, i.e. the key is not in any later index
+   */
+  bool GetValues(Page *page, slot_offset_t bucket_ind, const KeyType &key, KeyComparator comparator,
+                 std::vector<ValueType> *result) const;
+
  private:
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
@@ -12,8 +12,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <thread>  // NOLINT
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -24,14 +28,33 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * A Page is a descriptor: the PAGE_SIZE bytes of data live elsewhere. The buffer pool keeps the data of all frames in
+ * one aligned arena and the descriptors in a separate array, with the fields that fetches touch in the first cache
+ * line of each descriptor.
+ *
+ * Besides the read latch, readers can read a page optimistically: the page has a version that is odd while a writer
+ * holds the write latch and is bumped again when the writer releases it. A reader snapshots an even version, reads the
+ * data without any latch, and validates that the version is unchanged; if it changed, what it read may be torn and the
+ * read is retried. Optimistic reads must therefore only copy data out of the page, and must bound every offset they
+ * read from the page itself.
  */
-class Page {
+class alignas(64) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
-  friend class BufferPoolManager;
+  friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor for a standalone page, which owns its zeroed data. */
+  Page() : owned_data_(new char[PAGE_SIZE]) {
+    data_ = owned_data_.get();
+    ResetMemory();
+  }
+
+  /**
+   * Constructor for a page whose data is owned by someone else, e.g. a frame of the buffer pool's arena.
+   * @param data the PAGE_SIZE bytes of data of the page
+   */
+  explicit Page(char *data) : data_(data) {}
 
   /** Default destructor. */
   ~Page() = default;
@@ -43,16 +66,23 @@ class Page {
   inline page_id_t GetPageId() { return page_id_; }
 
   /** @return the pin count of this page */
-  inline int GetPinCount() { return pin_count_; }
+  inline int GetPinCount() { return std::max(pin_count_.load(), 0); }
 
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline bool IsDirty() { return is_dirty_; }
 
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -60,6 +90,52 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /** @return the version of the page, which is odd while a writer holds the page write latch */
+  inline uint64_t GetVersion() { return version_.load(std::memory_order_acquire); }
+
+  /**
+   * Starts an optimistic read of the page.
+   * @param[out] version the version to validate the read against
+   * @return false if a writer holds the page write latch, in which case the read cannot start
+   */
+  inline bool TryOptimisticRead(uint64_t *version) {
+    *version = version_.load(std::memory_order_acquire);
+    return (*version & 1) == 0;
+  }
+
+  /**
+   * Ends an optimistic read of the page.
+   * @param version the version that the read started at
+   * @return true if no writer latched the page since the read started, i.e. what was read is consistent
+   */
+  inline bool ValidateOptimisticRead(uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
+  /**
+   * Runs a read of the page optimistically, retrying it while it conflicts with writers, and runs it under the read
+   * latch once OPTIMISTIC_READ_RETRIES attempts have failed. The read may run several times, so it must start over
+   * from scratch every time, and it must be safe to run on torn data.
+   * @param read the read to run
+   */
+  template <typename ReadFn>
+  inline void OptimisticRead(ReadFn &&read) {
+    for (int attempt = 0; attempt < OPTIMISTIC_READ_RETRIES; attempt++) {
+      uint64_t version;
+      if (TryOptimisticRead(&version)) {
+        read();
+        if (ValidateOptimisticRead(version)) {
+          return;
+        }
+      }
+      std::this_thread::yield();
+    }
+    RLatch();
+    read();
+    RUnlatch();
+  }
+
   /** @return the page LSN. */
   inline lsn_t GetLSN() { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -79,15 +155,22 @@ class Page {
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
   /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
-  /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  char *data_;
+  /** The ID of this page. Read without the buffer pool latch by fetches that validate a page table hit. */
+  std::atomic<page_id_t> page_id_ = INVALID_PAGE_ID;
+  /**
+   * The pin count of this page. Pinned without the buffer pool latch; negative values are sentinels of the buffer pool
+   * for frames that are free or being replaced, and cannot be pinned.
+   */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_ = false;
+  /** The version of the page for optimistic reads, bumped when the write latch is acquired and released. */
+  std::atomic<uint64_t> version_ = 0;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** The data of a standalone page; null if the data is owned by someone else. */
+  std::unique_ptr<char[]> owned_data_;
 };
 
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/sequential_read_ahead.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
@@ -99,8 +100,13 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
-  /** @return the begin iterator of this table */
-  TableIterator Begin(Transaction *txn);
+  /**
+   * @param txn the transaction performing the scan
+   * @param strategy the buffer access strategy the scan reads pages through, nullptr to use the whole buffer pool; a
+   * scan through a strategy does not read ahead
+   * @return the begin iterator of this table
+   */
+  TableIterator Begin(Transaction *txn, BufferAccessStrategy *strategy = nullptr);
 
   /** @return the end iterator of this table */
   TableIterator End();
@@ -108,11 +114,18 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * Sets how many pages scans and inserts prefetch ahead of themselves once they walk the page chain sequentially.
+   * @param window the read-ahead window in pages, 0 to disable read-ahead
+   */
+  inline void SetReadAheadWindow(size_t window) { read_ahead_window_ = window; }
+
  private:
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  size_t read_ahead_window_{TABLE_READ_AHEAD_WINDOW};
 };
 
 }  // namespace bustub
@@ -14,6 +14,8 @@
 
 #include <cassert>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/sequential_read_ahead.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -23,13 +25,15 @@ namespace bustub {
 class TableHeap;
 
 /**
- * TableIterator enables the sequential scan of a TableHeap.
+ * TableIterator enables the sequential scan of a TableHeap. Once the scan is seen to follow a sequential page chain, it
+ * keeps the table heap's read-ahead window of pages prefetched ahead of itself, unless it reads through a
+ * BufferAccessStrategy, whose ring prefetched pages would bypass.
  */
 class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferAccessStrategy *strategy = nullptr);
 
   ~TableIterator() { delete tuple_; }
 
@@ -49,6 +53,9 @@ class TableIterator {
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** The strategy that pages are fetched through while advancing, or nullptr. Not owned by the iterator. */
+  BufferAccessStrategy *strategy_;
+  SequentialReadAhead read_ahead_;
 };
 
 }  // namespace bustub
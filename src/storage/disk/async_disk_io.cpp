@@ -0,0 +1,312 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_io.cpp
+//
+// Identification: src/storage/disk/async_disk_io.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_disk_io.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "common/logger.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Points a request whose buffer direct I/O cannot use at an aligned copy. The copy is filled for a write, and copied
+ * back and freed when the request completes.
+ */
+static void BounceRequest(DiskRequest *request) {
+  auto *bounce = static_cast<char *>(aligned_alloc(DiskManager::DIRECT_IO_ALIGNMENT, PAGE_SIZE));
+  char *data = request->data_;
+  const bool is_write = request->is_write_;
+  if (is_write) {
+    memcpy(bounce, data, PAGE_SIZE);
+  }
+  request->data_ = bounce;
+  request->callback_ = [bounce, data, is_write, callback = std::move(request->callback_)](bool ok) {
+    if (!is_write) {
+      memcpy(data, bounce, PAGE_SIZE);
+    }
+    free(bounce);
+    if (callback) {
+      callback(ok);
+    }
+  };
+}
+
+std::unique_ptr<AsyncDiskIO> AsyncDiskIO::Create(DiskManager *disk_manager, int fd, size_t queue_depth,
+                                                 bool use_io_uring) {
+  if (use_io_uring) {
+    auto io_uring = std::make_unique<IoUringDiskIO>(disk_manager, fd, queue_depth);
+    if (io_uring->IsOpen()) {
+      return io_uring;
+    }
+    LOG_DEBUG("io_uring is unavailable, falling back to a thread pool");
+  }
+  return std::make_unique<ThreadPoolDiskIO>(disk_manager, queue_depth);
+}
+
+IoUringDiskIO::IoUringDiskIO(DiskManager *disk_manager, int fd, size_t queue_depth)
+    : disk_manager_(disk_manager), fd_(fd), queue_depth_(queue_depth) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &params));
+  if (ring_fd < 0) {
+    return;
+  }
+  // The kernel may round the queue up to a power of two; never keep more requests in flight than asked for.
+  queue_depth_ = std::min<size_t>(queue_depth_, params.sq_entries);
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  const int prot = PROT_READ | PROT_WRITE;
+  const int flags = MAP_SHARED | MAP_POPULATE;
+  sq_ring_ = mmap(nullptr, sq_ring_size_, prot, flags, ring_fd, IORING_OFF_SQ_RING);
+  cq_ring_ = sq_ring_;
+  if (!single_mmap && sq_ring_ != MAP_FAILED) {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, prot, flags, ring_fd, IORING_OFF_CQ_RING);
+  }
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, prot, flags, ring_fd, IORING_OFF_SQES);
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+    if (sqes != MAP_FAILED) {
+      munmap(sqes, sqes_size_);
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    sq_ring_ = cq_ring_ = nullptr;
+    close(ring_fd);
+    return;
+  }
+  sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+
+  auto *sq = static_cast<char *>(sq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto *cq = static_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+
+  ring_fd_ = ring_fd;
+  completion_thread_ = std::thread(&IoUringDiskIO::CompletionLoop, this);
+}
+
+IoUringDiskIO::~IoUringDiskIO() {
+  if (!IsOpen()) {
+    return;
+  }
+  {
+    // Wake up the completion thread with a no-op, whose empty user data tells it to stop.
+    std::unique_lock latch{sq_latch_};
+    slots_cv_.wait(latch, [&] { return in_flight_ == 0; });
+    unsigned tail = *sq_tail_;
+    PrepareEntry(tail, IORING_OP_NOP, nullptr);
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    Enter(1, 0, 0);
+  }
+  completion_thread_.join();
+
+  munmap(sqes_, sqes_size_);
+  if (cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  munmap(sq_ring_, sq_ring_size_);
+  close(ring_fd_);
+}
+
+void IoUringDiskIO::Submit(std::vector<DiskRequest> *requests) {
+  std::unique_lock latch{sq_latch_};
+  size_t next = 0;
+  while (next < requests->size()) {
+    slots_cv_.wait(latch, [&] { return in_flight_ < queue_depth_; });
+    // Only submitters write the tail, and they hold sq_latch_.
+    unsigned tail = *sq_tail_;
+    unsigned num_prepared = 0;
+    for (; next < requests->size() && in_flight_ < queue_depth_; next++) {
+      auto *request = new DiskRequest(std::move((*requests)[next]));
+      if (disk_manager_->IsDirectIO() && !DiskManager::IsAligned(request->data_)) {
+        BounceRequest(request);
+      }
+      if (request->is_write_) {
+        disk_manager_->num_writes_ += 1;
+        disk_manager_->ReserveFileSpace(DiskManager::PageOffset(request->page_id_) + PAGE_SIZE);
+      } else {
+        disk_manager_->num_reads_ += 1;
+      }
+      PrepareEntry(tail + num_prepared, request->is_write_ ? IORING_OP_WRITE : IORING_OP_READ, request);
+      num_prepared++;
+      in_flight_++;
+    }
+    __atomic_store_n(sq_tail_, tail + num_prepared, __ATOMIC_RELEASE);
+    Enter(num_prepared, 0, 0);
+  }
+  requests->clear();
+}
+
+void IoUringDiskIO::Enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+  while (true) {
+    int rc = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, nullptr, 0));
+    if (rc >= 0) {
+      // Entries the kernel did not take stay in the ring, and are taken by the next call.
+      to_submit -= std::min<unsigned>(to_submit, rc);
+      if (to_submit == 0 || (flags & IORING_ENTER_GETEVENTS) != 0) {
+        return;
+      }
+    } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      LOG_DEBUG("io_uring_enter failed: %s", strerror(errno));
+      return;
+    } else if (errno != EINTR) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void IoUringDiskIO::PrepareEntry(unsigned tail, uint8_t opcode, DiskRequest *request) {
+  const unsigned index = tail & *sq_mask_;
+  struct io_uring_sqe &sqe = sqes_[index];
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = opcode;
+  sqe.user_data = reinterpret_cast<uint64_t>(request);
+  if (request != nullptr) {
+    sqe.fd = fd_;
+    sqe.addr = reinterpret_cast<uint64_t>(request->data_);
+    sqe.len = PAGE_SIZE;
+    sqe.off = DiskManager::PageOffset(request->page_id_);
+  }
+  sq_array_[index] = index;
+}
+
+void IoUringDiskIO::Complete(DiskRequest *request, int result) {
+  bool ok = result >= 0;
+  if (!ok) {
+    LOG_DEBUG("I/O error on page %d: %s", request->page_id_, strerror(-result));
+  } else if (!request->is_write_ && result < PAGE_SIZE) {
+    // The page lies past the end of the file, like in DiskManager::ReadPages.
+    memset(request->data_ + result, 0, PAGE_SIZE - result);
+  } else if (request->is_write_) {
+    const off_t offset = DiskManager::PageOffset(request->page_id_);
+    // A short write is rare enough to finish synchronously.
+    ok = result == PAGE_SIZE ||
+         DiskManager::WriteFully(fd_, request->data_ + result, PAGE_SIZE - result, offset + result);
+    if (ok) {
+      disk_manager_->GrowFileSize(offset + PAGE_SIZE);
+    }
+  }
+  if (request->callback_) {
+    request->callback_(ok);
+  }
+  delete request;
+}
+
+void IoUringDiskIO::CompletionLoop() {
+  bool stop = false;
+  while (!stop) {
+    Enter(0, 1, IORING_ENTER_GETEVENTS);
+    // Only this thread writes the head.
+    unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    size_t num_completed = 0;
+    for (; head != tail; head++) {
+      const struct io_uring_cqe &cqe = cqes_[head & *cq_mask_];
+      auto *request = reinterpret_cast<DiskRequest *>(cqe.user_data);
+      if (request == nullptr) {
+        stop = true;
+        continue;
+      }
+      Complete(request, cqe.res);
+      num_completed++;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    if (num_completed > 0) {
+      std::scoped_lock latch{sq_latch_};
+      in_flight_ -= num_completed;
+      slots_cv_.notify_all();
+    }
+  }
+}
+
+ThreadPoolDiskIO::ThreadPoolDiskIO(DiskManager *disk_manager, size_t num_threads) : disk_manager_(disk_manager) {
+  for (size_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back(&ThreadPoolDiskIO::WorkerLoop, this);
+  }
+}
+
+ThreadPoolDiskIO::~ThreadPoolDiskIO() {
+  {
+    std::scoped_lock latch{latch_};
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPoolDiskIO::Submit(std::vector<DiskRequest> *requests) {
+  {
+    std::scoped_lock latch{latch_};
+    for (auto &request : *requests) {
+      queue_.push_back(std::move(request));
+    }
+  }
+  // Wake up one thread per request rather than the whole pool.
+  for (size_t i = 0; i < requests->size(); i++) {
+    cv_.notify_one();
+  }
+  requests->clear();
+}
+
+void ThreadPoolDiskIO::WorkerLoop() {
+  std::unique_lock latch{latch_};
+  while (true) {
+    cv_.wait(latch, [&] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    DiskRequest request = std::move(queue_.front());
+    queue_.pop_front();
+    latch.unlock();
+    // Go to the db file directly, like IoUringDiskIO: subclasses that wrap ReadPage or WritePage wrap Submit as well.
+    bool ok;
+    if (request.is_write_) {
+      disk_manager_->num_writes_ += 1;
+      ok = disk_manager_->WritePageSlot(request.page_id_, request.data_);
+    } else {
+      disk_manager_->num_reads_ += 1;
+      ok = disk_manager_->ReadPageSlot(request.page_id_, request.data_);
+    }
+    if (request.callback_) {
+      request.callback_(ok);
+    }
+    latch.lock();
+  }
+}
+
+}  // namespace bustub
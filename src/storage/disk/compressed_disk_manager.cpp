@@ -0,0 +1,364 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager.cpp
+//
+// Identification: src/storage/disk/compressed_disk_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/logger.h"
+#include "common/util/lz_compressor.h"
+#include "storage/disk/compressed_disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Constructor: open the db file and the heap file next to it, and load the location map
+ */
+CompressedDiskManager::CompressedDiskManager(const std::string &db_file) : DiskManager(db_file) {
+  std::string::size_type n = db_file.find('.');
+  if (n == std::string::npos) {
+    return;
+  }
+  heap_fd_ = open((db_file.substr(0, n) + ".zdb").c_str(), O_RDWR | O_CREAT, 0644);
+  if (heap_fd_ < 0) {
+    LOG_DEBUG("can't open heap file");
+    return;
+  }
+  LoadMap();
+}
+
+CompressedDiskManager::~CompressedDiskManager() { ShutDown(); }
+
+/**
+ * Write the map and close the heap file, then the files of the base class
+ */
+void CompressedDiskManager::ShutDown() {
+  if (heap_fd_ >= 0) {
+    WriteMap(nullptr);
+    close(heap_fd_);
+    heap_fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+/**
+ * Compress a page into a new slot, then point the map at it
+ */
+void CompressedDiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  CountWrites(1);
+  char compressed[LZCompressor::MaxCompressedSize(PAGE_SIZE)];
+  size_t size = LZCompressor::Compress(page_data, PAGE_SIZE, compressed, sizeof(compressed));
+  const char *data = compressed;
+  if (size == 0 || UnitsFor(size) >= UNITS_PER_PAGE) {
+    data = page_data;
+    size = PAGE_SIZE;
+  }
+
+  // The new slot is not in the map until it is written, so that Sync never makes a map durable that points to it early.
+  uint32_t unit;
+  {
+    std::scoped_lock slot_latch{slot_latch_};
+    unit = AllocateSlot(UnitsFor(size));
+  }
+  bool ok = WriteFully(heap_fd_, data, size, static_cast<off_t>(unit) * SLOT_ALIGNMENT);
+  if (!ok) {
+    LOG_DEBUG("I/O error while writing");
+  }
+  heap_bytes_written_ += size;
+
+  std::scoped_lock slot_latch{slot_latch_};
+  if (!ok) {
+    FreeSlot(unit, UnitsFor(size));
+    return;
+  }
+  if (static_cast<size_t>(page_id) >= slots_.size()) {
+    const size_t num_entries = (page_id / ENTRIES_PER_MAP_PAGE + 1) * ENTRIES_PER_MAP_PAGE;
+    slots_.resize(num_entries, SlotEntry{0, 0});
+    unsynced_.resize(num_entries, false);
+    map_dirty_.resize(num_entries / ENTRIES_PER_MAP_PAGE, false);
+  }
+  ReleaseSlot(page_id);
+  slots_[page_id] = {unit, static_cast<uint32_t>(size)};
+  unsynced_[page_id] = true;
+  map_dirty_[page_id / ENTRIES_PER_MAP_PAGE] = true;
+  num_stored_pages_++;
+  stored_bytes_ += size;
+}
+
+/**
+ * Read the slot of a page and decompress it; a page without a slot reads as zeros
+ */
+void CompressedDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  CountReads(1);
+  SlotEntry entry{0, 0};
+  {
+    std::scoped_lock slot_latch{slot_latch_};
+    if (page_id >= 0 && static_cast<size_t>(page_id) < slots_.size()) {
+      entry = slots_[page_id];
+    }
+  }
+  const off_t offset = static_cast<off_t>(entry.unit_) * SLOT_ALIGNMENT;
+  if (entry.size_ == PAGE_SIZE) {
+    ssize_t read_count = std::max<ssize_t>(pread(heap_fd_, page_data, PAGE_SIZE, offset), 0);
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+    return;
+  }
+  char compressed[PAGE_SIZE];
+  size_t page_size = 0;
+  if (entry.size_ == 0 || pread(heap_fd_, compressed, entry.size_, offset) != static_cast<ssize_t>(entry.size_) ||
+      !LZCompressor::Decompress(compressed, entry.size_, page_data, PAGE_SIZE, &page_size) ||
+      page_size != PAGE_SIZE) {
+    if (entry.size_ != 0) {
+      LOG_DEBUG("I/O error while reading");
+    }
+    memset(page_data, 0, PAGE_SIZE);
+  }
+}
+
+/**
+ * Read several pages one by one; each needs its own decompression anyway
+ */
+void CompressedDiskManager::ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) {
+  for (size_t i = 0; i < num_pages; i++) {
+    ReadPage(page_ids[i], pages_data[i]);
+  }
+}
+
+/**
+ * Compress several pages one by one; each goes to a slot of its own anyway
+ */
+void CompressedDiskManager::WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) {
+  for (size_t i = 0; i < num_pages; i++) {
+    WritePage(page_ids[i], pages_data[i]);
+  }
+}
+
+/**
+ * Run a batch of requests on the calling thread
+ */
+void CompressedDiskManager::Submit(std::vector<DiskRequest> *requests) {
+  std::vector<DiskRequest> batch;
+  batch.swap(*requests);
+  for (auto &request : batch) {
+    if (request.is_write_) {
+      WritePage(request.page_id_, request.data_);
+    } else {
+      ReadPage(request.page_id_, request.data_);
+    }
+    if (request.callback_) {
+      request.callback_(true);
+    }
+  }
+}
+
+/**
+ * Make the slots durable before the map that points to them, then the map, then free the slots that the old map
+ * pointed to
+ */
+void CompressedDiskManager::Sync() {
+  std::vector<std::pair<uint32_t, uint32_t>> synced_free;
+  WriteMap(&synced_free);
+  DiskManager::Sync();
+  std::scoped_lock slot_latch{slot_latch_};
+  for (const auto &[unit, num_units] : synced_free) {
+    FreeSlot(unit, num_units);
+  }
+}
+
+/**
+ * Drop the slot of a page along with its allocation
+ */
+void CompressedDiskManager::DeallocatePage(page_id_t page_id) {
+  {
+    std::scoped_lock slot_latch{slot_latch_};
+    if (page_id >= 0 && static_cast<size_t>(page_id) < slots_.size()) {
+      ReleaseSlot(page_id);
+    }
+  }
+  DiskManager::DeallocatePage(page_id);
+}
+
+size_t CompressedDiskManager::GetNumStoredPages() {
+  std::scoped_lock slot_latch{slot_latch_};
+  return num_stored_pages_;
+}
+
+size_t CompressedDiskManager::GetStoredBytes() {
+  std::scoped_lock slot_latch{slot_latch_};
+  return stored_bytes_;
+}
+
+size_t CompressedDiskManager::GetHeapSize() {
+  std::scoped_lock slot_latch{slot_latch_};
+  return static_cast<size_t>(heap_end_) * SLOT_ALIGNMENT;
+}
+
+double CompressedDiskManager::GetCompressionRatio() {
+  std::scoped_lock slot_latch{slot_latch_};
+  return stored_bytes_ == 0 ? 0.0 : static_cast<double>(num_stored_pages_ * PAGE_SIZE) / stored_bytes_;
+}
+
+/**
+ * Flush the heap file, so that the slots written so far survive a crash
+ */
+void CompressedDiskManager::SyncHeap() {
+  if (heap_fd_ >= 0 && fdatasync(heap_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing");
+  }
+}
+
+void CompressedDiskManager::WriteMapPage(page_id_t map_page_id, const char *map_page) {
+  WritePageSlot(map_page_id, map_page);
+}
+
+/**
+ * Private helper function to read the map pages, and to collect the gaps between the slots they point to
+ */
+void CompressedDiskManager::LoadMap() {
+  size_t num_map_pages = 0;
+  while (PageOffset(static_cast<page_id_t>(num_map_pages)) + PAGE_SIZE <= GetDbFileSize()) {
+    num_map_pages++;
+  }
+  slots_.resize(num_map_pages * ENTRIES_PER_MAP_PAGE);
+  unsynced_.assign(slots_.size(), false);
+  map_dirty_.assign(num_map_pages, false);
+  for (size_t i = 0; i < num_map_pages; i++) {
+    ReadPageSlot(static_cast<page_id_t>(i), reinterpret_cast<char *>(&slots_[i * ENTRIES_PER_MAP_PAGE]));
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> used;
+  for (const SlotEntry &entry : slots_) {
+    if (entry.size_ != 0) {
+      used.emplace_back(entry.unit_, UnitsFor(entry.size_));
+      num_stored_pages_++;
+      stored_bytes_ += entry.size_;
+    }
+  }
+  std::sort(used.begin(), used.end());
+  for (const auto &[unit, num_units] : used) {
+    if (heap_end_ < unit) {
+      FreeSlot(heap_end_, unit - heap_end_);
+    }
+    heap_end_ = std::max(heap_end_, unit + num_units);
+  }
+}
+
+/**
+ * Private helper function to make the heap durable and then write the map pages that changed. With synced_free, also
+ * hands over the slots that the map written so far points to but the new one does not, which can be freed once the
+ * new map is durable.
+ */
+void CompressedDiskManager::WriteMap(std::vector<std::pair<uint32_t, uint32_t>> *synced_free) {
+  // Copy the map pages under the latch, so that the map is written as of a single point in time.
+  std::vector<page_id_t> map_page_ids;
+  std::vector<char> map_pages;
+  {
+    std::scoped_lock slot_latch{slot_latch_};
+    for (size_t i = 0; i < map_dirty_.size(); i++) {
+      if (map_dirty_[i]) {
+        map_page_ids.push_back(static_cast<page_id_t>(i));
+        const auto *entries = reinterpret_cast<const char *>(&slots_[i * ENTRIES_PER_MAP_PAGE]);
+        map_pages.insert(map_pages.end(), entries, entries + PAGE_SIZE);
+        map_dirty_[i] = false;
+      }
+    }
+    if (synced_free != nullptr) {
+      synced_free->swap(pending_free_);
+      unsynced_.assign(unsynced_.size(), false);
+    }
+  }
+  // The kernel may write the db file back as soon as the map pages are written, so every slot that the copied map
+  // points to must be durable first. Those slots were all written before the copy was taken.
+  SyncHeap();
+  for (size_t i = 0; i < map_page_ids.size(); i++) {
+    WriteMapPage(map_page_ids[i], &map_pages[i * PAGE_SIZE]);
+  }
+}
+
+/**
+ * Private helper function to take the smallest free slot that fits and give back the rest of it, or else to append a
+ * slot to the heap, starting in the free slot at its end if there is one
+ */
+uint32_t CompressedDiskManager::AllocateSlot(uint32_t num_units) {
+  auto fit = free_by_size_.lower_bound({num_units, 0});
+  if (fit != free_by_size_.end()) {
+    auto [size, unit] = *fit;
+    free_by_size_.erase(fit);
+    free_by_unit_.erase(unit);
+    if (size > num_units) {
+      FreeSlot(unit + num_units, size - num_units);
+    }
+    return unit;
+  }
+  uint32_t unit = heap_end_;
+  if (!free_by_unit_.empty()) {
+    auto last = std::prev(free_by_unit_.end());
+    if (last->first + last->second == heap_end_) {
+      unit = last->first;
+      free_by_size_.erase({last->second, last->first});
+      free_by_unit_.erase(last);
+    }
+  }
+  heap_end_ = unit + num_units;
+  return unit;
+}
+
+/**
+ * Private helper function to add a slot to the free slots, merged with the free slots right before and after it
+ */
+void CompressedDiskManager::FreeSlot(uint32_t unit, uint32_t num_units) {
+  auto next = free_by_unit_.lower_bound(unit);
+  if (next != free_by_unit_.end() && next->first == unit + num_units) {
+    num_units += next->second;
+    free_by_size_.erase({next->second, next->first});
+    next = free_by_unit_.erase(next);
+  }
+  if (next != free_by_unit_.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == unit) {
+      unit = prev->first;
+      num_units += prev->second;
+      free_by_size_.erase({prev->second, prev->first});
+      free_by_unit_.erase(prev);
+    }
+  }
+  free_by_unit_.emplace(unit, num_units);
+  free_by_size_.emplace(num_units, unit);
+}
+
+/**
+ * Private helper function to take a page's slot out of the map. A slot that a synced map may point to is only freed
+ * by the next Sync.
+ */
+void CompressedDiskManager::ReleaseSlot(page_id_t page_id) {
+  SlotEntry &entry = slots_[page_id];
+  if (entry.size_ == 0) {
+    return;
+  }
+  num_stored_pages_--;
+  stored_bytes_ -= entry.size_;
+  if (unsynced_[page_id]) {
+    FreeSlot(entry.unit_, UnitsFor(entry.size_));
+  } else {
+    pending_free_.emplace_back(entry.unit_, UnitsFor(entry.size_));
+  }
+  entry = {0, 0};
+  unsynced_[page_id] = false;
+  map_dirty_[page_id / ENTRIES_PER_MAP_PAGE] = true;
+}
+
+}  // namespace bustub
@@ -10,13 +10,23 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>  // NOLINT
 #include <cstring>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
+#include "common/exception.h"
 #include "common/logger.h"
 #include "storage/disk/disk_manager.h"
 
@@ -24,12 +34,73 @@ namespace bustub {
 
 static char *buffer_used;
 
+/** Header in slot 0 of a db file. The rest of the page is zero. */
+struct DbFileHeader {
+  uint32_t magic_;
+  uint32_t version_;
+};
+
+static constexpr uint32_t DB_FILE_MAGIC = 0x42445442;  // "BTDB"
+/** Layout of the db file; 1 is a header page, then groups of an allocation bitmap page and the pages it covers. */
+static constexpr uint32_t DB_FILE_VERSION = 1;
+
+/**
+ * Private helper function to open or create a file, with O_DIRECT if asked for and supported. Read-only files are
+ * not created.
+ */
+static int OpenFile(const std::string &file_name, bool *direct_io, bool read_only) {
+  const int flags = read_only ? O_RDONLY : O_RDWR | O_CREAT;
+  if (*direct_io) {
+    int fd = open(file_name.c_str(), flags | O_DIRECT, 0644);
+    if (fd >= 0 || errno != EINVAL) {
+      return fd;
+    }
+    LOG_DEBUG("O_DIRECT is not supported, using buffered I/O");
+    *direct_io = false;
+  }
+  return open(file_name.c_str(), flags, 0644);
+}
+
+/**
+ * Private helper function to allocate a buffer that direct I/O can use, released with free
+ */
+static char *AllocateAligned(size_t size) {
+  return static_cast<char *>(aligned_alloc(DiskManager::DIRECT_IO_ALIGNMENT, size));
+}
+
+/**
+ * Private helper function to get a page-sized buffer for direct I/O on unaligned buffers, one per thread
+ */
+static char *GetBounceBuffer() {
+  thread_local std::unique_ptr<char, decltype(&free)> buffer{AllocateAligned(PAGE_SIZE), &free};
+  return buffer.get();
+}
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
+ * @input direct_io: bypass the page cache
+ */
+DiskManager::DiskManager(const std::string &db_file, bool direct_io) : DiskManager(db_file, direct_io, false) {}
+
+/**
+ * Constructor: no files at all
+ */
+DiskManager::DiskManager()
+    : num_flushes_(0), num_syncs_(0), num_writes_(0), num_reads_(0), flush_log_(false), flush_log_f_(nullptr) {}
+
+/**
+ * Constructor: open a single database file & log file, read-only if asked for, or a database file alone
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), next_page_id_(0), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io, bool read_only, bool open_log)
+    : file_name_(db_file),
+      read_only_(read_only),
+      num_flushes_(0),
+      num_syncs_(0),
+      num_writes_(0),
+      num_reads_(0),
+      flush_log_(false),
+      flush_log_f_(nullptr) {
   std::string::size_type n = file_name_.find('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -37,76 +108,264 @@ DiskManager::DiskManager(const std::string &db_file)
   }
   log_name_ = file_name_.substr(0, n) + ".log";
 
-  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-  // directory or file does not exist
-  if (!log_io_.is_open()) {
-    log_io_.clear();
-    // create a new file
-    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::app | std::ios::out);
-    log_io_.close();
-    // reopen with original mode
-    log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-  }
-
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+  // create the files if they do not exist and may be written; both use direct I/O or neither does
+  db_fd_ = OpenFile(db_file, &direct_io, read_only_);
+  if (db_fd_ < 0) {
+    LOG_DEBUG("can't open db file");
+  }
+  db_file_size_ = std::max<int64_t>(GetFileSize(db_fd_), 0);
+  db_reserved_size_ = db_file_size_.load();
+  if (open_log) {
+    log_fd_ = OpenFile(log_name_, &direct_io, read_only_);
+    if (log_fd_ < 0) {
+      LOG_DEBUG("can't open log file");
+    }
+  }
+  log_file_size_ = std::max<int64_t>(GetFileSize(log_fd_), 0);
+  direct_io_ = direct_io;
+
+  if (direct_io_) {
+    // Load the partial block at the end of the log, which the next WriteLog rewrites.
+    log_tail_.reset(AllocateAligned(DIRECT_IO_ALIGNMENT));
+    log_tail_capacity_ = DIRECT_IO_ALIGNMENT;
+    const int64_t tail_size = log_file_size_ % DIRECT_IO_ALIGNMENT;
+    if (tail_size > 0 && pread(log_fd_, log_tail_.get(), DIRECT_IO_ALIGNMENT, log_file_size_ - tail_size) < tail_size) {
+      LOG_DEBUG("I/O error while reading log");
+    }
+  }
+  if (db_fd_ >= 0 && !CheckHeader()) {
+    close(db_fd_);
+    if (log_fd_ >= 0) {
+      close(log_fd_);
+    }
+    throw Exception("db file " + db_file + " is not in the layout of version " + std::to_string(DB_FILE_VERSION));
   }
+  LoadBitmap();
   buffer_used = nullptr;
 }
 
+DiskManager::~DiskManager() { ShutDown(); }
+
 /**
- * Close all file streams
+ * Close all file descriptors
  */
 void DiskManager::ShutDown() {
-  db_io_.close();
-  log_io_.close();
+  {
+    // Finish the submitted requests while the files are still open.
+    std::scoped_lock async_io_latch{async_io_latch_};
+    async_io_.reset();
+    async_io_stopped_ = true;
+  }
+  if (db_fd_ >= 0) {
+    {
+      std::scoped_lock bitmap_latch{bitmap_latch_};
+      WriteBitmap();
+    }
+    // Give back the space reserved past the last page.
+    if (db_reserved_size_ > db_file_size_ && ftruncate(db_fd_, db_file_size_) != 0) {
+      LOG_DEBUG("I/O error while truncating db file");
+    }
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  if (log_fd_ >= 0) {
+    // Cut off the zeros that pad the last block of a direct I/O log.
+    if (direct_io_ && GetFileSize(log_fd_) > log_file_size_ && ftruncate(log_fd_, log_file_size_) != 0) {
+      LOG_DEBUG("I/O error while truncating log");
+    }
+    close(log_fd_);
+    log_fd_ = -1;
+  }
 }
 
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  WritePageSlot(page_id, page_data);
+}
+
+/**
+ * Write a page slot of the db file, growing the file if the slot lies past its end
+ */
+bool DiskManager::WritePageSlot(page_id_t page_id, const char *page_data) {
+  off_t offset = PageOffset(page_id);
+  ReserveFileSpace(offset + PAGE_SIZE);
   // check for I/O error
-  if (db_io_.bad()) {
+  if (!WritePageAt(offset, page_data)) {
     LOG_DEBUG("I/O error while writing");
-    return;
+    return false;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  GrowFileSize(offset + PAGE_SIZE);
+  return true;
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
+  num_reads_ += 1;
+  ReadPageSlot(page_id, page_data);
+}
+
+/**
+ * Read a page slot of the db file
+ */
+bool DiskManager::ReadPageSlot(page_id_t page_id, char *page_data) {
+  int64_t offset = PageOffset(page_id);
   // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
+  if (offset > db_file_size_.load()) {
     LOG_DEBUG("I/O error while reading");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+    memset(page_data, 0, PAGE_SIZE);
+    return true;
+  }
+  struct iovec iov {
+    page_data, PAGE_SIZE
+  };
+  return ReadRun(page_id, &iov, 1);
+}
+
+/**
+ * Hand a batch of requests to the asynchronous backend
+ */
+void DiskManager::Submit(std::vector<DiskRequest> *requests) {
+  AsyncDiskIO *async_io = GetAsyncIO();
+  if (async_io == nullptr) {
+    LOG_DEBUG("I/O submitted after shutdown");
+    for (auto &request : *requests) {
+      if (request.callback_) {
+        request.callback_(false);
+      }
     }
+    requests->clear();
+    return;
+  }
+  async_io->Submit(requests);
+}
+
+/**
+ * Submit a batch of requests and block until the last of them completes
+ */
+void DiskManager::SubmitAndWait(std::vector<DiskRequest> *requests) {
+  std::mutex done_latch;
+  std::condition_variable done_cv;
+  size_t num_pending = requests->size();
+  for (auto &request : *requests) {
+    request.callback_ = [&, callback = std::move(request.callback_)](bool ok) {
+      if (callback) {
+        callback(ok);
+      }
+      std::scoped_lock latch{done_latch};
+      if (--num_pending == 0) {
+        done_cv.notify_one();
+      }
+    };
+  }
+  Submit(requests);
+  std::unique_lock latch{done_latch};
+  done_cv.wait(latch, [&] { return num_pending == 0; });
+}
+
+/**
+ * Submit a single read whose outcome is delivered through a future
+ */
+std::future<bool> DiskManager::SubmitRead(page_id_t page_id, char *page_data) {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::vector<DiskRequest> requests;
+  requests.push_back({false, page_id, page_data, [promise](bool ok) { promise->set_value(ok); }});
+  Submit(&requests);
+  return promise->get_future();
+}
+
+/**
+ * Submit a single write whose outcome is delivered through a future
+ */
+std::future<bool> DiskManager::SubmitWrite(page_id_t page_id, const char *page_data) {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::vector<DiskRequest> requests;
+  // Writes only read the buffer.
+  requests.push_back({true, page_id, const_cast<char *>(page_data), [promise](bool ok) { promise->set_value(ok); }});
+  Submit(&requests);
+  return promise->get_future();
+}
+
+/**
+ * Returns true if the asynchronous backend is io_uring
+ */
+bool DiskManager::UsesIoUring() {
+  AsyncDiskIO *async_io = GetAsyncIO();
+  return async_io != nullptr && async_io->UsesIoUring();
+}
+
+/**
+ * Make the page writes durable
+ */
+void DiskManager::Sync() {
+  num_syncs_ += 1;
+  {
+    std::scoped_lock bitmap_latch{bitmap_latch_};
+    WriteBitmap();
+  }
+  if (fdatasync(db_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing");
+  }
+}
+
+/**
+ * Read the contents of several pages, sorted by page id and coalesced into one preadv per run of consecutive pages.
+ * A bitmap page separates the runs of two groups.
+ */
+void DiskManager::ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) {
+  std::vector<size_t> order(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return page_ids[a] < page_ids[b]; });
+
+  num_reads_ += static_cast<int>(num_pages);
+  std::vector<struct iovec> iov(std::min<size_t>(num_pages, IOV_MAX));
+  size_t run_start = 0;
+  while (run_start < num_pages) {
+    size_t run_length = 0;
+    do {
+      iov[run_length].iov_base = pages_data[order[run_start + run_length]];
+      iov[run_length].iov_len = PAGE_SIZE;
+      run_length++;
+    } while (run_start + run_length < num_pages && run_length < iov.size() &&
+             page_ids[order[run_start + run_length]] == page_ids[order[run_start + run_length - 1]] + 1 &&
+             page_ids[order[run_start + run_length]] % PAGES_PER_BITMAP != 0);
+    ReadRun(page_ids[order[run_start]], iov.data(), run_length);
+    run_start += run_length;
+  }
+}
+
+/**
+ * Write the contents of several pages, sorted by page id and coalesced into one pwritev per run of consecutive pages.
+ * A bitmap page separates the runs of two groups.
+ */
+void DiskManager::WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) {
+  std::vector<size_t> order(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return page_ids[a] < page_ids[b]; });
+
+  num_writes_ += static_cast<int>(num_pages);
+  std::vector<struct iovec> iov(std::min<size_t>(num_pages, IOV_MAX));
+  size_t run_start = 0;
+  while (run_start < num_pages) {
+    size_t run_length = 0;
+    do {
+      // Writes only read the buffers.
+      iov[run_length].iov_base = const_cast<char *>(pages_data[order[run_start + run_length]]);
+      iov[run_length].iov_len = PAGE_SIZE;
+      run_length++;
+    } while (run_start + run_length < num_pages && run_length < iov.size() &&
+             page_ids[order[run_start + run_length]] == page_ids[order[run_start + run_length - 1]] + 1 &&
+             page_ids[order[run_start + run_length]] % PAGES_PER_BITMAP != 0);
+    WriteRun(page_ids[order[run_start]], iov.data(), run_length);
+    run_start += run_length;
   }
 }
 
@@ -132,15 +391,18 @@ void DiskManager::WriteLog(char *log_data, int size) {
 
   num_flushes_ += 1;
   // sequence write
-  log_io_.write(log_data, size);
-
+  bool ok = direct_io_ ? WriteLogDirect(log_data, size) : WriteFully(log_fd_, log_data, size, log_file_size_);
   // check for I/O error
-  if (log_io_.bad()) {
+  if (!ok) {
     LOG_DEBUG("I/O error while writing log");
     return;
   }
-  // needs to flush to keep disk file in sync
-  log_io_.flush();
+  log_file_size_ += size;
+  // needs to sync to keep disk file in sync
+  if (fdatasync(log_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing log");
+    return;
+  }
   flush_log_ = false;
 }
 
@@ -150,17 +412,15 @@ void DiskManager::WriteLog(char *log_data, int size) {
  * @return: false means already reach the end
  */
 bool DiskManager::ReadLog(char *log_data, int size, int offset) {
-  if (offset >= GetFileSize(log_name_)) {
+  if (offset >= log_file_size_) {
     // LOG_DEBUG("end of log file");
-    // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
+    // LOG_DEBUG("file size is %d", log_file_size_.load());
     return false;
   }
-  log_io_.seekp(offset);
-  log_io_.read(log_data, size);
+  ssize_t read_count = direct_io_ ? ReadLogDirect(log_data, size, offset) : pread(log_fd_, log_data, size, offset);
   // if log file ends before reading "size"
-  int read_count = log_io_.gcount();
+  read_count = std::max<ssize_t>(read_count, 0);
   if (read_count < size) {
-    log_io_.clear();
     memset(log_data + read_count, 0, size - read_count);
   }
 
@@ -168,17 +428,63 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset) {
 }
 
 /**
- * Allocate new page (operations like create index/table)
- * For now just keep an increasing counter
+ * Allocate a page from the bitmap, near the hint if possible, and grow the bitmap if no page is free
+ */
+page_id_t DiskManager::AllocatePageImpl(page_id_t near_page_id, uint32_t num_instances, uint32_t instance_index) {
+  std::scoped_lock bitmap_latch{bitmap_latch_};
+  page_id_t page_id = INVALID_PAGE_ID;
+  if (near_page_id >= 0) {
+    // Look as far as one bitmap group in either direction.
+    const auto window = static_cast<page_id_t>(PAGES_PER_BITMAP);
+    page_id = FindFreePage(near_page_id, near_page_id + window, num_instances, instance_index);
+    if (page_id == INVALID_PAGE_ID) {
+      page_id = FindFreePageBackward(std::max(near_page_id - window, 0), near_page_id, num_instances, instance_index);
+    }
+  }
+  if (page_id == INVALID_PAGE_ID) {
+    if (first_free_pages_.size() != num_instances) {
+      // The page ids are split into other classes now; the lowest hint is still below every free page.
+      const page_id_t first_free_page = *std::min_element(first_free_pages_.begin(), first_free_pages_.end());
+      first_free_pages_.assign(num_instances, first_free_page);
+    }
+    // Pages past the end of the bitmap are free, so this always finds one.
+    page_id_t &first_free_page = first_free_pages_[instance_index];
+    page_id = FindFreePage(first_free_page, std::numeric_limits<page_id_t>::max(), num_instances, instance_index);
+    first_free_page = page_id + 1;
+  }
+
+  const size_t group = page_id / PAGES_PER_BITMAP;
+  if (group >= bitmap_dirty_.size()) {
+    page_bitmap_.resize((group + 1) * PAGES_PER_BITMAP / 64, 0);
+    bitmap_dirty_.resize(group + 1, true);
+  }
+  page_bitmap_[page_id / 64] |= uint64_t{1} << (page_id % 64);
+  bitmap_dirty_[group] = true;
+  return page_id;
+}
+
+/**
+ * Deallocate a page by clearing its bit; the page is reused by a later AllocatePage
  */
-page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock bitmap_latch{bitmap_latch_};
+  if (page_id < 0 || !TestBit(page_id)) {
+    LOG_DEBUG("deallocating a page that is not allocated");
+    return;
+  }
+  page_bitmap_[page_id / 64] &= ~(uint64_t{1} << (page_id % 64));
+  bitmap_dirty_[page_id / PAGES_PER_BITMAP] = true;
+  page_id_t &first_free_page = first_free_pages_[page_id % first_free_pages_.size()];
+  first_free_page = std::min(first_free_page, page_id);
+}
 
 /**
- * Deallocate page (operations like drop index/table)
- * Need bitmap in header page for tracking pages
- * This does not actually need to do anything for now.
+ * Returns true if the bit of the page is set
  */
-void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
+bool DiskManager::IsPageAllocated(page_id_t page_id) {
+  std::scoped_lock bitmap_latch{bitmap_latch_};
+  return page_id >= 0 && TestBit(page_id);
+}
 
 /**
  * Returns number of flushes made so far
@@ -190,18 +496,361 @@ int DiskManager::GetNumFlushes() const { return num_flushes_; }
  */
 int DiskManager::GetNumWrites() const { return num_writes_; }
 
+/**
+ * Returns number of Reads made so far
+ */
+int DiskManager::GetNumReads() const { return num_reads_; }
+
+/**
+ * Returns number of page syncs made so far
+ */
+int DiskManager::GetNumSyncs() const { return num_syncs_; }
+
 /**
  * Returns true if the log is currently being flushed
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+/**
+ * Private helper function to read a run of consecutive pages, zero-filling whatever lies past the end of the file
+ */
+bool DiskManager::ReadRun(page_id_t page_id, struct iovec *iov, size_t num_pages) {
+  off_t offset = PageOffset(page_id);
+  bool ok = true;
+  if (direct_io_ && std::any_of(iov, iov + num_pages, [](const struct iovec &v) { return !IsAligned(v.iov_base); })) {
+    // Direct I/O cannot fill these buffers; read the pages one by one through an aligned copy.
+    for (size_t i = 0; i < num_pages; i++, offset += PAGE_SIZE) {
+      ok = ReadPageAt(offset, static_cast<char *>(iov[i].iov_base)) && ok;
+    }
+    return ok;
+  }
+  size_t remaining = num_pages;
+  while (remaining > 0) {
+    ssize_t read_count = preadv(db_fd_, iov, static_cast<int>(remaining), offset);
+    if (read_count <= 0) {
+      if (read_count < 0) {
+        LOG_DEBUG("I/O error while reading");
+        ok = false;
+      }
+      break;
+    }
+    offset += read_count;
+    // Skip the buffers that are full and continue in the one the read stopped in.
+    auto done = static_cast<size_t>(read_count);
+    while (remaining > 0 && done >= iov->iov_len) {
+      done -= iov->iov_len;
+      iov++;
+      remaining--;
+    }
+    if (remaining > 0) {
+      iov->iov_base = static_cast<char *>(iov->iov_base) + done;
+      iov->iov_len -= done;
+    }
+  }
+  for (size_t i = 0; i < remaining; i++) {
+    memset(iov[i].iov_base, 0, iov[i].iov_len);
+  }
+  return ok;
+}
+
+/**
+ * Private helper function to write a run of consecutive pages, resuming after short writes
+ */
+bool DiskManager::WriteRun(page_id_t page_id, struct iovec *iov, size_t num_pages) {
+  off_t offset = PageOffset(page_id);
+  ReserveFileSpace(offset + static_cast<int64_t>(num_pages * PAGE_SIZE));
+  if (direct_io_ && std::any_of(iov, iov + num_pages, [](const struct iovec &v) { return !IsAligned(v.iov_base); })) {
+    // Direct I/O cannot write these buffers; write the pages one by one through an aligned copy.
+    for (size_t i = 0; i < num_pages; i++, offset += PAGE_SIZE) {
+      if (!WritePageAt(offset, static_cast<const char *>(iov[i].iov_base))) {
+        LOG_DEBUG("I/O error while writing");
+        return false;
+      }
+      GrowFileSize(offset + PAGE_SIZE);
+    }
+    return true;
+  }
+  size_t remaining = num_pages;
+  while (remaining > 0) {
+    ssize_t write_count = pwritev(db_fd_, iov, static_cast<int>(remaining), offset);
+    if (write_count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (write_count <= 0) {
+      LOG_DEBUG("I/O error while writing");
+      return false;
+    }
+    offset += write_count;
+    GrowFileSize(offset);
+    // Skip the buffers that are written and continue in the one the write stopped in.
+    auto done = static_cast<size_t>(write_count);
+    while (remaining > 0 && done >= iov->iov_len) {
+      done -= iov->iov_len;
+      iov++;
+      remaining--;
+    }
+    if (remaining > 0) {
+      iov->iov_base = static_cast<char *>(iov->iov_base) + done;
+      iov->iov_len -= done;
+    }
+  }
+  return true;
+}
+
+/**
+ * Private helper function to start the asynchronous backend on first use
+ */
+AsyncDiskIO *DiskManager::GetAsyncIO() {
+  std::scoped_lock async_io_latch{async_io_latch_};
+  if (async_io_ == nullptr && !async_io_stopped_ && db_fd_ >= 0) {
+    async_io_ = AsyncDiskIO::Create(this, db_fd_, DISK_IO_QUEUE_DEPTH, disk_manager_use_io_uring);
+  }
+  return async_io_.get();
+}
+
+/**
+ * Private helper function to write a buffer at a position, resuming after short writes
+ */
+bool DiskManager::WriteFully(int fd, const char *data, size_t size, off_t offset) {
+  while (size > 0) {
+    ssize_t write_count = pwrite(fd, data, size, offset);
+    if (write_count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += write_count;
+    size -= write_count;
+    offset += write_count;
+  }
+  return true;
+}
+
+/**
+ * Private helper function to write a page-sized block, bouncing it through an aligned copy if direct I/O needs one
+ */
+bool DiskManager::WritePageAt(off_t offset, const char *page_data) {
+  if (direct_io_ && !IsAligned(page_data)) {
+    char *bounce = GetBounceBuffer();
+    memcpy(bounce, page_data, PAGE_SIZE);
+    page_data = bounce;
+  }
+  return WriteFully(db_fd_, page_data, PAGE_SIZE, offset);
+}
+
+/**
+ * Private helper function to read a page-sized block, bouncing it through an aligned copy if direct I/O needs one.
+ * Whatever lies past the end of the file reads as zeros.
+ */
+bool DiskManager::ReadPageAt(off_t offset, char *page_data) {
+  char *buffer = direct_io_ && !IsAligned(page_data) ? GetBounceBuffer() : page_data;
+  ssize_t result = pread(db_fd_, buffer, PAGE_SIZE, offset);
+  ssize_t read_count = std::max<ssize_t>(result, 0);
+  memset(buffer + read_count, 0, PAGE_SIZE - read_count);
+  if (buffer != page_data) {
+    memcpy(page_data, buffer, PAGE_SIZE);
+  }
+  return result >= 0;
+}
+
+/**
+ * Private helper function to write the header of a new db file, or to check the header of an existing one
+ */
+bool DiskManager::CheckHeader() {
+  std::vector<char> header_page(PAGE_SIZE, 0);
+  DbFileHeader header{DB_FILE_MAGIC, DB_FILE_VERSION};
+  if (db_file_size_ == 0) {
+    if (read_only_) {
+      return true;
+    }
+    // The header is made durable right away, so that pages written before a crash never sit in a file without one.
+    memcpy(header_page.data(), &header, sizeof(header));
+    ReserveFileSpace(PAGE_SIZE);
+    if (!WritePageAt(0, header_page.data()) || fdatasync(db_fd_) != 0) {
+      LOG_DEBUG("I/O error while writing db file header");
+    }
+    GrowFileSize(PAGE_SIZE);
+    return true;
+  }
+  DbFileHeader found;
+  ReadPageAt(0, header_page.data());
+  memcpy(&found, header_page.data(), sizeof(found));
+  return found.magic_ == header.magic_ && found.version_ == header.version_;
+}
+
+/**
+ * Private helper function to read the bitmap pages of every group that the file reaches into
+ */
+void DiskManager::LoadBitmap() {
+  std::scoped_lock bitmap_latch{bitmap_latch_};
+  size_t num_groups = 0;
+  while (BitmapOffset(num_groups) < db_file_size_) {
+    num_groups++;
+  }
+  page_bitmap_.assign(num_groups * PAGES_PER_BITMAP / 64, 0);
+  bitmap_dirty_.assign(num_groups, false);
+  for (size_t group = 0; group < num_groups; group++) {
+    ReadPageAt(BitmapOffset(group), reinterpret_cast<char *>(&page_bitmap_[group * PAGES_PER_BITMAP / 64]));
+  }
+  first_free_pages_.assign(1, 0);
+}
+
+/**
+ * Private helper function to write the bitmap pages that changed. A read-only disk manager keeps them in memory.
+ */
+void DiskManager::WriteBitmap() {
+  if (read_only_) {
+    return;
+  }
+  for (size_t group = 0; group < bitmap_dirty_.size(); group++) {
+    if (!bitmap_dirty_[group]) {
+      continue;
+    }
+    const auto *bitmap_page = reinterpret_cast<const char *>(&page_bitmap_[group * PAGES_PER_BITMAP / 64]);
+    ReserveFileSpace(BitmapOffset(group) + PAGE_SIZE);
+    if (!WritePageAt(BitmapOffset(group), bitmap_page)) {
+      LOG_DEBUG("I/O error while writing bitmap");
+      return;
+    }
+    GrowFileSize(BitmapOffset(group) + PAGE_SIZE);
+    bitmap_dirty_[group] = false;
+  }
+}
+
+/**
+ * Private helper function to scan the bitmap forward, skipping the words in which every page is allocated
+ */
+page_id_t DiskManager::FindFreePage(page_id_t from, page_id_t to, uint32_t num_instances,
+                                    uint32_t instance_index) const {
+  const auto stride = static_cast<page_id_t>(num_instances);
+  auto align = [&](page_id_t page_id) {
+    return page_id + static_cast<page_id_t>((instance_index + num_instances - page_id % num_instances) % num_instances);
+  };
+  page_id_t page_id = align(from);
+  while (page_id < to) {
+    if (static_cast<size_t>(page_id) >= page_bitmap_.size() * 64) {
+      return page_id;
+    }
+    if (page_bitmap_[page_id / 64] == ~uint64_t{0}) {
+      page_id = align((page_id / 64 + 1) * 64);
+      continue;
+    }
+    if (!TestBit(page_id)) {
+      return page_id;
+    }
+    page_id += stride;
+  }
+  return INVALID_PAGE_ID;
+}
+
+/**
+ * Private helper function to scan the bitmap backward
+ */
+page_id_t DiskManager::FindFreePageBackward(page_id_t from, page_id_t to, uint32_t num_instances,
+                                            uint32_t instance_index) const {
+  const auto stride = static_cast<page_id_t>(num_instances);
+  page_id_t page_id = to - 1;
+  page_id -= static_cast<page_id_t>((page_id % num_instances + num_instances - instance_index) % num_instances);
+  for (; page_id >= from; page_id -= stride) {
+    if (!TestBit(page_id)) {
+      return page_id;
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+/**
+ * Private helper function to append to a direct I/O log. The write starts at the block that holds the end of the log
+ * and is padded with zeros to a whole block; the new partial block is kept for the next call.
+ */
+bool DiskManager::WriteLogDirect(const char *log_data, int size) {
+  const int64_t block_start = log_file_size_ / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+  const size_t tail_size = log_file_size_ - block_start;
+  const size_t total_size = tail_size + size;
+  const size_t padded_size = (total_size + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+  if (padded_size > log_tail_capacity_) {
+    std::unique_ptr<char, decltype(&free)> buffer{AllocateAligned(padded_size), &free};
+    memcpy(buffer.get(), log_tail_.get(), tail_size);
+    log_tail_ = std::move(buffer);
+    log_tail_capacity_ = padded_size;
+  }
+  char *buffer = log_tail_.get();
+  memcpy(buffer + tail_size, log_data, size);
+  memset(buffer + total_size, 0, padded_size - total_size);
+  if (!WriteFully(log_fd_, buffer, padded_size, block_start)) {
+    return false;
+  }
+  // Keep the new partial block at the start of the buffer.
+  const size_t new_tail_size = total_size % DIRECT_IO_ALIGNMENT;
+  memmove(buffer, buffer + total_size - new_tail_size, new_tail_size);
+  return true;
+}
+
+/**
+ * Private helper function to read from a direct I/O log, through an aligned buffer that covers the requested bytes
+ */
+ssize_t DiskManager::ReadLogDirect(char *log_data, int size, int offset) {
+  const int64_t aligned_start = offset / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+  const int64_t aligned_end =
+      (static_cast<int64_t>(offset) + size + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+  std::unique_ptr<char, decltype(&free)> buffer{AllocateAligned(aligned_end - aligned_start), &free};
+  ssize_t read_count = pread(log_fd_, buffer.get(), aligned_end - aligned_start, aligned_start);
+  // Bytes past the logical end of the log are padding.
+  read_count = std::min<ssize_t>(read_count, log_file_size_ - aligned_start);
+  if (read_count <= offset - aligned_start) {
+    return 0;
+  }
+  read_count = std::min<ssize_t>(read_count - (offset - aligned_start), size);
+  memcpy(log_data, buffer.get() + (offset - aligned_start), read_count);
+  return read_count;
+}
+
+/**
+ * Private helper function to record that the db file now reaches at least size bytes
+ */
+void DiskManager::GrowFileSize(int64_t size) {
+  int64_t file_size = db_file_size_.load();
+  while (file_size < size && !db_file_size_.compare_exchange_weak(file_size, size)) {
+  }
+}
+
+/**
+ * Private helper function to reserve whole extents with fallocate. Writes within the reserved space neither allocate
+ * blocks nor change the file size.
+ */
+void DiskManager::ReserveFileSpace(int64_t size) {
+  if (size <= db_reserved_size_.load() || disk_manager_extent_pages <= 1) {
+    return;
+  }
+  std::scoped_lock extent_latch{extent_latch_};
+  const int64_t reserved_size = db_reserved_size_.load();
+  if (size <= reserved_size || !preallocate_) {
+    return;
+  }
+  // Extents grow with the file, so that a large file is made of few of them.
+  const auto extent_size = std::max(static_cast<int64_t>(disk_manager_extent_pages * PAGE_SIZE),
+                                    reserved_size / DISK_EXTENT_GROWTH_DIVISOR / PAGE_SIZE * PAGE_SIZE);
+  const int64_t new_reserved_size = std::max(size, reserved_size + extent_size);
+  if (fallocate(db_fd_, 0, reserved_size, new_reserved_size - reserved_size) != 0) {
+    if (errno == EOPNOTSUPP) {
+      LOG_DEBUG("fallocate is not supported, growing the db file page by page");
+      preallocate_ = false;
+    } else {
+      LOG_DEBUG("I/O error while growing db file");
+    }
+    return;
+  }
+  db_reserved_size_ = new_reserved_size;
+}
+
 /**
  * Private helper function to get disk file size
  */
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(int fd) {
   struct stat stat_buf;
-  int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  int rc = fstat(fd, &stat_buf);
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
 }
 
 }  // namespace bustub
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_disk_manager.cpp
+//
+// Identification: src/storage/disk/memory_disk_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/logger.h"
+#include "storage/disk/memory_disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Copy a page into its buffer, creating the buffer on the first write
+ */
+void MemoryDiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  if (page_id < 0) {
+    LOG_DEBUG("I/O error while writing");
+    return;
+  }
+  CountWrites(1);
+  char *page;
+  {
+    std::scoped_lock page_latch{page_latch_};
+    if (static_cast<size_t>(page_id) >= pages_.size()) {
+      pages_.resize(std::max<size_t>(page_id + 1, pages_.size() * 2));
+    }
+    if (pages_[page_id] == nullptr) {
+      pages_[page_id] = std::make_unique<char[]>(PAGE_SIZE);
+      num_stored_pages_++;
+    }
+    page = pages_[page_id].get();
+  }
+  memcpy(page, page_data, PAGE_SIZE);
+}
+
+/**
+ * Copy a page out of its buffer; a page that was never written reads as zeros
+ */
+void MemoryDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  CountReads(1);
+  const char *page = FindPage(page_id);
+  if (page == nullptr) {
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+  memcpy(page_data, page, PAGE_SIZE);
+}
+
+/**
+ * Read several pages one by one; there is nothing to coalesce
+ */
+void MemoryDiskManager::ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) {
+  for (size_t i = 0; i < num_pages; i++) {
+    ReadPage(page_ids[i], pages_data[i]);
+  }
+}
+
+/**
+ * Write several pages one by one; there is nothing to coalesce
+ */
+void MemoryDiskManager::WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) {
+  for (size_t i = 0; i < num_pages; i++) {
+    WritePage(page_ids[i], pages_data[i]);
+  }
+}
+
+/**
+ * Run a batch of requests on the calling thread
+ */
+void MemoryDiskManager::Submit(std::vector<DiskRequest> *requests) {
+  std::vector<DiskRequest> batch;
+  batch.swap(*requests);
+  for (auto &request : batch) {
+    if (request.is_write_) {
+      WritePage(request.page_id_, request.data_);
+    } else {
+      ReadPage(request.page_id_, request.data_);
+    }
+    if (request.callback_) {
+      request.callback_(true);
+    }
+  }
+}
+
+/**
+ * Pages in memory are as durable as they get
+ */
+void MemoryDiskManager::Sync() { CountSync(); }
+
+/**
+ * Append log records to the log
+ */
+void MemoryDiskManager::WriteLog(char *log_data, int size) {
+  if (size == 0) {
+    return;
+  }
+  CountFlush();
+  std::scoped_lock log_latch{log_latch_};
+  log_.insert(log_.end(), log_data, log_data + size);
+}
+
+/**
+ * Read log bytes, zero-filling whatever lies past the end of the log
+ * @return: false means already reach the end
+ */
+bool MemoryDiskManager::ReadLog(char *log_data, int size, int offset) {
+  std::scoped_lock log_latch{log_latch_};
+  if (offset < 0 || static_cast<size_t>(offset) >= log_.size()) {
+    return false;
+  }
+  const size_t read_count = std::min(static_cast<size_t>(size), log_.size() - offset);
+  memcpy(log_data, log_.data() + offset, read_count);
+  memset(log_data + read_count, 0, size - read_count);
+  return true;
+}
+
+size_t MemoryDiskManager::GetNumStoredPages() {
+  std::scoped_lock page_latch{page_latch_};
+  return num_stored_pages_;
+}
+
+size_t MemoryDiskManager::GetLogSize() {
+  std::scoped_lock log_latch{log_latch_};
+  return log_.size();
+}
+
+/**
+ * Private helper function to look up the buffer of a page
+ */
+char *MemoryDiskManager::FindPage(page_id_t page_id) {
+  std::scoped_lock page_latch{page_latch_};
+  if (page_id < 0 || static_cast<size_t>(page_id) >= pages_.size()) {
+    return nullptr;
+  }
+  return pages_[page_id].get();
+}
+
+}  // namespace bustub
@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mmap_disk_manager.cpp
+//
+// Identification: src/storage/disk/mmap_disk_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/logger.h"
+#include "storage/disk/mmap_disk_manager.h"
+
+namespace bustub {
+
+/**
+ * Private helper function to translate an advice into its madvise flag
+ */
+static int ToMadvise(MmapAdvice advice) {
+  switch (advice) {
+    case MmapAdvice::SEQUENTIAL:
+      return MADV_SEQUENTIAL;
+    case MmapAdvice::RANDOM:
+      return MADV_RANDOM;
+    case MmapAdvice::WILLNEED:
+      return MADV_WILLNEED;
+    case MmapAdvice::NORMAL:
+    default:
+      return MADV_NORMAL;
+  }
+}
+
+/**
+ * Constructor: open the db file read-only and map all of it
+ */
+MmapDiskManager::MmapDiskManager(const std::string &db_file, MmapAdvice advice) : DiskManager(db_file, false, true) {
+  const auto file_size = static_cast<size_t>(GetDbFileSize());
+  if (GetDbFd() < 0 || file_size == 0) {
+    return;
+  }
+  void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, GetDbFd(), 0);
+  if (mapping == MAP_FAILED) {
+    LOG_DEBUG("can't map db file");
+    return;
+  }
+  mapping_ = static_cast<char *>(mapping);
+  mapped_size_ = file_size;
+  AdviseRange(0, static_cast<off_t>(mapped_size_), advice);
+}
+
+MmapDiskManager::~MmapDiskManager() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapped_size_);
+  }
+}
+
+/**
+ * Refuse to write: the db file is mapped and opened read-only
+ */
+void MmapDiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  LOG_DEBUG("write to read-only db file");
+}
+
+void MmapDiskManager::WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) {
+  LOG_DEBUG("write to read-only db file");
+}
+
+/**
+ * Copy a page out of the mapping, or read it through the file if it lies past the mapping
+ */
+void MmapDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  const char *mapped = GetMappedPage(page_id);
+  if (mapped == nullptr) {
+    DiskManager::ReadPage(page_id, page_data);
+    return;
+  }
+  CountReads(1);
+  memcpy(page_data, mapped, PAGE_SIZE);
+}
+
+/**
+ * Copy several pages out of the mapping; the kernel reads ahead on the faults of consecutive pages
+ */
+void MmapDiskManager::ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) {
+  for (size_t i = 0; i < num_pages; i++) {
+    ReadPage(page_ids[i], pages_data[i]);
+  }
+}
+
+/**
+ * Return a page in the mapping, or nullptr if it lies past the mapping
+ */
+const char *MmapDiskManager::GetMappedPage(page_id_t page_id) {
+  if (page_id < 0) {
+    return nullptr;
+  }
+  const off_t offset = PageOffset(page_id);
+  if (mapping_ == nullptr || static_cast<size_t>(offset) + PAGE_SIZE > mapped_size_) {
+    return nullptr;
+  }
+  return mapping_ + offset;
+}
+
+/**
+ * Advise the pages to be read as needed soon, so that the kernel reads them in together, then copy them out
+ */
+void MmapDiskManager::Submit(std::vector<DiskRequest> *requests) {
+  // Advise each run of consecutive pages with one call.
+  std::vector<off_t> offsets;
+  for (const auto &request : *requests) {
+    if (!request.is_write_ && GetMappedPage(request.page_id_) != nullptr) {
+      offsets.push_back(PageOffset(request.page_id_));
+    }
+  }
+  std::sort(offsets.begin(), offsets.end());
+  size_t run_start = 0;
+  for (size_t i = 1; i <= offsets.size(); i++) {
+    if (i == offsets.size() || offsets[i] > offsets[i - 1] + PAGE_SIZE) {
+      AdviseRange(offsets[run_start], offsets[i - 1] + PAGE_SIZE, MmapAdvice::WILLNEED);
+      run_start = i;
+    }
+  }
+
+  std::vector<DiskRequest> batch;
+  batch.swap(*requests);
+  for (auto &request : batch) {
+    bool ok = !request.is_write_;
+    if (ok) {
+      ReadPage(request.page_id_, request.data_);
+    } else {
+      LOG_DEBUG("write to read-only db file");
+    }
+    if (request.callback_) {
+      request.callback_(ok);
+    }
+  }
+}
+
+/**
+ * Advise a range of pages
+ */
+void MmapDiskManager::Advise(page_id_t first_page_id, size_t num_pages, MmapAdvice advice) {
+  if (num_pages == 0) {
+    return;
+  }
+  const auto last_page_id = static_cast<page_id_t>(first_page_id + num_pages - 1);
+  AdviseRange(PageOffset(first_page_id), PageOffset(last_page_id) + PAGE_SIZE, advice);
+}
+
+/**
+ * Private helper function to call madvise on the part of a byte range that lies in the mapping
+ */
+void MmapDiskManager::AdviseRange(off_t begin, off_t end, MmapAdvice advice) {
+  static const auto os_page_size = static_cast<off_t>(sysconf(_SC_PAGESIZE));
+  begin = begin / os_page_size * os_page_size;
+  end = std::min(end, static_cast<off_t>(mapped_size_));
+  if (mapping_ == nullptr || begin >= end) {
+    return;
+  }
+  if (madvise(mapping_ + begin, end - begin, ToMadvise(advice)) != 0) {
+    LOG_DEBUG("madvise failed");
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// striped_disk_manager.cpp
+//
+// Identification: src/storage/disk/striped_disk_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "storage/disk/striped_disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DataFile is a disk manager for one data file, without a log.
+ */
+class StripedDiskManager::DataFile : public DiskManager {
+ public:
+  DataFile(const std::string &file_name, bool direct_io) : DiskManager(file_name, direct_io, false, false) {}
+};
+
+/**
+ * Constructor: open the db file and the log, then every data file
+ */
+StripedDiskManager::StripedDiskManager(const std::string &db_file, const std::vector<std::string> &data_files,
+                                       size_t stripe_pages, bool direct_io)
+    : DiskManager(db_file), stripe_pages_(stripe_pages) {
+  BUSTUB_ASSERT(!data_files.empty(), "A striped disk manager needs at least one data file.");
+  BUSTUB_ASSERT(stripe_pages > 0, "An extent needs at least one page.");
+  for (const auto &file_name : data_files) {
+    data_files_.push_back(std::make_unique<DataFile>(file_name, direct_io));
+  }
+}
+
+StripedDiskManager::~StripedDiskManager() { ShutDown(); }
+
+/**
+ * Close the data files, then the files of the base class
+ */
+void StripedDiskManager::ShutDown() {
+  for (auto &data_file : data_files_) {
+    data_file->ShutDown();
+  }
+  DiskManager::ShutDown();
+}
+
+/**
+ * Write a page to its data file
+ */
+void StripedDiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  CountWrites(1);
+  auto [index, local_page_id] = Locate(page_id);
+  data_files_[index]->WritePage(local_page_id, page_data);
+}
+
+/**
+ * Read a page from its data file
+ */
+void StripedDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  CountReads(1);
+  auto [index, local_page_id] = Locate(page_id);
+  data_files_[index]->ReadPage(local_page_id, page_data);
+}
+
+/**
+ * Read several pages. Pages of a single data file are read with its vectored reads; pages of several data files go
+ * through their queues, so that the files are read in parallel.
+ */
+void StripedDiskManager::ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) {
+  std::vector<std::vector<page_id_t>> local_page_ids(data_files_.size());
+  std::vector<std::vector<char *>> local_pages_data(data_files_.size());
+  size_t num_files = 0;
+  for (size_t i = 0; i < num_pages; i++) {
+    auto [index, local_page_id] = Locate(page_ids[i]);
+    num_files += local_page_ids[index].empty() ? 1 : 0;
+    local_page_ids[index].push_back(local_page_id);
+    local_pages_data[index].push_back(pages_data[i]);
+  }
+  if (num_files <= 1) {
+    CountReads(static_cast<int>(num_pages));
+    for (size_t index = 0; index < data_files_.size(); index++) {
+      if (!local_page_ids[index].empty()) {
+        data_files_[index]->ReadPages(local_page_ids[index].data(), local_pages_data[index].data(), num_pages);
+      }
+    }
+    return;
+  }
+  std::vector<DiskRequest> requests;
+  for (size_t i = 0; i < num_pages; i++) {
+    requests.push_back({false, page_ids[i], pages_data[i], nullptr});
+  }
+  SubmitAndWait(&requests);
+}
+
+/**
+ * Write several pages, each data file its share with its own vectored writes
+ */
+void StripedDiskManager::WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) {
+  CountWrites(static_cast<int>(num_pages));
+  std::vector<std::vector<page_id_t>> local_page_ids(data_files_.size());
+  std::vector<std::vector<const char *>> local_pages_data(data_files_.size());
+  for (size_t i = 0; i < num_pages; i++) {
+    auto [index, local_page_id] = Locate(page_ids[i]);
+    local_page_ids[index].push_back(local_page_id);
+    local_pages_data[index].push_back(pages_data[i]);
+  }
+  for (size_t index = 0; index < data_files_.size(); index++) {
+    if (!local_page_ids[index].empty()) {
+      data_files_[index]->WritePages(local_page_ids[index].data(), local_pages_data[index].data(),
+                                     local_page_ids[index].size());
+    }
+  }
+}
+
+/**
+ * Split a batch of requests by data file, and hand each part to the queue of its file
+ */
+void StripedDiskManager::Submit(std::vector<DiskRequest> *requests) {
+  std::vector<std::vector<DiskRequest>> parts(data_files_.size());
+  for (auto &request : *requests) {
+    if (request.is_write_) {
+      CountWrites(1);
+    } else {
+      CountReads(1);
+    }
+    auto [index, local_page_id] = Locate(request.page_id_);
+    request.page_id_ = local_page_id;
+    parts[index].push_back(std::move(request));
+  }
+  requests->clear();
+  for (size_t index = 0; index < data_files_.size(); index++) {
+    if (!parts[index].empty()) {
+      data_files_[index]->Submit(&parts[index]);
+    }
+  }
+}
+
+/**
+ * Make the data files durable in parallel, then the allocation bitmap
+ */
+void StripedDiskManager::Sync() {
+  std::vector<std::thread> threads;
+  for (size_t index = 1; index < data_files_.size(); index++) {
+    threads.emplace_back([this, index] { data_files_[index]->Sync(); });
+  }
+  data_files_[0]->Sync();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  DiskManager::Sync();
+}
+
+/**
+ * Find the data file of a page, and the page's id within it
+ */
+std::pair<size_t, page_id_t> StripedDiskManager::Locate(page_id_t page_id) const {
+  const size_t extent = page_id / stripe_pages_;
+  const size_t num_files = data_files_.size();
+  const size_t local_page_id = extent / num_files * stripe_pages_ + page_id % stripe_pages_;
+  return {extent % num_files, static_cast<page_id_t>(local_page_id)};
+}
+
+}  // namespace bustub
@@ -0,0 +1,214 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// throttled_disk_manager.cpp
+//
+// Identification: src/storage/disk/throttled_disk_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "storage/disk/throttled_disk_manager.h"
+
+namespace bustub {
+
+ThrottledDiskManager::ThrottledDiskManager(std::unique_ptr<DiskManager> disk_manager, const ThrottleProfile &profile)
+    : disk_manager_(std::move(disk_manager)), profile_(profile) {}
+
+ThrottledDiskManager::~ThrottledDiskManager() { ShutDown(); }
+
+/**
+ * Serve the queued requests and stop the I/O threads, then shut down the wrapped disk manager
+ */
+void ThrottledDiskManager::ShutDown() {
+  std::vector<std::thread> io_threads;
+  {
+    std::scoped_lock queue_latch{queue_latch_};
+    shut_down_ = true;
+    io_threads.swap(io_threads_);
+  }
+  queue_cv_.notify_all();
+  for (auto &thread : io_threads) {
+    thread.join();
+  }
+  disk_manager_->ShutDown();
+  DiskManager::ShutDown();
+}
+
+void ThrottledDiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  CountWrites(1);
+  Throttle(true, PAGE_SIZE);
+  disk_manager_->WritePage(page_id, page_data);
+}
+
+void ThrottledDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  CountReads(1);
+  Throttle(false, PAGE_SIZE);
+  disk_manager_->ReadPage(page_id, page_data);
+}
+
+/**
+ * Pay for every run of consecutive pages in turn, as the runs of DiskManager::ReadPages are read
+ */
+void ThrottledDiskManager::ReadPages(const page_id_t *page_ids, char *const *pages_data, size_t num_pages) {
+  CountReads(static_cast<int>(num_pages));
+  ThrottleRuns(false, page_ids, num_pages);
+  disk_manager_->ReadPages(page_ids, pages_data, num_pages);
+}
+
+/**
+ * Pay for every run of consecutive pages in turn, as the runs of DiskManager::WritePages are written
+ */
+void ThrottledDiskManager::WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) {
+  CountWrites(static_cast<int>(num_pages));
+  ThrottleRuns(true, page_ids, num_pages);
+  disk_manager_->WritePages(page_ids, pages_data, num_pages);
+}
+
+/**
+ * Queue a batch of requests for the I/O threads, starting them on the first call
+ */
+void ThrottledDiskManager::Submit(std::vector<DiskRequest> *requests) {
+  {
+    std::scoped_lock queue_latch{queue_latch_};
+    if (!shut_down_) {
+      for (auto &request : *requests) {
+        queue_.push_back(std::move(request));
+      }
+      requests->clear();
+      while (io_threads_.size() < DISK_IO_QUEUE_DEPTH) {
+        io_threads_.emplace_back(&ThrottledDiskManager::ServeRequests, this);
+      }
+    }
+  }
+  if (requests->empty()) {
+    queue_cv_.notify_all();
+    return;
+  }
+  // Like DiskManager::Submit after ShutDown.
+  for (auto &request : *requests) {
+    if (request.callback_) {
+      request.callback_(false);
+    }
+  }
+  requests->clear();
+}
+
+void ThrottledDiskManager::Sync() {
+  CountSync();
+  std::this_thread::sleep_for(GetProfile().sync_latency_);
+  disk_manager_->Sync();
+}
+
+void ThrottledDiskManager::WriteLog(char *log_data, int size) {
+  if (size > 0) {
+    CountFlush();
+    Throttle(true, size);
+    std::this_thread::sleep_for(GetProfile().sync_latency_);
+  }
+  disk_manager_->WriteLog(log_data, size);
+}
+
+bool ThrottledDiskManager::ReadLog(char *log_data, int size, int offset) {
+  return disk_manager_->ReadLog(log_data, size, offset);
+}
+
+void ThrottledDiskManager::DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
+
+bool ThrottledDiskManager::IsPageAllocated(page_id_t page_id) { return disk_manager_->IsPageAllocated(page_id); }
+
+page_id_t ThrottledDiskManager::AllocatePageImpl(page_id_t near_page_id, uint32_t num_instances,
+                                                 uint32_t instance_index) {
+  return disk_manager_->AllocatePage(near_page_id, num_instances, instance_index);
+}
+
+void ThrottledDiskManager::SetProfile(const ThrottleProfile &profile) {
+  {
+    std::scoped_lock device_latch{device_latch_};
+    profile_ = profile;
+  }
+  slot_cv_.notify_all();
+}
+
+ThrottleProfile ThrottledDiskManager::GetProfile() {
+  std::scoped_lock device_latch{device_latch_};
+  return profile_;
+}
+
+/**
+ * Private helper function to take a slot of the device, book the transfer channel after the latency, and hold the
+ * slot until the transfer is done
+ */
+void ThrottledDiskManager::Throttle(bool is_write, size_t num_bytes) {
+  std::unique_lock device_latch{device_latch_};
+  auto latency = is_write ? profile_.write_latency_ : profile_.read_latency_;
+  if (latency.count() == 0 && profile_.bandwidth_ == 0) {
+    return;
+  }
+  slot_cv_.wait(device_latch, [&] { return num_in_flight_ < std::max<size_t>(profile_.queue_depth_, 1); });
+  num_in_flight_++;
+  auto now = std::chrono::steady_clock::now();
+  auto done = now + latency;
+  if (profile_.bandwidth_ > 0) {
+    auto transfer = std::chrono::nanoseconds(num_bytes * 1000000000 / profile_.bandwidth_);
+    channel_free_ = std::max(channel_free_, done) + transfer;
+    done = channel_free_;
+  }
+  device_latch.unlock();
+  std::this_thread::sleep_until(done);
+  device_latch.lock();
+  num_in_flight_--;
+  device_latch.unlock();
+  slot_cv_.notify_one();
+}
+
+/**
+ * Private helper function to pay for the runs of consecutive pages of a batch, one after the other
+ */
+void ThrottledDiskManager::ThrottleRuns(bool is_write, const page_id_t *page_ids, size_t num_pages) {
+  std::vector<page_id_t> sorted(page_ids, page_ids + num_pages);
+  std::sort(sorted.begin(), sorted.end());
+  size_t run_length = 0;
+  for (size_t i = 0; i < sorted.size(); i++) {
+    run_length++;
+    if (i + 1 == sorted.size() || sorted[i + 1] != sorted[i] + 1) {
+      Throttle(is_write, run_length * PAGE_SIZE);
+      run_length = 0;
+    }
+  }
+}
+
+/**
+ * Private helper function that each I/O thread runs: take a request, wait for the device, do the I/O, and call back
+ */
+void ThrottledDiskManager::ServeRequests() {
+  while (true) {
+    DiskRequest request;
+    {
+      std::unique_lock queue_latch{queue_latch_};
+      queue_cv_.wait(queue_latch, [&] { return shut_down_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      request = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    if (request.is_write_) {
+      WritePage(request.page_id_, request.data_);
+    } else {
+      ReadPage(request.page_id_, request.data_);
+    }
+    if (request.callback_) {
+      request.callback_(true);
+    }
+  }
+}
+
+}  // namespace bustub
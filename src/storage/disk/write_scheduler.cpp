@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// write_scheduler.cpp
+//
+// Identification: src/storage/disk/write_scheduler.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <vector>
+
+#include "storage/disk/write_scheduler.h"
+
+namespace bustub {
+
+void WriteScheduler::Add(page_id_t page_id, const char *page_data) { pending_.emplace_back(page_id, page_data); }
+
+/**
+ * Sort the queued writes by page id, keep the last write of every page, and write them as one batch
+ */
+size_t WriteScheduler::Flush(bool sync) {
+  std::stable_sort(pending_.begin(), pending_.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+  std::vector<page_id_t> page_ids;
+  std::vector<const char *> pages_data;
+  page_ids.reserve(pending_.size());
+  pages_data.reserve(pending_.size());
+  for (const auto &[page_id, page_data] : pending_) {
+    if (!page_ids.empty() && page_ids.back() == page_id) {
+      pages_data.back() = page_data;
+      continue;
+    }
+    page_ids.push_back(page_id);
+    pages_data.push_back(page_data);
+  }
+  pending_.clear();
+
+  if (!page_ids.empty()) {
+    disk_manager_->WritePages(page_ids.data(), pages_data.data(), page_ids.size());
+  }
+  if (sync) {
+    disk_manager_->Sync();
+  }
+  return page_ids.size();
+}
+
+}  // namespace bustub
@@ -267,40 +267,58 @@ void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log
 bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) {
   // Get the current slot number.
   uint32_t slot_num = rid.GetSlotNum();
-  // If somehow we have more slots than tuples, abort the transaction.
-  if (slot_num >= GetTupleCount()) {
-    if (enable_logging) {
+
+  // The page is read optimistically, so the lock manager, which may block, is only called between reads. If the
+  // transaction needs a shared lock on the RID, check that the tuple exists before taking the lock.
+  if (enable_logging && !txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid)) {
+    uint32_t tuple_size = 0;
+    bool valid_slot = false;
+    OptimisticRead([&] {
+      valid_slot = slot_num < GetTupleCount() && slot_num < MAX_TUPLE_SLOTS;
+      tuple_size = valid_slot ? GetTupleSize(slot_num) : 0;
+    });
+    // If somehow we have more slots than tuples or the tuple is deleted, abort the transaction.
+    if (!valid_slot || IsDeleted(tuple_size)) {
       txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    if (!lock_manager->LockShared(txn, rid)) {
+      return false;
     }
-    return false;
   }
-  // Otherwise get the current tuple size too.
-  uint32_t tuple_size = GetTupleSize(slot_num);
-  // If the tuple is deleted, abort the transaction.
-  if (IsDeleted(tuple_size)) {
+
+  // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result. Everything read from
+  // the page may be torn until the read is validated, so every offset is bounded before it is followed.
+  bool found = false;
+  OptimisticRead([&] {
+    found = false;
+    if (slot_num >= GetTupleCount() || slot_num >= MAX_TUPLE_SLOTS) {
+      return;
+    }
+    uint32_t tuple_size = GetTupleSize(slot_num);
+    uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
+    if (IsDeleted(tuple_size) || static_cast<uint64_t>(tuple_offset) + tuple_size > PAGE_SIZE) {
+      return;
+    }
+    if (!tuple->allocated_ || tuple->size_ != tuple_size) {
+      if (tuple->allocated_) {
+        delete[] tuple->data_;
+      }
+      tuple->data_ = new char[tuple_size];
+      tuple->size_ = tuple_size;
+      tuple->allocated_ = true;
+    }
+    memcpy(tuple->data_, GetData() + tuple_offset, tuple_size);
+    found = true;
+  });
+  // If the tuple is gone, abort the transaction.
+  if (!found) {
     if (enable_logging) {
       txn->SetState(TransactionState::ABORTED);
     }
     return false;
   }
-
-  // Otherwise we have a valid tuple, try to acquire at least a shared lock.
-  if (enable_logging) {
-    if (!txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid) && !lock_manager->LockShared(txn, rid)) {
-      return false;
-    }
-  }
-
-  // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  tuple->size_ = tuple_size;
-  if (tuple->allocated_) {
-    delete[] tuple->data_;
-  }
-  tuple->data_ = new char[tuple->size_];
-  memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
   tuple->rid_ = rid;
-  tuple->allocated_ = true;
   return true;
 }
 
@@ -10,11 +10,17 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <cstring>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
+#include "storage/disk/mmap_disk_manager.h"
 
 namespace bustub {
 
@@ -24,7 +30,7 @@ TEST(BufferPoolManagerTest, SampleTest) {
   const size_t buffer_pool_size = 10;
 
   auto *disk_manager = new DiskManager(db_name);
-  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
 
   page_id_t page_id_temp;
   auto *page0 = bpm->NewPage(&page_id_temp);
@@ -78,4 +84,948 @@ TEST(BufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BufferAccessStrategyTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t ring_size = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: fill half of the pool with a working set, and keep the other half free.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size / 2; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: a bulk write through a ring creates many more pages than the pool holds, but only ever occupies
+  // ring_size frames, so it never has to evict the working set.
+  BufferAccessStrategy strategy(ring_size);
+  std::vector<page_id_t> bulk_page_ids;
+  for (size_t i = 0; i < buffer_pool_size * 3; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp, &strategy));
+    snprintf(bpm->FetchPage(page_id_temp)->GetData(), PAGE_SIZE, "bulk %zu", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    bulk_page_ids.push_back(page_id_temp);
+  }
+
+  // Scenario: the working set is still resident, so fetching it does not read from disk.
+  const int reads_before = disk_manager->GetNumReads();
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size / 2); ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+  }
+  EXPECT_EQ(reads_before, disk_manager->GetNumReads());
+
+  // Scenario: the free frames that the ring did not use are still free.
+  for (size_t i = 0; i < buffer_pool_size / 2 - ring_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: with every other frame pinned, a scan through the ring still makes progress and reads correct data.
+  for (size_t i = 0; i < bulk_page_ids.size(); ++i) {
+    Page *page = bpm->FetchPage(bulk_page_ids[i], &strategy);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("bulk " + std::to_string(i), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(bulk_page_ids[i], false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundWriterTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: unpinning dirty pages only marks them dirty, nothing is written yet.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %zu", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_EQ(0, disk_manager->GetNumWrites());
+
+  // Scenario: the background writer cleans the pool without any foreground write.
+  BackgroundWriterOptions options;
+  options.interval_ = std::chrono::milliseconds(1);
+  options.max_pages_per_round_ = 3;
+  options.low_watermark_ = 0.0;
+  bpm->RunBackgroundWriter(options);
+  for (int i = 0; i < 1000 && bpm->GetNumBackgroundWrites() < buffer_pool_size; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bpm->StopBackgroundWriter();
+  EXPECT_EQ(buffer_pool_size, bpm->GetNumBackgroundWrites());
+  EXPECT_EQ(0, bpm->GetNumForegroundWrites());
+
+  // Scenario: what the writer put on disk is the page content.
+  char data[PAGE_SIZE];
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    disk_manager->ReadPage(static_cast<page_id_t>(i), data);
+    EXPECT_EQ("page " + std::to_string(i), std::string(data));
+  }
+
+  // Scenario: with only clean victims, new pages evict without writing on the critical path.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(0, bpm->GetNumForegroundWrites());
+
+  // Scenario: a new page is dirty even if it is unpinned clean, since its zeros are not on disk yet.
+  bpm->FlushAllPages();
+  const uint64_t flushed = bpm->GetNumForegroundWrites();
+  EXPECT_EQ(buffer_pool_size, flushed);
+
+  // Scenario: a dirty page is passed over in favour of a clean victim.
+  ASSERT_NE(nullptr, bpm->FetchPage(page_id_temp));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  for (size_t i = 0; i < buffer_pool_size - 1; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(flushed, bpm->GetNumForegroundWrites());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundWriterWakeTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: at the low watermark the writer has nothing to do, and then sleeps for its long interval.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size / 2; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  BackgroundWriterOptions options;
+  options.interval_ = std::chrono::seconds(10);
+  options.low_watermark_ = 0.5;
+  options.high_watermark_ = 1.0;
+  bpm->RunBackgroundWriter(options);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  for (size_t i = buffer_pool_size / 2; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_EQ(0, bpm->GetNumBackgroundWrites());
+
+  // Scenario: an eviction that has to write a dirty victim wakes the writer up well before the interval is over.
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  EXPECT_EQ(1, bpm->GetNumForegroundWrites());
+  while (bpm->GetNumBackgroundWrites() == 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_LT(0, bpm->GetNumBackgroundWrites());
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  bpm->StopBackgroundWriter();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// A disk manager that holds the first batch write back until the test releases it.
+class GatedWritesDiskManager : public DiskManager {
+ public:
+  explicit GatedWritesDiskManager(const std::string &db_file) : DiskManager(db_file) {}
+
+  void WritePages(const page_id_t *page_ids, const char *const *pages_data, size_t num_pages) override {
+    if (!gate_passed_.exchange(true)) {
+      gate_entered_ = true;
+      while (!gate_open_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+    DiskManager::WritePages(page_ids, pages_data, num_pages);
+  }
+
+  std::atomic<bool> gate_passed_{false};
+  std::atomic<bool> gate_entered_{false};
+  std::atomic<bool> gate_open_{false};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundWriterFlushRaceTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new GatedWritesDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), PAGE_SIZE, "v1");
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+
+  // Scenario: the background writer has copied v1 and its write is held back.
+  BackgroundWriterOptions options;
+  options.interval_ = std::chrono::milliseconds(1);
+  options.low_watermark_ = 0.0;
+  bpm->RunBackgroundWriter(options);
+  for (int i = 0; i < 1000 && !disk_manager->gate_entered_; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(disk_manager->gate_entered_);
+
+  // Scenario: an update to v2 is flushed while the stale write is in flight. The flush must not finish before that
+  // write, or the stale copy lands on top of v2 while the page is already clean.
+  page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  page->WLatch();
+  snprintf(page->GetData(), PAGE_SIZE, "v2");
+  page->WUnlatch();
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  std::atomic<bool> flushed{false};
+  std::thread flusher([&] {
+    EXPECT_EQ(true, bpm->FlushPage(page_id));
+    flushed = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(flushed);
+  disk_manager->gate_open_ = true;
+  flusher.join();
+  bpm->StopBackgroundWriter();
+
+  // Scenario: the disk holds v2.
+  char data[PAGE_SIZE];
+  disk_manager->ReadPage(page_id, data);
+  EXPECT_EQ("v2", std::string(data));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, CheckpointLatchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new GatedWritesDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size / 2; ++i) {
+    page_id_t page_id_temp;
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %zu", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    page_ids.push_back(page_id_temp);
+  }
+
+  // Scenario: while the writes of a checkpoint are held back, new pages can still be created.
+  std::thread checkpoint([&] { bpm->FlushAllPages(); });
+  for (int i = 0; i < 1000 && !disk_manager->gate_entered_; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(disk_manager->gate_entered_);
+  std::atomic<bool> created{false};
+  std::thread creator([&] {
+    page_id_t page_id_temp;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+    created = true;
+  });
+  for (int i = 0; i < 1000 && !created; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(created);
+  disk_manager->gate_open_ = true;
+  creator.join();
+  checkpoint.join();
+
+  // Scenario: the checkpoint wrote every dirty page.
+  char data[PAGE_SIZE];
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    disk_manager->ReadPage(page_ids[i], data);
+    EXPECT_EQ("page " + std::to_string(i), std::string(data));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ShutdownFlushTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  // Scenario: dirty pages that were never flushed or evicted are written back when the buffer pool is destroyed,
+  // even while the background writer is idle.
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  BackgroundWriterOptions options;
+  options.interval_ = std::chrono::seconds(10);
+  options.low_watermark_ = 1.0;
+  options.high_watermark_ = 1.0;
+  bpm->RunBackgroundWriter(options);
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size / 2; ++i) {
+    page_id_t page_id_temp;
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %zu", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    page_ids.push_back(page_id_temp);
+  }
+  EXPECT_EQ(0, bpm->GetNumBackgroundWrites());
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  // Scenario: after reopening the files, every page holds what was written before the shutdown.
+  disk_manager = new DiskManager(db_name);
+  bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PrefetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  // LRU-K evicts pages that were only accessed once in the order they were created, which keeps the test predictable.
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, ReplacerType::LRU_K);
+
+  // Scenario: write twice as many pages as the pool holds, so that the first half is evicted.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %zu", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->FlushAllPages();
+
+  // Scenario: prefetching the evicted pages reads them in the background. Resident and never allocated pages are
+  // skipped.
+  std::vector<page_id_t> page_ids;
+  for (page_id_t page_id = 0; page_id < 5; ++page_id) {
+    page_ids.push_back(page_id);
+  }
+  page_ids.push_back(static_cast<page_id_t>(buffer_pool_size * 2 - 1));
+  page_ids.push_back(static_cast<page_id_t>(buffer_pool_size * 100));
+  bpm->PrefetchPages(page_ids);
+  for (int i = 0; i < 1000 && bpm->GetNumPrefetches() < 5; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(5, bpm->GetNumPrefetches());
+
+  // Scenario: fetching the prefetched pages hits in the pool and sees their content.
+  const int reads_before = disk_manager->GetNumReads();
+  for (page_id_t page_id = 0; page_id < 5; ++page_id) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(reads_before, disk_manager->GetNumReads());
+
+  // Scenario: a fetch racing with a prefetch of the same page waits for the read and sees the content.
+  for (page_id_t page_id = 5; page_id < 10; ++page_id) {
+    bpm->PrefetchPages({page_id});
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// A disk manager whose submitted reads fail after scribbling over the buffer, like a read that breaks off midway.
+class FailingReadsDiskManager : public DiskManager {
+ public:
+  explicit FailingReadsDiskManager(const std::string &db_file) : DiskManager(db_file) {}
+
+  void Submit(std::vector<DiskRequest> *requests) override {
+    for (auto &request : *requests) {
+      memset(request.data_, 'x', PAGE_SIZE);
+      num_failed_reads_++;
+      request.callback_(false);
+    }
+    requests->clear();
+  }
+
+  std::atomic<int> num_failed_reads_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FailedPrefetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+
+  auto *disk_manager = new FailingReadsDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, ReplacerType::LRU_K);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %zu", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: a prefetch whose read fails does not publish the page; a fetch reads it again and sees its content.
+  bpm->PrefetchPages({0});
+  for (int i = 0; i < 1000 && disk_manager->num_failed_reads_ == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(1, disk_manager->num_failed_reads_);
+  const int reads_before = disk_manager->GetNumReads();
+  Page *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 0", std::string(page->GetData()));
+  EXPECT_EQ(reads_before + 1, disk_manager->GetNumReads());
+  EXPECT_EQ(0, bpm->GetNumPrefetches());
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: the frame of the failed read went back to the pool, so every frame can still be pinned.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentFetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const page_id_t num_pages = 64;
+  const int num_threads = 4;
+  const int num_ops = 5000;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: threads fetch pages that are mostly resident, racing unlatched hits against misses and evictions. Every
+  // fetch must return the frame that holds the requested page.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([bpm, tid] {
+      for (int i = 0; i < num_ops; ++i) {
+        // Mostly hit a hot set that fits the pool, sometimes miss.
+        auto page_id = static_cast<page_id_t>(i % 8 == 0 ? (i * 7 + tid) % num_pages : (i + tid) % 12);
+        Page *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ(page_id, page->GetPageId());
+        EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Scenario: all pins were released, so every frame can be replaced again.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ResizeTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  const page_id_t num_pages = 32;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: growing the pool adds free frames, so more pages can be pinned at once.
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    page_ids.push_back(page_id_temp);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  ASSERT_TRUE(bpm->Resize(buffer_pool_size * 4));
+  EXPECT_EQ(buffer_pool_size * 4, bpm->GetPoolSize());
+  while (page_ids.size() < static_cast<size_t>(num_pages)) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    page_ids.push_back(page_id_temp);
+  }
+  for (page_id_t page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: shrinking fails while a page in a frame to be removed is pinned, and changes nothing.
+  Page *last_page = bpm->FetchPage(page_ids.back());
+  ASSERT_NE(nullptr, last_page);
+  EXPECT_FALSE(bpm->Resize(buffer_pool_size));
+  EXPECT_EQ(buffer_pool_size * 4, bpm->GetPoolSize());
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids.back(), false));
+
+  // Scenario: shrinking writes the evicted dirty pages back, and they can be read again through the smaller pool.
+  ASSERT_TRUE(bpm->Resize(buffer_pool_size));
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+  for (page_id_t page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(page_ids.back()));
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+
+  // Scenario: fetches keep working while another thread resizes the pool back and forth.
+  std::thread resizer([bpm] {
+    for (int i = 0; i < 50; ++i) {
+      bpm->Resize(i % 2 == 0 ? buffer_pool_size * 2 : buffer_pool_size);
+    }
+  });
+  for (int i = 0; i < 2000; ++i) {
+    page_id_t page_id = page_ids[i % num_pages];
+    Page *page = bpm->FetchPage(page_id);
+    if (page == nullptr) {
+      continue;
+    }
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  resizer.join();
+
+  // Scenario: the pool cannot grow beyond the address space it reserved.
+  EXPECT_FALSE(bpm->Resize(buffer_pool_max_frames + 1));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FetchPagesTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, ReplacerType::LRU_K);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %zu", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->FlushAllPages();
+
+  // Scenario: a batch mixes a resident page, evicted pages out of order and a duplicate. Every page comes back with
+  // its content, the evicted ones in a single batch of reads, and the duplicate is pinned twice.
+  std::vector<page_id_t> page_ids = {19, 3, 1, 2, 2, 7};
+  std::vector<Page *> pages(page_ids.size());
+  int reads_before = disk_manager->GetNumReads();
+  EXPECT_EQ(page_ids.size(), bpm->FetchPages(page_ids.data(), page_ids.size(), pages.data()));
+  EXPECT_EQ(reads_before + 4, disk_manager->GetNumReads());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    ASSERT_NE(nullptr, pages[i]);
+    EXPECT_EQ(page_ids[i], pages[i]->GetPageId());
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(pages[i]->GetData()));
+  }
+  EXPECT_EQ(pages[3], pages[4]);
+  EXPECT_EQ(2, pages[3]->GetPinCount());
+  for (page_id_t page_id : page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(false, bpm->UnpinPage(2, false));
+
+  // Scenario: pages that get no frame come back as nullptr, and the rest are still fetched.
+  std::vector<page_id_t> many_ids;
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size + 2); ++page_id) {
+    many_ids.push_back(page_id);
+  }
+  std::vector<Page *> many_pages(many_ids.size());
+  EXPECT_EQ(buffer_pool_size, bpm->FetchPages(many_ids.data(), many_ids.size(), many_pages.data()));
+  for (size_t i = 0; i < many_ids.size(); ++i) {
+    if (many_pages[i] != nullptr) {
+      EXPECT_EQ("page " + std::to_string(many_ids[i]), std::string(many_pages[i]->GetData()));
+      EXPECT_EQ(true, bpm->UnpinPage(many_ids[i], false));
+    }
+  }
+
+  // Scenario: threads fetch overlapping batches in opposite orders. Batches that need each other's pages must not
+  // deadlock, and every page is read correctly.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < 4; ++tid) {
+    threads.emplace_back([bpm, tid] {
+      for (int round = 0; round < 200; ++round) {
+        std::vector<page_id_t> batch;
+        for (int i = 0; i < 4; ++i) {
+          auto page_id = static_cast<page_id_t>((round + i * 3) % 20);
+          batch.push_back(tid % 2 == 0 ? page_id : 19 - page_id);
+        }
+        std::vector<Page *> batch_pages(batch.size());
+        bpm->FetchPages(batch.data(), batch.size(), batch_pages.data());
+        for (size_t i = 0; i < batch.size(); ++i) {
+          if (batch_pages[i] != nullptr) {
+            EXPECT_EQ("page " + std::to_string(batch[i]), std::string(batch_pages[i]->GetData()));
+            EXPECT_EQ(true, bpm->UnpinPage(batch[i], false));
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, WarmRestartTest) {
+  const std::string db_name = "test.db";
+  const std::string dump_name = "test.bpdump";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, ReplacerType::LRU_K);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 3; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %zu", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->FlushAllPages();
+
+  // Scenario: the dump lists the resident pages, the ones used last first.
+  const std::vector<page_id_t> hot_pages = {4, 12, 7, 25};
+  for (page_id_t page_id : hot_pages) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(true, bpm->DumpResidentPages(dump_name));
+  delete bpm;
+
+  // Scenario: a smaller pool reloads the pages that were used last, and serves them without reading the disk. Page
+  // ids of the previous run are not handed out again.
+  bpm = new BufferPoolManagerInstance(hot_pages.size(), disk_manager, nullptr, ReplacerType::LRU_K);
+  EXPECT_EQ(hot_pages.size(), bpm->LoadResidentPages(dump_name));
+  EXPECT_EQ(hot_pages.size(), bpm->GetMetrics().Get(BufferPoolMetric::WARM_LOADS));
+  const int reads_before = disk_manager->GetNumReads();
+  for (page_id_t page_id : hot_pages) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(reads_before, disk_manager->GetNumReads());
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(static_cast<page_id_t>(buffer_pool_size * 3), page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  delete bpm;
+
+  // Scenario: the warm restart thread reloads in the background and saves the pool again on shutdown. A missing or
+  // garbled dump loads nothing.
+  bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  bpm->RunWarmRestart(dump_name, std::chrono::milliseconds(1));
+  for (int i = 0; i < 1000 && bpm->GetMetrics().Get(BufferPoolMetric::WARM_LOADS) < buffer_pool_size; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(buffer_pool_size, bpm->GetMetrics().Get(BufferPoolMetric::WARM_LOADS));
+  bpm->StopWarmRestart();
+  delete bpm;
+  bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  EXPECT_EQ(buffer_pool_size, bpm->LoadResidentPages(dump_name));
+  EXPECT_EQ(0, bpm->LoadResidentPages("missing.bpdump"));
+  EXPECT_EQ(0, bpm->LoadResidentPages(db_name));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove(dump_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PageReuseTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 5; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: a deleted page is handed out again, and cannot be prefetched while it is free.
+  EXPECT_EQ(true, bpm->DeletePage(2));
+  EXPECT_EQ(true, bpm->DeletePage(0));
+  bpm->PrefetchPages({0});
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  EXPECT_EQ(0, bpm->GetNumPrefetches());
+
+  // Scenario: a new page goes next to the page it is created near.
+  ASSERT_NE(nullptr, bpm->NewPageNear(&page_id_temp, 4));
+  EXPECT_EQ(5, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  ASSERT_NE(nullptr, bpm->NewPageNear(&page_id_temp, 1));
+  EXPECT_EQ(2, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PageReuseZeroesTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  page_id_t page_id_temp;
+  Page *page = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page_id_temp);
+  snprintf(page->GetData(), PAGE_SIZE, "deleted");
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  EXPECT_EQ(true, bpm->FlushPage(page_id_temp));
+  EXPECT_EQ(true, bpm->DeletePage(page_id_temp));
+
+  // Scenario: a new page on the id of a deleted page is zeroed, also after it was unpinned clean and evicted.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    page_ids.push_back(page_id_temp);
+  }
+  for (auto page_id : page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  char zeros[PAGE_SIZE] = {};
+  EXPECT_EQ(0, memcmp(zeros, page->GetData(), PAGE_SIZE));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  delete bpm;
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PagePriorityTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const page_id_t num_index_pages = 6;
+  const page_id_t num_heap_pages = 200;
+  const int scan_pages_per_lookup = 8;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < num_index_pages + num_heap_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->FlushAllPages();
+
+  // Runs a heap scan with an index lookup every few scanned pages, and returns the hit ratio of the index lookups.
+  page_id_t scan_cursor = 0;
+  auto run = [&](bool tag_index_pages) {
+    int index_hits = 0;
+    const int num_lookups = 600;
+    for (int i = 0; i < num_lookups; ++i) {
+      for (int j = 0; j < scan_pages_per_lookup; ++j) {
+        page_id_t page_id = num_index_pages + scan_cursor;
+        scan_cursor = (scan_cursor + 1) % num_heap_pages;
+        EXPECT_NE(nullptr, bpm->FetchPage(page_id));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+      page_id_t page_id = i % num_index_pages;
+      const int reads_before = disk_manager->GetNumReads();
+      PagePriority priority = page_id == 0 ? PagePriority::INDEX_ROOT : PagePriority::INDEX;
+      Page *page = tag_index_pages ? bpm->FetchPage(page_id, priority) : bpm->FetchPage(page_id);
+      EXPECT_NE(nullptr, page);
+      index_hits += disk_manager->GetNumReads() == reads_before ? 1 : 0;
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+    return static_cast<double>(index_hits) / num_lookups;
+  };
+
+  // Scenario: untagged index pages are pushed out by the scan between two lookups of the same page.
+  double untagged_hit_ratio = run(false);
+  EXPECT_LT(untagged_hit_ratio, 0.5);
+
+  // Scenario: tagged index pages outlive the heap pages of the scan.
+  double tagged_hit_ratio = run(true);
+  EXPECT_GE(tagged_hit_ratio, 0.99);
+
+  // Scenario: index pages that are no longer used age out, so they do not hold on to their frames forever.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size) * 100; ++i) {
+    page_id_t page_id = num_index_pages + i % num_heap_pages;
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  const int reads_before = disk_manager->GetNumReads();
+  for (page_id_t page_id = 0; page_id < num_index_pages; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(reads_before + num_index_pages, disk_manager->GetNumReads());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ZeroCopyTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+  const page_id_t num_pages = 8;
+  {
+    DiskManager disk_manager(db_name);
+    BufferPoolManagerInstance bpm(buffer_pool_size, &disk_manager);
+    page_id_t page_id_temp;
+    for (page_id_t i = 0; i < num_pages; ++i) {
+      Page *page = bpm.NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+      EXPECT_EQ(true, bpm.UnpinPage(page_id_temp, true));
+    }
+    bpm.FlushAllPages();
+    disk_manager.ShutDown();
+  }
+
+  buffer_pool_zero_copy = true;
+  auto *disk_manager = new MmapDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: fetched pages point into the mapping, so nothing is read or copied.
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(disk_manager->GetMappedPage(page_id), page->GetData());
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  std::vector<page_id_t> page_ids = {1, 2, 2};
+  std::vector<Page *> pages(page_ids.size());
+  EXPECT_EQ(page_ids.size(), bpm->FetchPages(page_ids.data(), page_ids.size(), pages.data()));
+  EXPECT_EQ(pages[1], pages[2]);
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    EXPECT_EQ(disk_manager->GetMappedPage(page_ids[i]), pages[i]->GetData());
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(0, disk_manager->GetNumReads());
+
+  // Scenario: frames get their own memory back when they are replaced or freed, so new pages can be written.
+  EXPECT_EQ(true, bpm->DeletePage(2));
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_NE(disk_manager->GetMappedPage(page_id_temp), page->GetData());
+    snprintf(page->GetData(), PAGE_SIZE, "new page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ("page 3", std::string(disk_manager->GetMappedPage(3)));
+
+  buffer_pool_zero_copy = false;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics_test.cpp
+//
+// Identification: test/buffer/buffer_pool_metrics_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/buffer_pool_metrics.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BufferPoolMetricsTest, SampleTest) {
+  BufferPoolMetrics metrics;
+
+  // Scenario: counts from several threads all land in the snapshot.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < 4; tid++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 1000; i++) {
+        metrics.Add(BufferPoolMetric::FETCH_HITS);
+      }
+      metrics.Add(BufferPoolMetric::FETCH_MISSES, 250);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  BufferPoolMetricsSnapshot first = metrics.Snapshot();
+  EXPECT_EQ(4000, first.Get(BufferPoolMetric::FETCH_HITS));
+  EXPECT_EQ(1000, first.Get(BufferPoolMetric::FETCH_MISSES));
+  EXPECT_DOUBLE_EQ(0.8, first.HitRatio());
+
+  // Scenario: latencies land in power-of-two microsecond buckets.
+  metrics.RecordMissLatency(std::chrono::nanoseconds(500));
+  metrics.RecordMissLatency(std::chrono::microseconds(3));
+  metrics.RecordMissLatency(std::chrono::microseconds(100));
+  metrics.RecordMissLatency(std::chrono::microseconds(100));
+  BufferPoolMetricsSnapshot second = metrics.Snapshot();
+  EXPECT_EQ(1, second.miss_latency_[0]);
+  EXPECT_EQ(1, second.miss_latency_[2]);
+  EXPECT_EQ(2, second.miss_latency_[7]);
+  EXPECT_EQ(4, second.MissLatencyPercentile(0.5));
+  EXPECT_EQ(128, second.MissLatencyPercentile(1.0));
+
+  // Scenario: a diff holds only the activity between two snapshots, and merging adds snapshots up.
+  metrics.Add(BufferPoolMetric::DIRTY_EVICTIONS, 3);
+  BufferPoolMetricsSnapshot diff = metrics.Snapshot().Diff(first);
+  EXPECT_EQ(0, diff.Get(BufferPoolMetric::FETCH_HITS));
+  EXPECT_EQ(3, diff.Get(BufferPoolMetric::DIRTY_EVICTIONS));
+  diff.Merge(first);
+  EXPECT_EQ(4000, diff.Get(BufferPoolMetric::FETCH_HITS));
+
+  // Scenario: the text dump has one line per counter.
+  std::string dump = diff.ToString();
+  EXPECT_NE(std::string::npos, dump.find("fetch_hits 4000\n"));
+  EXPECT_NE(std::string::npos, dump.find("dirty_evictions 3\n"));
+  EXPECT_NE(std::string::npos, dump.find("hit_ratio 0.8\n"));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolMetricsTest, BufferPoolManagerTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: new pages fill the pool, and further new pages evict the dirty ones.
+  page_id_t page_id;
+  for (size_t i = 0; i < buffer_pool_size * 2; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+  BufferPoolMetricsSnapshot before = bpm->GetMetrics();
+  EXPECT_EQ(buffer_pool_size * 2, before.Get(BufferPoolMetric::NEW_PAGES));
+  EXPECT_EQ(buffer_pool_size, before.Get(BufferPoolMetric::DIRTY_EVICTIONS));
+  EXPECT_LE(buffer_pool_size, before.Get(BufferPoolMetric::VICTIM_FRAMES_SCANNED));
+  EXPECT_EQ(bpm->GetNumForegroundWrites(), buffer_pool_size);
+
+  // Scenario: refetching resident pages hits, refetching evicted ones misses and evicts the now clean pages.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size * 2); i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+    bpm->UnpinPage(i, false);
+  }
+  BufferPoolMetricsSnapshot diff = bpm->GetMetrics().Diff(before);
+  EXPECT_EQ(buffer_pool_size * 2, diff.Get(BufferPoolMetric::FETCH_HITS) + diff.Get(BufferPoolMetric::FETCH_MISSES));
+  EXPECT_LE(buffer_pool_size, diff.Get(BufferPoolMetric::FETCH_MISSES));
+  EXPECT_EQ(diff.Get(BufferPoolMetric::FETCH_MISSES),
+            diff.Get(BufferPoolMetric::CLEAN_EVICTIONS) + diff.Get(BufferPoolMetric::DIRTY_EVICTIONS));
+  uint64_t num_latencies = 0;
+  for (uint64_t count : diff.miss_latency_) {
+    num_latencies += count;
+  }
+  EXPECT_EQ(diff.Get(BufferPoolMetric::FETCH_MISSES), num_latencies);
+
+  // Scenario: fetches fail once every frame is pinned.
+  std::vector<page_id_t> pinned;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    pinned.push_back(page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(1, bpm->GetMetrics().Get(BufferPoolMetric::NO_FREE_FRAME));
+  for (page_id_t pinned_page_id : pinned) {
+    bpm->UnpinPage(pinned_page_id, true);
+  }
+
+  // Scenario: flushes are counted per page written, and only dirty pages are written.
+  bpm->FlushAllPages();
+  EXPECT_EQ(buffer_pool_size, bpm->GetMetrics().Get(BufferPoolMetric::FLUSHES));
+  bpm->FlushAllPages();
+  EXPECT_EQ(buffer_pool_size, bpm->GetMetrics().Get(BufferPoolMetric::FLUSHES));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolMetricsTest, ParallelBufferPoolManagerTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new ParallelBufferPoolManager(3, 5, disk_manager);
+
+  // Scenario: a parallel buffer pool merges the metrics of its instances.
+  page_id_t page_id;
+  for (int i = 0; i < 6; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    bpm->UnpinPage(page_id, false);
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+  BufferPoolMetricsSnapshot snapshot = bpm->GetMetrics();
+  EXPECT_EQ(6, snapshot.Get(BufferPoolMetric::NEW_PAGES));
+  EXPECT_EQ(6, snapshot.Get(BufferPoolMetric::FETCH_HITS));
+  EXPECT_DOUBLE_EQ(1.0, snapshot.HitRatio());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
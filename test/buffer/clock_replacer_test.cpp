@@ -57,6 +57,97 @@ TEST(ClockReplacerTest, SampleTest) {
   EXPECT_EQ(6, value);
   clock_replacer.Victim(&value);
   EXPECT_EQ(4, value);
+
+  // Scenario: in the access order, pinned frames and frames with the reference bit set come first, then the others,
+  // newest behind the hand first.
+  clock_replacer.Unpin(1);
+  clock_replacer.Unpin(2);
+  clock_replacer.Unpin(3);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  clock_replacer.Unpin(1);
+  std::vector<frame_id_t> frames;
+  clock_replacer.GetAccessOrder(&frames);
+  EXPECT_EQ((std::vector<frame_id_t>{1, 0, 6, 5, 4, 3, 2}), frames);
+}
+
+TEST(ClockReplacerTest, PriorityTest) {
+  ClockReplacer clock_replacer(4);
+
+  // Scenario: frame 0 holds an index page, frame 1 a temp page, and frames 2 and 3 heap pages.
+  clock_replacer.SetPriority(0, PagePriority::INDEX);
+  clock_replacer.SetPriority(1, PagePriority::TEMP);
+  for (frame_id_t i = 0; i < 4; i++) {
+    clock_replacer.Unpin(i);
+  }
+
+  // Scenario: the temp page goes on the first pass, then the heap pages, and the index page last.
+  int value;
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+
+  // Scenario: a heap page that keeps being reused does not starve out the index page forever.
+  clock_replacer.Unpin(2);
+  int num_victims = 0;
+  while (true) {
+    ASSERT_TRUE(clock_replacer.Victim(&value));
+    if (value == 0) {
+      break;
+    }
+    EXPECT_EQ(2, value);
+    clock_replacer.Unpin(2);
+    num_victims++;
+  }
+  EXPECT_LE(num_victims, ClockReplacer::PRIORITY_CREDITS[static_cast<size_t>(PagePriority::INDEX)]);
+
+  // Scenario: the class is forgotten once the frame is victimized, so frame 0 now goes in clock order with the rest.
+  ASSERT_TRUE(clock_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  for (frame_id_t i = 0; i < 4; i++) {
+    clock_replacer.Unpin(i);
+  }
+  std::vector<frame_id_t> victims;
+  while (clock_replacer.Victim(&value)) {
+    victims.push_back(value);
+  }
+  EXPECT_EQ((std::vector<frame_id_t>{3, 0, 1, 2}), victims);
+}
+
+TEST(ClockReplacerTest, ConcurrencyTest) {
+  const size_t num_threads = 4;
+  const size_t frames_per_thread = 256;
+  ClockReplacer clock_replacer(num_threads * frames_per_thread);
+
+  // Scenario: threads unpin and pin disjoint ranges of frames concurrently, leaving every other frame unpinned.
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&clock_replacer, tid] {
+      for (size_t i = tid * frames_per_thread; i < (tid + 1) * frames_per_thread; i++) {
+        clock_replacer.Unpin(static_cast<frame_id_t>(i));
+      }
+      for (size_t i = tid * frames_per_thread; i < (tid + 1) * frames_per_thread; i += 2) {
+        clock_replacer.Pin(static_cast<frame_id_t>(i));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * frames_per_thread / 2, clock_replacer.Size());
+
+  // Scenario: every remaining frame is victimized exactly once.
+  std::vector<bool> victimized(num_threads * frames_per_thread, false);
+  int value;
+  while (clock_replacer.Victim(&value)) {
+    EXPECT_EQ(1, value % 2);
+    EXPECT_FALSE(victimized[value]);
+    victimized[value] = true;
+  }
+  EXPECT_EQ(0, clock_replacer.Size());
 }
 
 }  // namespace bustub
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_test.cpp
+//
+// Identification: test/buffer/compressed_page_cache_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/compressed_page_cache.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** Fills a page with compressible contents that depend on the page id. */
+static void FillPage(page_id_t page_id, char *data) {
+  memset(data, 0, PAGE_SIZE);
+  snprintf(data, PAGE_SIZE, "page %d", page_id);
+  memset(data + PAGE_SIZE / 2, 'a' + page_id % 26, 64);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, SampleTest) {
+  CompressedPageCache cache(4 * PAGE_SIZE);
+  char page[PAGE_SIZE];
+
+  // Scenario: a compressible page goes in, comes back intact, and leaves the cache on the way out.
+  FillPage(1, page);
+  EXPECT_TRUE(cache.Insert(1, page));
+  EXPECT_EQ(1, cache.GetNumPages());
+  EXPECT_LT(cache.GetBytesStored(), PAGE_SIZE / 8);
+  EXPECT_GT(cache.GetCompressionRatio(), 8.0);
+  char out[PAGE_SIZE];
+  EXPECT_TRUE(cache.Lookup(1, out));
+  EXPECT_EQ(0, memcmp(page, out, PAGE_SIZE));
+  EXPECT_FALSE(cache.Lookup(1, out));
+  EXPECT_EQ(0, cache.GetNumPages());
+  EXPECT_EQ(0, cache.GetBytesStored());
+
+  // Scenario: inserting a page again replaces the old copy, and erasing drops it.
+  FillPage(2, page);
+  EXPECT_TRUE(cache.Insert(2, page));
+  FillPage(3, page);
+  EXPECT_TRUE(cache.Insert(2, page));
+  EXPECT_EQ(1, cache.GetNumPages());
+  EXPECT_TRUE(cache.Lookup(2, out));
+  EXPECT_EQ(0, memcmp(page, out, PAGE_SIZE));
+  EXPECT_TRUE(cache.Insert(2, page));
+  cache.Erase(2);
+  EXPECT_FALSE(cache.Lookup(2, out));
+
+  // Scenario: a page that does not compress is not cached.
+  std::mt19937 rng(15445);
+  for (auto &c : page) {
+    c = static_cast<char>(rng());
+  }
+  EXPECT_FALSE(cache.Insert(4, page));
+  EXPECT_EQ(0, cache.GetNumPages());
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, EvictionTest) {
+  CompressedPageCache cache(PAGE_SIZE);
+  char page[PAGE_SIZE];
+  char out[PAGE_SIZE];
+
+  // Scenario: once the log wraps around, the oldest pages are dropped and the newest remain.
+  const page_id_t num_pages = 500;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    FillPage(page_id, page);
+    ASSERT_TRUE(cache.Insert(page_id, page));
+    EXPECT_LE(cache.GetBytesStored(), cache.GetCapacity());
+  }
+  size_t resident = cache.GetNumPages();
+  EXPECT_GT(resident, 1);
+  EXPECT_LT(resident, num_pages);
+  EXPECT_FALSE(cache.Lookup(0, out));
+  for (page_id_t page_id = num_pages - 1; page_id >= num_pages - static_cast<page_id_t>(resident); page_id--) {
+    ASSERT_TRUE(cache.Lookup(page_id, out)) << page_id;
+    FillPage(page_id, page);
+    EXPECT_EQ(0, memcmp(page, out, PAGE_SIZE));
+  }
+  EXPECT_EQ(0, cache.GetNumPages());
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, BufferPoolTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+  buffer_pool_compressed_cache_size = 16 * PAGE_SIZE;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  ASSERT_NE(nullptr, bpm->GetCompressedCache());
+
+  // Scenario: pages pushed out of a small pool come back from the compressed cache with their contents.
+  const page_id_t num_pages = 12;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    FillPage(page_id, page->GetData());
+    bpm->UnpinPage(page_id, true);
+  }
+  EXPECT_GT(bpm->GetMetrics().Get(BufferPoolMetric::COMPRESSED_CACHE_PUTS), 0);
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    char expected[PAGE_SIZE];
+    FillPage(page_id, expected);
+    EXPECT_EQ(0, memcmp(expected, page->GetData(), PAGE_SIZE));
+    bpm->UnpinPage(page_id, false);
+  }
+  EXPECT_GE(bpm->GetMetrics().Get(BufferPoolMetric::COMPRESSED_CACHE_HITS), num_pages - buffer_pool_size);
+
+  // Scenario: a deleted page is dropped from the cache too, so its id cannot resurrect stale bytes.
+  page_id_t page_id = 0;
+  bpm->FetchPage(page_id);
+  bpm->UnpinPage(page_id, false);
+  for (page_id_t i = 1; i <= static_cast<page_id_t>(buffer_pool_size); i++) {
+    bpm->FetchPage(i);
+    bpm->UnpinPage(i, false);
+  }
+  EXPECT_TRUE(bpm->DeletePage(page_id));
+  char out[PAGE_SIZE];
+  EXPECT_FALSE(bpm->GetCompressedCache()->Lookup(page_id, out));
+
+  buffer_pool_compressed_cache_size = 0;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table_test.cpp
+//
+// Identification: test/buffer/concurrent_page_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/concurrent_page_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ConcurrentPageTableTest, SampleTest) {
+  const size_t max_entries = 100;
+  ConcurrentPageTable page_table(max_entries);
+  frame_id_t frame_id;
+
+  // Scenario: insert pages and look them up.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(max_entries); page_id++) {
+    page_table.Insert(page_id, static_cast<frame_id_t>(max_entries) - page_id);
+  }
+  EXPECT_EQ(max_entries, page_table.Size());
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(max_entries); page_id++) {
+    ASSERT_TRUE(page_table.Find(page_id, &frame_id));
+    EXPECT_EQ(static_cast<frame_id_t>(max_entries) - page_id, frame_id);
+  }
+  EXPECT_FALSE(page_table.Find(static_cast<page_id_t>(max_entries), &frame_id));
+
+  // Scenario: erasing pages shifts the rest of their probe runs back, so every remaining page stays reachable.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(max_entries); page_id += 2) {
+    EXPECT_TRUE(page_table.Erase(page_id));
+  }
+  EXPECT_FALSE(page_table.Erase(0));
+  EXPECT_EQ(max_entries / 2, page_table.Size());
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(max_entries); page_id++) {
+    EXPECT_EQ(page_id % 2 == 1, page_table.Find(page_id, &frame_id));
+  }
+
+  // Scenario: ForEach visits every entry once.
+  std::map<page_id_t, frame_id_t> entries;
+  page_table.ForEach([&](page_id_t page_id, frame_id_t frame_id) { entries[page_id] = frame_id; });
+  EXPECT_EQ(max_entries / 2, entries.size());
+  for (const auto &[page_id, frame_id] : entries) {
+    EXPECT_EQ(1, page_id % 2);
+    EXPECT_EQ(static_cast<frame_id_t>(max_entries) - page_id, frame_id);
+  }
+
+  // Scenario: reserving room for more entries keeps the existing ones and accepts the new ones.
+  page_table.Reserve(max_entries * 4);
+  for (page_id_t page_id = static_cast<page_id_t>(max_entries); page_id < static_cast<page_id_t>(max_entries * 4);
+       page_id++) {
+    page_table.Insert(page_id, page_id);
+  }
+  EXPECT_EQ(max_entries * 7 / 2, page_table.Size());
+  for (page_id_t page_id = 1; page_id < static_cast<page_id_t>(max_entries * 4); page_id++) {
+    EXPECT_EQ(page_id % 2 == 1 || page_id >= static_cast<page_id_t>(max_entries), page_table.Find(page_id, &frame_id));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ConcurrentPageTableTest, ConcurrencyTest) {
+  const size_t max_entries = 64;
+  const page_id_t num_pages = 256;
+  const int num_readers = 4;
+  ConcurrentPageTable page_table(max_entries);
+
+  // Scenario: while one writer keeps remapping pages, readers never see a page mapped to a frame it was never given.
+  // Every page p is only ever mapped to frame p % max_entries.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  std::atomic<size_t> hits{0};
+  for (int i = 0; i < num_readers; i++) {
+    readers.emplace_back([&, i] {
+      std::mt19937 rng(i);
+      std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+      while (!done) {
+        page_id_t page_id = dist(rng);
+        frame_id_t frame_id;
+        if (page_table.Find(page_id, &frame_id)) {
+          EXPECT_EQ(page_id % static_cast<page_id_t>(max_entries), frame_id);
+          hits++;
+        }
+      }
+    });
+  }
+
+  std::mt19937 rng(42);
+  std::vector<page_id_t> resident(max_entries, INVALID_PAGE_ID);
+  for (int round = 0; round < 20000; round++) {
+    page_id_t page_id = static_cast<page_id_t>(rng() % num_pages);
+    auto frame_id = static_cast<frame_id_t>(page_id % static_cast<page_id_t>(max_entries));
+    if (resident[frame_id] == page_id) {
+      continue;
+    }
+    if (resident[frame_id] != INVALID_PAGE_ID) {
+      EXPECT_TRUE(page_table.Erase(resident[frame_id]));
+    }
+    page_table.Insert(page_id, frame_id);
+    resident[frame_id] = page_id;
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  // Scenario: once updates are quiescent, every lookup is exact.
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    frame_id_t frame_id;
+    auto expected = static_cast<frame_id_t>(page_id % static_cast<page_id_t>(max_entries));
+    EXPECT_EQ(resident[expected] == page_id, page_table.Find(page_id, &frame_id));
+  }
+}
+
+}  // namespace bustub
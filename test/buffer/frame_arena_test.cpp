@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/frame_arena.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, SampleTest) {
+  const size_t num_frames = 700;
+
+  for (bool use_huge_pages : {true, false}) {
+    FrameArena arena(num_frames, use_huge_pages);
+    if (!use_huge_pages) {
+      EXPECT_EQ(HugePageBacking::NONE, arena.GetBacking());
+    }
+
+    // Scenario: frames are contiguous, PAGE_SIZE-aligned and zeroed.
+    for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(num_frames); frame_id++) {
+      char *frame = arena.GetFrame(frame_id);
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(frame) % PAGE_SIZE);
+      EXPECT_EQ(arena.GetFrame(0) + static_cast<size_t>(frame_id) * PAGE_SIZE, frame);
+      EXPECT_EQ(0, frame[0]);
+      EXPECT_EQ(0, frame[PAGE_SIZE - 1]);
+    }
+
+    // Scenario: the whole arena is writable.
+    arena.GetFrame(0)[0] = 'a';
+    arena.GetFrame(num_frames - 1)[PAGE_SIZE - 1] = 'z';
+    EXPECT_EQ('a', arena.GetFrame(0)[0]);
+    EXPECT_EQ('z', arena.GetFrame(num_frames - 1)[PAGE_SIZE - 1]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, BufferPoolLayoutTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: page descriptors are cache-line aligned, and page data is PAGE_SIZE-aligned and kept apart from them.
+  Page *pages = bpm->GetPages();
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(&pages[i]) % 64);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pages[i].GetData()) % PAGE_SIZE);
+    EXPECT_EQ(pages[0].GetData() + i * PAGE_SIZE, pages[i].GetData());
+  }
+
+  // Scenario: pages still round-trip through the disk.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %zu", i);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  Page *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 0", std::string(page->GetData()));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
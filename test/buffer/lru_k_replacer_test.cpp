@@ -0,0 +1,212 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_replacer(7, 2);
+
+  // Scenario: access and unpin six frames. Frame 1 is accessed twice, every other frame once.
+  for (frame_id_t frame_id = 1; frame_id <= 6; frame_id++) {
+    lru_replacer.RecordAccess(frame_id);
+  }
+  lru_replacer.RecordAccess(1);
+  for (frame_id_t frame_id = 1; frame_id <= 6; frame_id++) {
+    lru_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(6, lru_replacer.Size());
+
+  // Scenario: frames with fewer than k accesses have infinite backward k-distance and go first, oldest first.
+  int value;
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  EXPECT_EQ(4, lru_replacer.Size());
+
+  // Scenario: pinned frames cannot be victimized, and pinning a victimized frame has no effect.
+  lru_replacer.Pin(3);
+  lru_replacer.Pin(4);
+  EXPECT_EQ(3, lru_replacer.Size());
+
+  // Scenario: frame 4 is accessed again while pinned, so it now has k accesses and outlives frames 5 and 6.
+  lru_replacer.RecordAccess(4);
+  lru_replacer.Unpin(4);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(5, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(6, value);
+
+  // Scenario: among frames with k accesses, the one whose k-th most recent access is oldest goes first.
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(4, value);
+  EXPECT_EQ(0, lru_replacer.Size());
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+
+  // Scenario: a removed frame forgets its history.
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.Unpin(1);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.Unpin(2);
+  lru_replacer.Remove(1);
+  EXPECT_EQ(1, lru_replacer.Size());
+  lru_replacer.RecordAccess(1);
+  lru_replacer.Unpin(1);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+
+  // Scenario: the access order lists frames by their last access, most recent first, and leaves out frames without
+  // history.
+  lru_replacer.RecordAccess(3);
+  lru_replacer.RecordAccess(5);
+  lru_replacer.RecordAccess(1);
+  std::vector<frame_id_t> frames;
+  lru_replacer.GetAccessOrder(&frames);
+  EXPECT_EQ((std::vector<frame_id_t>{1, 5, 3}), frames);
+}
+
+TEST(LRUKReplacerTest, PinnedVictimTest) {
+  LRUKReplacer lru_replacer(3, 3);
+
+  // Scenario: frame 1 has the oldest k-th most recent access, so it is the first candidate.
+  lru_replacer.RecordAccess(1);
+  for (int i = 0; i < 3; i++) {
+    lru_replacer.RecordAccess(2);
+  }
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.Unpin(1);
+  lru_replacer.Unpin(2);
+
+  // Scenario: the buffer pool gets frame 1 as a victim but finds it pinned by a hit, so it passes it over without
+  // removing it. The hit accesses the frame once more and unpins it; with its history kept, frame 1 is now hotter than
+  // frame 2.
+  int value;
+  ASSERT_TRUE(lru_replacer.PreferredVictim(&value, [](frame_id_t) { return false; }, 2));
+  EXPECT_EQ(1, value);
+  EXPECT_EQ(1, lru_replacer.Size());
+  lru_replacer.RecordAccess(1);
+  lru_replacer.Unpin(1);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+
+  // Scenario: a victim that the buffer pool claims is removed, and forgets its history.
+  lru_replacer.RecordAccess(2);
+  lru_replacer.Unpin(2);
+  ASSERT_TRUE(lru_replacer.PreferredVictim(&value, [](frame_id_t) { return false; }, 2));
+  EXPECT_EQ(2, value);
+  lru_replacer.Remove(2);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.Unpin(2);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+}
+
+TEST(LRUKReplacerTest, EvictableAccessTest) {
+  LRUKReplacer lru_replacer(4, 2);
+
+  // Scenario: hits record accesses to frames that stay evictable. The victim search takes them into account, and only
+  // the last k accesses of a frame count.
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    lru_replacer.RecordAccess(frame_id);
+    lru_replacer.Unpin(frame_id);
+  }
+  lru_replacer.RecordAccess(0);
+  for (int i = 0; i < 5; i++) {
+    lru_replacer.RecordAccess(1);
+  }
+  lru_replacer.RecordAccess(0);
+  int value;
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+
+  // Scenario: threads record accesses while victims are taken and handed back. Every frame is accounted for.
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    lru_replacer.Unpin(frame_id);
+  }
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < 4; tid++) {
+    threads.emplace_back([&lru_replacer, tid] {
+      for (int i = 0; i < 10000; i++) {
+        lru_replacer.RecordAccess((tid + i) % 4);
+      }
+    });
+  }
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(lru_replacer.PreferredVictim(&value, [](frame_id_t frame_id) { return frame_id % 2 == 0; }, 2));
+    lru_replacer.Unpin(value);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(4, lru_replacer.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t num_hot_pages = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, ReplacerType::LRU_K);
+
+  // Scenario: the hot pages are accessed twice, so LRU-K knows they are re-referenced.
+  for (size_t i = 0; i < num_hot_pages; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a scan over many more pages than the pool holds only ever evicts other scanned pages.
+  for (size_t i = 0; i < buffer_pool_size * 4; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  const int reads_before = disk_manager->GetNumReads();
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_hot_pages); page_id++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(reads_before, disk_manager->GetNumReads());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_compressor_test.cpp
+//
+// Identification: test/common/lz_compressor_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/util/lz_compressor.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** Compresses a buffer, decompresses it again and checks that the bytes survive. Returns the compressed size. */
+static size_t RoundTrip(const std::vector<char> &src) {
+  std::vector<char> compressed(LZCompressor::MaxCompressedSize(src.size()));
+  size_t size = LZCompressor::Compress(src.data(), src.size(), compressed.data(), compressed.size());
+  EXPECT_GT(size, 0);
+  std::vector<char> restored(src.size());
+  size_t restored_size = 0;
+  EXPECT_TRUE(LZCompressor::Decompress(compressed.data(), size, restored.data(), restored.size(), &restored_size));
+  EXPECT_EQ(src.size(), restored_size);
+  EXPECT_EQ(0, memcmp(src.data(), restored.data(), src.size()));
+  return size;
+}
+
+// NOLINTNEXTLINE
+TEST(LZCompressorTest, RoundTripTest) {
+  std::mt19937 rng(15445);
+
+  // Scenario: an all-zero page shrinks to a few bytes.
+  std::vector<char> zeros(PAGE_SIZE, 0);
+  EXPECT_LT(RoundTrip(zeros), 64);
+
+  // Scenario: repetitive text compresses well.
+  std::vector<char> text;
+  while (text.size() < PAGE_SIZE) {
+    std::string row = "row " + std::to_string(text.size() % 97) + ": the quick brown fox jumps over the lazy dog; ";
+    text.insert(text.end(), row.begin(), row.end());
+  }
+  text.resize(PAGE_SIZE);
+  EXPECT_LT(RoundTrip(text), PAGE_SIZE / 4);
+
+  // Scenario: random bytes still round-trip, and so do inputs shorter than a match.
+  std::vector<char> noise(PAGE_SIZE);
+  for (auto &c : noise) {
+    c = static_cast<char>(rng());
+  }
+  RoundTrip(noise);
+  RoundTrip(std::vector<char>{'a', 'b', 'c'});
+
+  // Scenario: a page that is half zeros and half noise lands in between.
+  std::vector<char> mixed(noise);
+  memset(mixed.data(), 0, PAGE_SIZE / 2);
+  size_t mixed_size = RoundTrip(mixed);
+  EXPECT_LT(mixed_size, PAGE_SIZE * 3 / 4);
+}
+
+// NOLINTNEXTLINE
+TEST(LZCompressorTest, BoundsTest) {
+  std::mt19937 rng(15445);
+  std::vector<char> noise(PAGE_SIZE);
+  for (auto &c : noise) {
+    c = static_cast<char>(rng());
+  }
+
+  // Scenario: incompressible input does not fit into a buffer smaller than itself.
+  std::vector<char> compressed(PAGE_SIZE);
+  EXPECT_EQ(0, LZCompressor::Compress(noise.data(), noise.size(), compressed.data(), PAGE_SIZE - 1));
+
+  // Scenario: output that would overflow the destination, or a truncated stream, is rejected.
+  std::vector<char> zeros(PAGE_SIZE, 0);
+  size_t size = LZCompressor::Compress(zeros.data(), zeros.size(), compressed.data(), compressed.size());
+  ASSERT_GT(size, 0);
+  std::vector<char> restored(PAGE_SIZE);
+  size_t restored_size;
+  EXPECT_FALSE(LZCompressor::Decompress(compressed.data(), size, restored.data(), PAGE_SIZE / 2, &restored_size));
+  EXPECT_FALSE(LZCompressor::Decompress(compressed.data(), size - 1, restored.data(), PAGE_SIZE, &restored_size));
+
+  // Scenario: garbage never reads or writes out of bounds; it either fails or decodes within the buffer.
+  for (int i = 0; i < 100; i++) {
+    for (auto &c : compressed) {
+      c = static_cast<char>(rng());
+    }
+    if (LZCompressor::Decompress(compressed.data(), 64, restored.data(), PAGE_SIZE, &restored_size)) {
+      EXPECT_LE(restored_size, PAGE_SIZE);
+    }
+  }
+}
+
+}  // namespace bustub
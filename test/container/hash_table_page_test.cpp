@@ -13,7 +13,7 @@
 #include <thread>  // NOLINT
 #include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/logger.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
@@ -25,11 +25,11 @@ namespace bustub {
 // NOLINTNEXTLINE
 TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
-  auto *bpm = new BufferPoolManager(5, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
   // get a header page from the BufferPoolManager
   page_id_t header_page_id = INVALID_PAGE_ID;
-  auto header_page = reinterpret_cast<HashTableHeaderPage *>(bpm->NewPage(&header_page_id, nullptr)->GetData());
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(bpm->NewPage(&header_page_id)->GetData());
 
   // set some fields
   for (int i = 0; i < 11; i++) {
@@ -54,22 +54,22 @@ TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
 
   // unpin the header page now that we are done
   bpm->UnpinPage(header_page_id, true, nullptr);
+  delete bpm;
   disk_manager->ShutDown();
   remove("test.db");
   delete disk_manager;
-  delete bpm;
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
+TEST(HashTablePageTest, BlockPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
-  auto *bpm = new BufferPoolManager(5, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
   // get a block page from the BufferPoolManager
   page_id_t block_page_id = INVALID_PAGE_ID;
 
-  auto block_page =
-      reinterpret_cast<HashTableBlockPage<int, int, IntComparator> *>(bpm->NewPage(&block_page_id, nullptr)->GetData());
+  Page *page = bpm->NewPage(&block_page_id);
+  auto block_page = reinterpret_cast<HashTableBlockPage<int, int, IntComparator> *>(page->GetData());
 
   // insert a few (key, value) pairs
   for (unsigned i = 0; i < 10; i++) {
@@ -103,12 +103,21 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
     }
   }
 
+  // look up keys without latching the page
+  block_page->Insert(10, 4, 40);
+  std::vector<int> result;
+  EXPECT_TRUE(block_page->GetValues(page, 0, 4, IntComparator(), &result));
+  EXPECT_EQ((std::vector<int>{4, 40}), result);
+  result.clear();
+  EXPECT_TRUE(block_page->GetValues(page, 5, 5, IntComparator(), &result));
+  EXPECT_TRUE(result.empty());
+
   // unpin the header page now that we are done
   bpm->UnpinPage(block_page_id, true, nullptr);
+  delete bpm;
   disk_manager->ShutDown();
   remove("test.db");
   delete disk_manager;
-  delete bpm;
 }
 
 }  // namespace bustub
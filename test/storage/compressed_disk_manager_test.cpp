@@ -0,0 +1,250 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager_test.cpp
+//
+// Identification: test/storage/compressed_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/compressed_disk_manager.h"
+
+namespace bustub {
+
+// Fills a page with rows of a few small integers, or with random bytes that do not compress.
+static void FillPage(page_id_t page_id, bool compressible, char *data) {
+  std::mt19937 rng(page_id);
+  for (size_t offset = 0; offset < PAGE_SIZE; offset += sizeof(int32_t)) {
+    auto value = static_cast<int32_t>(compressible ? (offset / 64) % 8 + page_id : rng());
+    memcpy(data + offset, &value, sizeof(value));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedDiskManagerTest, ReadWriteTest) {
+  const std::string db_name = "test.db";
+  const page_id_t num_pages = 1000;
+  remove("test.db");
+  remove("test.zdb");
+  auto *disk_manager = new CompressedDiskManager(db_name);
+  std::vector<char> data(PAGE_SIZE);
+  std::vector<char> buf(PAGE_SIZE);
+
+  // Scenario: pages read back as written, whether they compress or not. Every tenth page does not.
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    EXPECT_EQ(page_id, disk_manager->AllocatePage());
+    FillPage(page_id, page_id % 10 != 0, data.data());
+    disk_manager->WritePage(page_id, data.data());
+  }
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    FillPage(page_id, page_id % 10 != 0, data.data());
+    disk_manager->ReadPage(page_id, buf.data());
+    ASSERT_EQ(0, memcmp(data.data(), buf.data(), PAGE_SIZE)) << "page " << page_id;
+  }
+  EXPECT_EQ(num_pages, disk_manager->GetNumStoredPages());
+  EXPECT_GT(disk_manager->GetCompressionRatio(), 3.0);
+  EXPECT_LT(disk_manager->GetHeapSize(), num_pages * PAGE_SIZE / 3);
+
+  // Scenario: a page without a slot reads as zeros.
+  memset(buf.data(), 1, PAGE_SIZE);
+  disk_manager->ReadPage(num_pages, buf.data());
+  EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), buf);
+
+  // Scenario: rewriting pages that no synced map points to reuses their slots right away, apart from the few that a
+  // write takes before it frees the old slot. After a Sync, the old slots are only reused once the next Sync has made
+  // the map durable.
+  const size_t heap_size = disk_manager->GetHeapSize();
+  for (int round = 0; round < 3; ++round) {
+    for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+      FillPage(page_id, page_id % 10 != 0, data.data());
+      disk_manager->WritePage(page_id, data.data());
+    }
+  }
+  EXPECT_LE(disk_manager->GetHeapSize(), heap_size + 4 * PAGE_SIZE);
+  disk_manager->Sync();
+  for (int round = 0; round < 3; ++round) {
+    for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+      FillPage(page_id, page_id % 10 != 0, data.data());
+      disk_manager->WritePage(page_id, data.data());
+    }
+    disk_manager->Sync();
+  }
+  EXPECT_LE(disk_manager->GetHeapSize(), 2 * heap_size);
+
+  // Scenario: the map survives a restart, and deallocated pages give up their slots.
+  for (page_id_t page_id = 0; page_id < num_pages; page_id += 2) {
+    disk_manager->DeallocatePage(page_id);
+  }
+  EXPECT_EQ(num_pages / 2, disk_manager->GetNumStoredPages());
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  disk_manager = new CompressedDiskManager(db_name);
+  EXPECT_EQ(num_pages / 2, disk_manager->GetNumStoredPages());
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    disk_manager->ReadPage(page_id, buf.data());
+    if (page_id % 2 == 0) {
+      EXPECT_FALSE(disk_manager->IsPageAllocated(page_id));
+      EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), buf);
+    } else {
+      FillPage(page_id, page_id % 10 != 0, data.data());
+      ASSERT_EQ(0, memcmp(data.data(), buf.data(), PAGE_SIZE)) << "page " << page_id;
+    }
+  }
+  // The gaps between the remaining slots are found again and filled before the heap grows.
+  const size_t reopened_heap_size = disk_manager->GetHeapSize();
+  for (page_id_t page_id = 0; page_id < num_pages; page_id += 2) {
+    EXPECT_EQ(page_id, disk_manager->AllocatePage());
+    FillPage(page_id, true, data.data());
+    disk_manager->WritePage(page_id, data.data());
+  }
+  EXPECT_EQ(reopened_heap_size, disk_manager->GetHeapSize());
+
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove("test.db");
+  remove("test.zdb");
+  remove("test.log");
+}
+
+// Records the order in which the heap file is synced and the map pages are written.
+class RecordingCompressedDiskManager : public CompressedDiskManager {
+ public:
+  explicit RecordingCompressedDiskManager(const std::string &db_file) : CompressedDiskManager(db_file) {}
+
+  std::vector<std::string> events_;
+
+ protected:
+  void SyncHeap() override {
+    events_.emplace_back("sync heap");
+    CompressedDiskManager::SyncHeap();
+  }
+
+  void WriteMapPage(page_id_t map_page_id, const char *map_page) override {
+    events_.emplace_back("write map");
+    CompressedDiskManager::WriteMapPage(map_page_id, map_page);
+  }
+};
+
+// NOLINTNEXTLINE
+TEST(CompressedDiskManagerTest, SyncOrderTest) {
+  const std::string db_name = "test.db";
+  remove("test.db");
+  remove("test.zdb");
+  RecordingCompressedDiskManager disk_manager(db_name);
+  std::vector<char> data(PAGE_SIZE);
+
+  // Scenario: Sync makes the slots durable before it writes the map that points to them, which the kernel may write
+  // back at any time.
+  for (page_id_t page_id = 0; page_id < 3; ++page_id) {
+    FillPage(page_id, true, data.data());
+    disk_manager.WritePage(page_id, data.data());
+  }
+  FillPage(CompressedDiskManager::ENTRIES_PER_MAP_PAGE, true, data.data());
+  disk_manager.WritePage(CompressedDiskManager::ENTRIES_PER_MAP_PAGE, data.data());
+  EXPECT_TRUE(disk_manager.events_.empty());
+  disk_manager.Sync();
+  EXPECT_EQ((std::vector<std::string>{"sync heap", "write map", "write map"}), disk_manager.events_);
+
+  // Scenario: so does ShutDown.
+  disk_manager.events_.clear();
+  disk_manager.WritePage(1, data.data());
+  disk_manager.ShutDown();
+  EXPECT_EQ((std::vector<std::string>{"sync heap", "write map"}), disk_manager.events_);
+
+  remove("test.db");
+  remove("test.zdb");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedDiskManagerTest, ChurnTest) {
+  const std::string db_name = "test.db";
+  const page_id_t num_pages = 500;
+  remove("test.db");
+  remove("test.zdb");
+  CompressedDiskManager disk_manager(db_name);
+  std::vector<char> data(PAGE_SIZE);
+  std::mt19937 rng(42);
+  // Random bytes up to a random length below max_random_bytes and zeros after, so that every write of a page
+  // compresses to another size.
+  auto churn = [&](size_t max_random_bytes) {
+    for (int round = 0; round < 10; ++round) {
+      for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+        const size_t random_bytes = rng() % max_random_bytes;
+        for (size_t i = 0; i < PAGE_SIZE; ++i) {
+          data[i] = static_cast<char>(i < random_bytes ? rng() : 0);
+        }
+        disk_manager.WritePage(page_id, data.data());
+      }
+      disk_manager.Sync();
+    }
+  };
+
+  // Scenario: once the pages grow, the many small slots that their earlier, smaller copies leave behind merge into
+  // slots large enough for them, instead of the heap growing for every write.
+  churn(PAGE_SIZE / 4);
+  churn(PAGE_SIZE);
+  // Every round rewrites every page, so the heap holds the new copies and the copies of the last Sync, plus rounding.
+  EXPECT_LE(disk_manager.GetHeapSize(), 5 * disk_manager.GetStoredBytes() / 2);
+
+  disk_manager.ShutDown();
+  remove("test.db");
+  remove("test.zdb");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedDiskManagerTest, BufferPoolTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  remove("test.db");
+  remove("test.zdb");
+  auto *disk_manager = new CompressedDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: the buffer pool sees uncompressed pages through evictions, prefetches and batched fetches.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 50; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->PrefetchPages({0, 1, 2});
+  std::vector<page_id_t> page_ids = {10, 20, 30};
+  std::vector<Page *> pages(page_ids.size());
+  EXPECT_EQ(page_ids.size(), bpm->FetchPages(page_ids.data(), page_ids.size(), pages.data()));
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(pages[i]->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+  for (page_id_t page_id = 0; page_id < 50; ++page_id) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  bpm->FlushAllPages();
+  EXPECT_GT(disk_manager->GetCompressionRatio(), 4.0);
+
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove("test.db");
+  remove("test.zdb");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_disk_manager_test.cpp
+//
+// Identification: test/storage/memory_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/memory_disk_manager.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(MemoryDiskManagerTest, ReadWriteTest) {
+  MemoryDiskManager disk_manager;
+  char data[PAGE_SIZE] = {0};
+  char buf[PAGE_SIZE] = {0};
+
+  // Scenario: pages read back as written, and pages never written read as zeros.
+  for (page_id_t page_id = 0; page_id < 100; ++page_id) {
+    EXPECT_EQ(page_id, disk_manager.AllocatePage());
+    snprintf(data, PAGE_SIZE, "page %d", page_id);
+    disk_manager.WritePage(page_id, data);
+  }
+  for (page_id_t page_id = 0; page_id < 100; ++page_id) {
+    disk_manager.ReadPage(page_id, buf);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+  }
+  disk_manager.ReadPage(1000, buf);
+  EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), std::vector<char>(buf, buf + PAGE_SIZE));
+  EXPECT_EQ(100, disk_manager.GetNumStoredPages());
+  EXPECT_EQ(100, disk_manager.GetNumWrites());
+  EXPECT_EQ(101, disk_manager.GetNumReads());
+
+  // Scenario: allocation works as with files, deallocated pages are handed out again.
+  disk_manager.DeallocatePage(42);
+  EXPECT_FALSE(disk_manager.IsPageAllocated(42));
+  EXPECT_EQ(42, disk_manager.AllocatePage());
+
+  // Scenario: submitted requests complete before Submit returns.
+  snprintf(data, PAGE_SIZE, "submitted");
+  EXPECT_TRUE(disk_manager.SubmitWrite(7, data).get());
+  EXPECT_TRUE(disk_manager.SubmitRead(7, buf).get());
+  EXPECT_EQ("submitted", std::string(buf));
+  disk_manager.Sync();
+  EXPECT_EQ(1, disk_manager.GetNumSyncs());
+}
+
+// NOLINTNEXTLINE
+TEST(MemoryDiskManagerTest, LogTest) {
+  MemoryDiskManager disk_manager;
+  char log_data[] = "log records";
+  char other_log_data[] = "more";
+  char buf[32];
+
+  // Scenario: log records are appended, and reads past the end of the log fail or are zero-filled.
+  EXPECT_FALSE(disk_manager.ReadLog(buf, sizeof(buf), 0));
+  disk_manager.WriteLog(log_data, sizeof(log_data));
+  disk_manager.WriteLog(other_log_data, sizeof(other_log_data));
+  EXPECT_EQ(sizeof(log_data) + sizeof(other_log_data), disk_manager.GetLogSize());
+  EXPECT_EQ(2, disk_manager.GetNumFlushes());
+  EXPECT_TRUE(disk_manager.ReadLog(buf, sizeof(buf), 0));
+  EXPECT_EQ("log records", std::string(buf));
+  EXPECT_EQ("more", std::string(buf + sizeof(log_data)));
+  EXPECT_EQ(0, buf[sizeof(buf) - 1]);
+  EXPECT_FALSE(disk_manager.ReadLog(buf, sizeof(buf), sizeof(log_data) + sizeof(other_log_data)));
+}
+
+// NOLINTNEXTLINE
+TEST(MemoryDiskManagerTest, BufferPoolTest) {
+  const size_t buffer_pool_size = 10;
+  auto *disk_manager = new MemoryDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: the buffer pool evicts to memory and reads the pages back, one by one and in batches.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 50; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  std::vector<page_id_t> page_ids = {10, 11, 30};
+  std::vector<Page *> pages(page_ids.size());
+  EXPECT_EQ(page_ids.size(), bpm->FetchPages(page_ids.data(), page_ids.size(), pages.data()));
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(pages[i]->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+  for (page_id_t page_id = 0; page_id < 50; ++page_id) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
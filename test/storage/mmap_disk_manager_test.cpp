@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// mmap_disk_manager_test.cpp
+//
+// Identification: test/storage/mmap_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/mmap_disk_manager.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(MmapDiskManagerTest, ReadOnlyTest) {
+  const std::string db_name = "test.db";
+  const page_id_t num_pages = 10;
+  remove("test.db");
+  remove("test.log");
+  {
+    DiskManager disk_manager(db_name);
+    std::vector<char> data(PAGE_SIZE);
+    for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+      EXPECT_EQ(page_id, disk_manager.AllocatePage());
+      snprintf(data.data(), PAGE_SIZE, "page %d", page_id);
+      disk_manager.WritePage(page_id, data.data());
+    }
+    disk_manager.ShutDown();
+  }
+
+  auto *disk_manager = new MmapDiskManager(db_name, MmapAdvice::SEQUENTIAL);
+  EXPECT_TRUE(disk_manager->IsReadOnly());
+  EXPECT_LT(0, disk_manager->GetMappedSize());
+  EXPECT_TRUE(disk_manager->IsPageAllocated(num_pages - 1));
+  EXPECT_FALSE(disk_manager->IsPageAllocated(num_pages));
+
+  // Scenario: pages read one by one, in a batch and in place in the mapping.
+  std::vector<char> buf(PAGE_SIZE);
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    disk_manager->ReadPage(page_id, buf.data());
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(buf.data()));
+    ASSERT_NE(nullptr, disk_manager->GetMappedPage(page_id));
+    EXPECT_EQ(0, memcmp(buf.data(), disk_manager->GetMappedPage(page_id), PAGE_SIZE));
+  }
+  std::vector<page_id_t> page_ids = {7, 2, 5};
+  std::vector<char> pages(page_ids.size() * PAGE_SIZE);
+  std::vector<char *> pages_data = {&pages[0], &pages[PAGE_SIZE], &pages[2 * PAGE_SIZE]};
+  disk_manager->ReadPages(page_ids.data(), pages_data.data(), page_ids.size());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(pages_data[i]));
+  }
+  EXPECT_EQ(num_pages + static_cast<int>(page_ids.size()), disk_manager->GetNumReads());
+
+  // Scenario: a page past the end of the file is not mapped and reads as zeros.
+  EXPECT_EQ(nullptr, disk_manager->GetMappedPage(num_pages));
+  memset(buf.data(), 1, PAGE_SIZE);
+  disk_manager->ReadPage(num_pages, buf.data());
+  EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), buf);
+
+  // Scenario: submitted reads complete with the page, writes fail and leave the file as it was.
+  disk_manager->Advise(0, num_pages, MmapAdvice::WILLNEED);
+  EXPECT_TRUE(disk_manager->SubmitRead(3, buf.data()).get());
+  EXPECT_EQ("page 3", std::string(buf.data()));
+  EXPECT_FALSE(disk_manager->SubmitWrite(3, pages_data[0]).get());
+  disk_manager->WritePage(4, pages_data[0]);
+  EXPECT_EQ("page 4", std::string(disk_manager->GetMappedPage(4)));
+  EXPECT_EQ(0, disk_manager->GetNumWrites());
+
+  delete disk_manager;
+
+  // Scenario: opening a file that does not exist does not create it.
+  remove("test.db");
+  disk_manager = new MmapDiskManager(db_name);
+  EXPECT_EQ(0, disk_manager->GetMappedSize());
+  EXPECT_EQ(nullptr, disk_manager->GetMappedPage(0));
+  delete disk_manager;
+  EXPECT_EQ(nullptr, fopen("test.db", "r"));
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// striped_disk_manager_test.cpp
+//
+// Identification: test/storage/striped_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <future>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/striped_disk_manager.h"
+
+namespace bustub {
+
+static const std::vector<std::string> DATA_FILES = {"test_0.db", "test_1.db", "test_2.db"};
+
+static void RemoveFiles() {
+  remove("test.db");
+  remove("test.log");
+  for (const auto &file_name : DATA_FILES) {
+    remove(file_name.c_str());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(StripedDiskManagerTest, ReadWriteTest) {
+  const std::string db_name = "test.db";
+  const size_t stripe_pages = 4;
+  const page_id_t num_pages = 120;
+  RemoveFiles();
+  auto *disk_manager = new StripedDiskManager(db_name, DATA_FILES, stripe_pages);
+  EXPECT_EQ(DATA_FILES.size(), disk_manager->GetNumDataFiles());
+  char data[PAGE_SIZE] = {0};
+  char buf[PAGE_SIZE] = {0};
+
+  // Scenario: extents of stripe_pages pages go to the data files in turns.
+  EXPECT_EQ(std::make_pair(size_t{0}, page_id_t{0}), disk_manager->Locate(0));
+  EXPECT_EQ(std::make_pair(size_t{0}, page_id_t{3}), disk_manager->Locate(3));
+  EXPECT_EQ(std::make_pair(size_t{1}, page_id_t{0}), disk_manager->Locate(4));
+  EXPECT_EQ(std::make_pair(size_t{2}, page_id_t{1}), disk_manager->Locate(9));
+  EXPECT_EQ(std::make_pair(size_t{0}, page_id_t{4}), disk_manager->Locate(12));
+  EXPECT_EQ(std::make_pair(size_t{1}, page_id_t{6}), disk_manager->Locate(18));
+
+  // Scenario: pages read back as written, and every data file gets its share of the writes.
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    EXPECT_EQ(page_id, disk_manager->AllocatePage());
+    snprintf(data, PAGE_SIZE, "page %d", page_id);
+    disk_manager->WritePage(page_id, data);
+  }
+  for (size_t index = 0; index < DATA_FILES.size(); ++index) {
+    EXPECT_EQ(num_pages / DATA_FILES.size(), disk_manager->GetDataFile(index)->GetNumWrites());
+  }
+  EXPECT_EQ(num_pages, disk_manager->GetNumWrites());
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    disk_manager->ReadPage(page_id, buf);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+  }
+
+  // Scenario: a batch of reads that spans several data files fills every buffer.
+  std::vector<page_id_t> page_ids = {1, 5, 6, 10, 13, 50, 117};
+  std::vector<std::vector<char>> buffers(page_ids.size(), std::vector<char>(PAGE_SIZE));
+  std::vector<char *> pages_data;
+  for (auto &buffer : buffers) {
+    pages_data.push_back(buffer.data());
+  }
+  disk_manager->ReadPages(page_ids.data(), pages_data.data(), page_ids.size());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(pages_data[i]));
+  }
+
+  // Scenario: submitted requests reach the right data file, whichever it is.
+  snprintf(data, PAGE_SIZE, "rewritten");
+  EXPECT_TRUE(disk_manager->SubmitWrite(17, data).get());
+  std::future<bool> read_17 = disk_manager->SubmitRead(17, buf);
+  EXPECT_TRUE(read_17.get());
+  EXPECT_EQ("rewritten", std::string(buf));
+  EXPECT_TRUE(disk_manager->SubmitRead(16, buf).get());
+  EXPECT_EQ("page 16", std::string(buf));
+
+  // Scenario: the pages and their allocation survive a restart.
+  disk_manager->Sync();
+  disk_manager->ShutDown();
+  delete disk_manager;
+  disk_manager = new StripedDiskManager(db_name, DATA_FILES, stripe_pages);
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    EXPECT_TRUE(disk_manager->IsPageAllocated(page_id));
+    disk_manager->ReadPage(page_id, buf);
+    EXPECT_EQ(page_id == 17 ? std::string("rewritten") : "page " + std::to_string(page_id), std::string(buf));
+  }
+  EXPECT_EQ(num_pages, disk_manager->AllocatePage());
+
+  disk_manager->ShutDown();
+  delete disk_manager;
+  RemoveFiles();
+}
+
+// NOLINTNEXTLINE
+TEST(StripedDiskManagerTest, BufferPoolTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  RemoveFiles();
+  auto *disk_manager = new StripedDiskManager(db_name, DATA_FILES, 2);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: the buffer pool sees one space of pages through evictions, prefetches and batched fetches.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 50; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->PrefetchPages({0, 1, 2, 3, 4, 5});
+  std::vector<page_id_t> page_ids = {10, 11, 12, 20, 30, 31};
+  std::vector<Page *> pages(page_ids.size());
+  EXPECT_EQ(page_ids.size(), bpm->FetchPages(page_ids.data(), page_ids.size(), pages.data()));
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(pages[i]->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+  for (page_id_t page_id = 0; page_id < 50; ++page_id) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  bpm->FlushAllPages();
+  for (size_t index = 0; index < DATA_FILES.size(); ++index) {
+    EXPECT_GT(disk_manager->GetDataFile(index)->GetNumWrites(), 0);
+  }
+
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  RemoveFiles();
+}
+
+}  // namespace bustub
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// throttled_disk_manager_test.cpp
+//
+// Identification: test/storage/throttled_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/memory_disk_manager.h"
+#include "storage/disk/throttled_disk_manager.h"
+
+namespace bustub {
+
+static double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// NOLINTNEXTLINE
+TEST(ThrottledDiskManagerTest, LatencyTest) {
+  ThrottledDiskManager disk_manager(std::make_unique<MemoryDiskManager>());
+  char data[PAGE_SIZE] = {0};
+  char buf[PAGE_SIZE] = {0};
+
+  // Scenario: the default profile does not throttle, and the wrapped disk manager does the I/O and the allocation.
+  for (page_id_t page_id = 0; page_id < 64; ++page_id) {
+    EXPECT_EQ(page_id, disk_manager.AllocatePage());
+    snprintf(data, PAGE_SIZE, "page %d", page_id);
+    disk_manager.WritePage(page_id, data);
+  }
+  EXPECT_TRUE(disk_manager.GetDiskManager()->IsPageAllocated(63));
+  EXPECT_EQ(64, disk_manager.GetDiskManager()->GetNumWrites());
+
+  // Scenario: every read pays the latency, and a batched read pays it once per run of consecutive pages.
+  disk_manager.SetProfile({std::chrono::milliseconds(5)});
+  auto start = std::chrono::steady_clock::now();
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    disk_manager.ReadPage(page_id, buf);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+  }
+  EXPECT_GE(SecondsSince(start), 0.020);
+  std::vector<page_id_t> page_ids = {20, 3, 1, 2, 21};
+  std::vector<std::vector<char>> buffers(page_ids.size(), std::vector<char>(PAGE_SIZE));
+  std::vector<char *> pages_data;
+  for (auto &buffer : buffers) {
+    pages_data.push_back(buffer.data());
+  }
+  start = std::chrono::steady_clock::now();
+  disk_manager.ReadPages(page_ids.data(), pages_data.data(), page_ids.size());
+  double seconds = SecondsSince(start);
+  EXPECT_GE(seconds, 0.010);
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(pages_data[i]));
+  }
+
+  // Scenario: writes pay their own latency, and a Sync pays the sync latency.
+  ThrottleProfile profile;
+  profile.write_latency_ = std::chrono::milliseconds(5);
+  profile.sync_latency_ = std::chrono::milliseconds(10);
+  disk_manager.SetProfile(profile);
+  start = std::chrono::steady_clock::now();
+  disk_manager.ReadPage(0, buf);
+  disk_manager.WritePage(0, data);
+  disk_manager.Sync();
+  EXPECT_GE(SecondsSince(start), 0.015);
+  EXPECT_EQ(1, disk_manager.GetDiskManager()->GetNumSyncs());
+}
+
+// NOLINTNEXTLINE
+TEST(ThrottledDiskManagerTest, QueueDepthTest) {
+  ThrottledDiskManager disk_manager(std::make_unique<MemoryDiskManager>());
+  const size_t num_requests = 16;
+  std::vector<std::vector<char>> buffers(num_requests, std::vector<char>(PAGE_SIZE));
+
+  // Scenario: submitted reads overlap their latencies, up to the queue depth.
+  ThrottleProfile profile;
+  profile.read_latency_ = std::chrono::milliseconds(10);
+  profile.queue_depth_ = 4;
+  disk_manager.SetProfile(profile);
+  std::vector<DiskRequest> requests;
+  for (size_t i = 0; i < num_requests; ++i) {
+    requests.push_back({false, static_cast<page_id_t>(i), buffers[i].data(), nullptr});
+  }
+  auto start = std::chrono::steady_clock::now();
+  disk_manager.SubmitAndWait(&requests);
+  double seconds = SecondsSince(start);
+  EXPECT_GE(seconds, 0.040);
+  EXPECT_LT(seconds, 0.160);
+
+  // Scenario: the bandwidth is shared by concurrent I/Os. 64 KiB at 1 MiB/s take 62.5 ms however they are issued.
+  profile = ThrottleProfile{};
+  profile.bandwidth_ = 1024 * 1024;
+  disk_manager.SetProfile(profile);
+  for (size_t i = 0; i < num_requests; ++i) {
+    requests.push_back({false, static_cast<page_id_t>(i), buffers[i].data(), nullptr});
+  }
+  start = std::chrono::steady_clock::now();
+  disk_manager.SubmitAndWait(&requests);
+  EXPECT_GE(SecondsSince(start), 0.060);
+
+  // Scenario: after ShutDown, submitted requests fail.
+  disk_manager.ShutDown();
+  EXPECT_FALSE(disk_manager.SubmitRead(0, buffers[0].data()).get());
+}
+
+// NOLINTNEXTLINE
+TEST(ThrottledDiskManagerTest, BustubInstanceTest) {
+  // Scenario: a BustubInstance can keep its pages in memory, behind an emulated SSD.
+  ThrottleProfile profile = ThrottleProfile::Ssd();
+  auto *instance = new BustubInstance("test.db", 4, StorageType::MEMORY, &profile);
+  auto *disk_manager = dynamic_cast<ThrottledDiskManager *>(instance->disk_manager_);
+  ASSERT_NE(nullptr, disk_manager);
+  EXPECT_NE(nullptr, dynamic_cast<MemoryDiskManager *>(disk_manager->GetDiskManager()));
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 20; ++i) {
+    Page *page = instance->buffer_pool_manager_->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, instance->buffer_pool_manager_->UnpinPage(page_id_temp, true));
+  }
+  for (page_id_t page_id = 0; page_id < 20; ++page_id) {
+    Page *page = instance->buffer_pool_manager_->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, instance->buffer_pool_manager_->UnpinPage(page_id, false));
+  }
+  EXPECT_GT(disk_manager->GetNumReads(), 0);
+  delete instance;
+  EXPECT_EQ(-1, std::remove("test.db"));
+}
+
+}  // namespace bustub
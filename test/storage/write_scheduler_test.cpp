@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// write_scheduler_test.cpp
+//
+// Identification: test/storage/write_scheduler_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/write_scheduler.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(WriteSchedulerTest, FlushTest) {
+  const std::string db_name = "test.db";
+  remove("test.db");
+  DiskManager disk_manager(db_name);
+  WriteScheduler scheduler(&disk_manager);
+  std::vector<std::vector<char>> buffers(6, std::vector<char>(PAGE_SIZE, 0));
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    snprintf(buffers[i].data(), PAGE_SIZE, "write %zu", i);
+  }
+
+  // Scenario: queued writes reach the disk only on Flush, and the last write of a page wins.
+  scheduler.Add(3, buffers[0].data());
+  scheduler.Add(1, buffers[1].data());
+  scheduler.Add(2, buffers[2].data());
+  scheduler.Add(3, buffers[3].data());
+  scheduler.Add(0, buffers[4].data());
+  EXPECT_EQ(5, scheduler.GetNumPending());
+  EXPECT_EQ(0, disk_manager.GetNumWrites());
+  EXPECT_EQ(4, scheduler.Flush(false));
+  EXPECT_EQ(0, scheduler.GetNumPending());
+  EXPECT_EQ(4, disk_manager.GetNumWrites());
+  EXPECT_EQ(0, disk_manager.GetNumSyncs());
+  char buf[PAGE_SIZE];
+  for (auto [page_id, expected] : {std::pair{0, "write 4"}, {1, "write 1"}, {2, "write 2"}, {3, "write 3"}}) {
+    disk_manager.ReadPage(page_id, buf);
+    EXPECT_EQ(expected, std::string(buf));
+  }
+
+  // Scenario: a synced batch costs a single Sync, and an empty one still syncs.
+  scheduler.Add(10, buffers[5].data());
+  scheduler.Add(11, buffers[5].data());
+  EXPECT_EQ(2, scheduler.Flush(true));
+  EXPECT_EQ(1, disk_manager.GetNumSyncs());
+  EXPECT_EQ(0, scheduler.Flush(true));
+  EXPECT_EQ(2, disk_manager.GetNumSyncs());
+
+  disk_manager.ShutDown();
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(WriteSchedulerTest, FlushAllPagesTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 64;
+  remove("test.db");
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: flushing the pool writes every dirty page with one batch and makes it durable with one Sync.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->FlushAllPages();
+  EXPECT_EQ(buffer_pool_size, disk_manager->GetNumWrites());
+  EXPECT_EQ(1, disk_manager->GetNumSyncs());
+  char buf[PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    disk_manager->ReadPage(page_id, buf);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+  }
+
+  // Scenario: a later flush writes only the pages that were dirtied since; clean pages are not written again.
+  for (page_id_t page_id : {3, 7}) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d again", page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+  const int writes_before = disk_manager->GetNumWrites();
+  bpm->FlushAllPages();
+  EXPECT_EQ(2, disk_manager->GetNumWrites() - writes_before);
+  EXPECT_EQ(2, disk_manager->GetNumSyncs());
+  disk_manager->ReadPage(7, buf);
+  EXPECT_EQ("page 7 again", std::string(buf));
+  bpm->FlushAllPages();
+  EXPECT_EQ(2, disk_manager->GetNumWrites() - writes_before);
+
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -14,13 +14,15 @@
 #include <cstdio>
 #include <iostream>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -39,7 +41,7 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   // create transaction
   auto *transaction = new Transaction(0);
   auto *disk_manager = new DiskManager("test.db");
-  auto *buffer_pool_manager = new BufferPoolManager(50, disk_manager);
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
   auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
   auto *log_manager = new LogManager(disk_manager);
   auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
@@ -71,4 +73,175 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, ReadAheadTest) {
+  Column col{"a", TypeId::INTEGER};
+  Schema schema{std::vector<Column>{col}};
+  const size_t buffer_pool_size = 10;
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, nullptr, nullptr, transaction);
+
+  // Scenario: the table spans several times as many pages as the pool holds.
+  int num_tuples = 0;
+  while (buffer_pool_manager->GetNumForegroundWrites() < buffer_pool_size * 3) {
+    Tuple tuple{std::vector<Value>{ValueFactory::GetIntegerValue(num_tuples)}, &schema};
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    num_tuples++;
+  }
+  buffer_pool_manager->FlushAllPages();
+
+  // Scenario: a scan sees every tuple in order while its read-ahead prefetches the pages in front of it.
+  const uint64_t prefetches_before = buffer_pool_manager->GetNumPrefetches();
+  int expected = 0;
+  for (TableIterator itr = table->Begin(transaction); itr != table->End(); ++itr) {
+    EXPECT_EQ(expected++, itr->GetValue(&schema, 0).GetAs<int32_t>());
+  }
+  EXPECT_EQ(num_tuples, expected);
+  EXPECT_LT(prefetches_before, buffer_pool_manager->GetNumPrefetches());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete table;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, ReadAheadRingTest) {
+  Column col{"a", TypeId::INTEGER};
+  Schema schema{std::vector<Column>{col}};
+  const size_t buffer_pool_size = 20;
+  const size_t num_hot_pages = 5;
+  const size_t ring_size = 4;
+
+  // Scenario: load a table several times as large as the pool, and a few more pages to serve as a working set.
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, nullptr, nullptr, transaction);
+  int num_tuples = 0;
+  while (buffer_pool_manager->GetNumForegroundWrites() < buffer_pool_size * 3) {
+    Tuple tuple{std::vector<Value>{ValueFactory::GetIntegerValue(num_tuples)}, &schema};
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    num_tuples++;
+  }
+  std::vector<page_id_t> hot_page_ids(num_hot_pages);
+  for (page_id_t &page_id : hot_page_ids) {
+    ASSERT_NE(nullptr, buffer_pool_manager->NewPage(&page_id));
+    buffer_pool_manager->UnpinPage(page_id, true);
+  }
+  buffer_pool_manager->FlushAllPages();
+  const page_id_t first_page_id = table->GetFirstPageId();
+  delete table;
+  delete buffer_pool_manager;
+
+  // Scenario: a fresh pool holds only the working set.
+  buffer_pool_manager = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  table = new TableHeap(buffer_pool_manager, nullptr, nullptr, first_page_id);
+  for (page_id_t page_id : hot_page_ids) {
+    ASSERT_NE(nullptr, buffer_pool_manager->FetchPage(page_id));
+    buffer_pool_manager->UnpinPage(page_id, false);
+  }
+
+  // Scenario: a scan through a ring sees every tuple, with read-ahead on, but takes no more than the ring's frames.
+  BufferAccessStrategy strategy(ring_size);
+  int expected = 0;
+  for (TableIterator itr = table->Begin(transaction, &strategy); itr != table->End(); ++itr) {
+    EXPECT_EQ(expected++, itr->GetValue(&schema, 0).GetAs<int32_t>());
+  }
+  EXPECT_EQ(num_tuples, expected);
+  const BufferPoolMetricsSnapshot before = buffer_pool_manager->GetMetrics();
+  const int reads_before = disk_manager->GetNumReads();
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size - num_hot_pages - ring_size; ++i) {
+    ASSERT_NE(nullptr, buffer_pool_manager->NewPage(&page_id_temp));
+  }
+  BufferPoolMetricsSnapshot diff = buffer_pool_manager->GetMetrics().Diff(before);
+  EXPECT_EQ(0, diff.Get(BufferPoolMetric::CLEAN_EVICTIONS) + diff.Get(BufferPoolMetric::DIRTY_EVICTIONS));
+  for (page_id_t page_id : hot_page_ids) {
+    ASSERT_NE(nullptr, buffer_pool_manager->FetchPage(page_id));
+    buffer_pool_manager->UnpinPage(page_id, false);
+  }
+  EXPECT_EQ(reads_before, disk_manager->GetNumReads());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete table;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, OptimisticReadTest) {
+  Column col1{"a", TypeId::BIGINT};
+  Column col2{"b", TypeId::BIGINT};
+  Schema schema{std::vector<Column>{col1, col2}};
+  auto make_tuple = [&](int64_t value) {
+    return Tuple{std::vector<Value>{ValueFactory::GetBigIntValue(value), ValueFactory::GetBigIntValue(value)}, &schema};
+  };
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(10, disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, nullptr, nullptr, transaction);
+  RID rid;
+  ASSERT_TRUE(table->InsertTuple(make_tuple(0), &rid, transaction));
+
+  // Scenario: writers bump the page version by two, and optimistic reads cannot start while the write latch is held.
+  Page *page = buffer_pool_manager->FetchPage(rid.GetPageId());
+  uint64_t version;
+  ASSERT_TRUE(page->TryOptimisticRead(&version));
+  page->WLatch();
+  uint64_t latched_version;
+  EXPECT_FALSE(page->TryOptimisticRead(&latched_version));
+  page->WUnlatch();
+  EXPECT_EQ(version + 2, page->GetVersion());
+  EXPECT_FALSE(page->ValidateOptimisticRead(version));
+  ASSERT_TRUE(page->TryOptimisticRead(&version));
+  EXPECT_TRUE(page->ValidateOptimisticRead(version));
+  buffer_pool_manager->UnpinPage(rid.GetPageId(), false);
+
+  // Scenario: readers never see a tuple half-way through an update.
+  const int64_t num_updates = 20000;
+  std::thread writer([&] {
+    Transaction txn(1);
+    for (int64_t i = 1; i <= num_updates; i++) {
+      table->UpdateTuple(make_tuple(i), rid, &txn);
+    }
+  });
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 2; tid++) {
+    readers.emplace_back([&, tid] {
+      Transaction txn(2 + tid);
+      Tuple tuple;
+      int64_t last = 0;
+      while (last < num_updates) {
+        ASSERT_TRUE(table->GetTuple(rid, &tuple, &txn));
+        int64_t a = tuple.GetValue(&schema, 0).GetAs<int64_t>();
+        ASSERT_EQ(a, tuple.GetValue(&schema, 1).GetAs<int64_t>());
+        ASSERT_LE(last, a);
+        last = a;
+      }
+    });
+  }
+  writer.join();
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete table;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
 }  // namespace bustub